@@ -20,6 +20,7 @@ INCLUDE(CheckIncludeFiles)
 CHECK_INCLUDE_FILES("unistd.h" HAVE_UNISTD_H)
 CHECK_INCLUDE_FILES("langinfo.h" HAVE_LANGINFO_H)
 CHECK_INCLUDE_FILES("dlfcn.h" HAVE_DLFCN_H)
+CHECK_INCLUDE_FILES("sys/inotify.h" HAVE_SYS_INOTIFY_H)
 
 IF(HAVE_MMAP OR WIN32)
 	SET(SUPPORTS_MEMSTREAM 1)
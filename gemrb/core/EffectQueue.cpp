@@ -37,7 +37,9 @@
 #include "Spell.h" //needs for the source flags bitfield
 #include "TableMgr.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <limits>
 #include "GameData.h"
 
 namespace GemRB {
@@ -426,12 +428,86 @@ Effect *EffectQueue::CreateUnsummonEffect(const Effect *fx)
 	return newfx;
 }
 
+EffectQueue::EffectQueue(const EffectQueue& other)
+: effects(other.effects), Owner(other.Owner), indexStale(true)
+{}
+
+EffectQueue::EffectQueue(EffectQueue&& other) noexcept
+: effects(std::move(other.effects)), Owner(other.Owner), byOpcode(std::move(other.byOpcode)), indexStale(other.indexStale)
+{
+	// the list nodes moved along, so the index is still good
+	other.effects.clear();
+	other.byOpcode.clear();
+}
+
+EffectQueue& EffectQueue::operator=(const EffectQueue& other)
+{
+	if (&other != this) {
+		effects = other.effects;
+		Owner = other.Owner;
+		byOpcode.clear();
+		indexStale = true;
+	}
+	return *this;
+}
+
+EffectQueue& EffectQueue::operator=(EffectQueue&& other) noexcept
+{
+	if (&other != this) {
+		effects = std::move(other.effects);
+		Owner = other.Owner;
+		byOpcode = std::move(other.byOpcode);
+		indexStale = other.indexStale;
+		other.effects.clear();
+		other.byOpcode.clear();
+	}
+	return *this;
+}
+
+const EffectQueue::bucket_t& EffectQueue::Bucket(ieDword opcode) const
+{
+	static const bucket_t empty;
+	if (indexStale) {
+		RebuildIndex();
+	}
+	auto it = byOpcode.find(opcode);
+	return it == byOpcode.end() ? empty : it->second;
+}
+
+void EffectQueue::Unindex(const Effect& fx)
+{
+	if (indexStale) return;
+	auto it = byOpcode.find(fx.Opcode);
+	if (it == byOpcode.end()) return;
+	bucket_t& bucket = it->second;
+	auto pos = std::find(bucket.begin(), bucket.end(), &fx);
+	if (pos != bucket.end()) {
+		bucket.erase(pos);
+	}
+}
+
+void EffectQueue::RebuildIndex() const
+{
+	byOpcode.clear();
+	for (const Effect& fx : effects) {
+		byOpcode[fx.Opcode].push_back(const_cast<Effect*>(&fx));
+	}
+	indexStale = false;
+}
+
 void EffectQueue::AddEffect(Effect* fx, bool insert)
 {
 	if (insert) {
 		effects.push_front(std::move(*fx));
+		if (!indexStale) {
+			bucket_t& bucket = byOpcode[effects.front().Opcode];
+			bucket.insert(bucket.begin(), &effects.front());
+		}
 	} else {
 		effects.push_back(std::move(*fx));
+		if (!indexStale) {
+			byOpcode[effects.back().Opcode].push_back(&effects.back());
+		}
 	}
 	delete fx;
 }
@@ -442,6 +518,7 @@ bool EffectQueue::RemoveEffect(const Effect* fx)
 {
 	for (auto f = effects.begin(); f != effects.end(); ++f) {
 		if (*fx == *f) {
+			Unindex(*f);
 			effects.erase(f);
 			return true;
 		}
@@ -470,6 +547,7 @@ void EffectQueue::Cleanup()
 {
 	for (auto f = effects.begin(); f != effects.end(); ) {
 		if (f->TimingMode == FX_DURATION_JUST_EXPIRED) {
+			Unindex(*f);
 			f = effects.erase(f);
 		} else {
 			++f;
@@ -1277,8 +1355,14 @@ int EffectQueue::ApplyEffect(Actor* target, Effect* fx, ieDword first_apply, ieD
 		}
 	}
 
+	ieDword opcode = fx->Opcode;
 	res = ed(Owner, target, fx);
 	fx->FirstApply = 0;
+	// some effects turn into others, eg. kill creature type into death
+	if (fx->Opcode != opcode) {
+		indexStale = true;
+		if (target) target->fxqueue.indexStale = true;
+	}
 
 	switch (res) {
 		case FX_APPLIED:
@@ -1333,7 +1417,7 @@ static inline bool IsLive(ieByte timingmode)
 //will be killed along with it
 void EffectQueue::RemoveAllEffects(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1510,7 +1594,7 @@ void EffectQueue::RemoveAllEffects(EffectRef &effect_reference)
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithResource(ieDword opcode, const ResRef &resource)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) { continue; }
@@ -1529,7 +1613,7 @@ void EffectQueue::RemoveAllEffectsWithResource(EffectRef &effect_reference, cons
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithSource(ieDword opcode, const ResRef &source, int mode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		if (fx.SourceRef != source) continue;
 
@@ -1560,7 +1644,7 @@ void EffectQueue::RemoveAllEffectsWithSource(EffectRef &effectReference, const R
 //(works only if a higher stat means good for the target)
 void EffectQueue::RemoveAllDetrimentalEffects(ieDword opcode, ieDword current)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1594,7 +1678,7 @@ void EffectQueue::RemoveAllDetrimentalEffects(EffectRef &effect_reference, ieDwo
 //opcode need to be removed (see removal of portrait icon)
 void EffectQueue::RemoveAllEffectsWithParam(ieDword opcode, ieDword param2)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1613,7 +1697,7 @@ void EffectQueue::RemoveAllEffectsWithParam(EffectRef &effect_reference, ieDword
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithParamAndResource(ieDword opcode, ieDword param2, const ResRef &resource)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1743,7 +1827,7 @@ bool EffectQueue::RollDispelChance(ieDword casterLevel, ieDword level)
 
 const Effect *EffectQueue::HasOpcode(ieDword opcode) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1763,7 +1847,7 @@ const Effect *EffectQueue::HasEffect(EffectRef &effect_reference) const
 
 Effect *EffectQueue::HasOpcode(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1783,7 +1867,7 @@ Effect *EffectQueue::HasEffect(EffectRef &effect_reference)
 
 const Effect *EffectQueue::HasOpcodeWithParam(ieDword opcode, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1808,7 +1892,7 @@ const Effect *EffectQueue::HasEffectWithParam(EffectRef &effect_reference, ieDwo
 
 const Effect *EffectQueue::HasOpcodeWithParamPair(ieDword opcode, ieDword param1, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1836,7 +1920,7 @@ const Effect *EffectQueue::HasEffectWithParamPair(EffectRef &effect_reference, i
 bool EffectQueue::DecreaseParam1OfEffect(ieDword opcode, ieDword amount)
 {
 	bool found = false;
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		ieDword& amount_left = fx.Parameter1;
@@ -1864,7 +1948,7 @@ bool EffectQueue::DecreaseParam1OfEffect(EffectRef &effect_reference, ieDword am
 //returns the damage amount NOT soaked
 int EffectQueue::DecreaseParam3OfEffect(ieDword opcode, ieDword amount, ieDword param2)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1903,7 +1987,7 @@ static const int ids_stats[9]={IE_FACTION, IE_TEAM, IE_EA, IE_GENERAL, IE_RACE,
 int EffectQueue::BonusAgainstCreature(ieDword opcode, const Actor *actor) const
 {
 	ieDword sum = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Parameter1) {
@@ -1955,7 +2039,7 @@ int EffectQueue::BonusAgainstCreature(EffectRef &effect_reference, const Actor *
 int EffectQueue::BonusForParam2(ieDword opcode, ieDword param2) const
 {
 	int sum = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1977,7 +2061,7 @@ int EffectQueue::MaxParam1(ieDword opcode, bool positive) const
 {
 	int max = 0;
 	ieDwordSigned param1 = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -2000,7 +2084,7 @@ int EffectQueue::MaxParam1(EffectRef &effect_reference, bool positive) const
 
 bool EffectQueue::WeaponImmunity(ieDword opcode, int enchantment, ieDword weapontype) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -2060,7 +2144,7 @@ int EffectQueue::SumDamageReduction(EffectRef &effect_reference, ieDword weaponE
 	int remaining = 0;
 	int count = 0;
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -2081,7 +2165,7 @@ int EffectQueue::SumDamageReduction(EffectRef &effect_reference, ieDword weaponE
 //useful for immunity vs spell, can't use item, etc.
 const Effect *EffectQueue::HasOpcodeWithResource(ieDword opcode, const ResRef &resource) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) continue;
@@ -2106,7 +2190,7 @@ const Effect *EffectQueue::HasEffectWithPower(EffectRef &effect_reference, ieDwo
 
 const Effect *EffectQueue::HasOpcodeWithPower(ieDword opcode, ieDword power) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		// NOTE: matching greater or equals!
@@ -2134,7 +2218,7 @@ const Effect *EffectQueue::HasSource(const ResRef &removed) const
 //used in contingency/sequencer code (cannot have the same contingency twice)
 const Effect *EffectQueue::HasOpcodeWithSource(ieDword opcode, const ResRef &removed) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (removed != fx.SourceRef) {
@@ -2162,6 +2246,46 @@ bool EffectQueue::HasAnyDispellableEffect() const
 	return false;
 }
 
+ieDword EffectQueue::StableUntil() const
+{
+	const auto& Opcodes = Globals::Get().Opcodes;
+	ieDword until = std::numeric_limits<ieDword>::max();
+	for (const Effect& fx : effects) {
+		// not applied yet or pending cleanup
+		if (fx.FirstApply || fx.TimingMode == FX_DURATION_JUST_EXPIRED) {
+			return 0;
+		}
+		if (fx.Opcode >= Globals::MAX_EFFECTS || !(Opcodes[fx.Opcode].Flags & EFFECT_STATIC)) {
+			return 0;
+		}
+		// delayed effects trigger and limited ones expire at their duration
+		TimingType type = DelayType(fx.TimingMode & 0xff);
+		if (type == TimingType::Invalid) {
+			return 0;
+		} else if (type != TimingType::Permanent) {
+			until = std::min(until, fx.Duration);
+		}
+	}
+	return until;
+}
+
+size_t EffectQueue::Fingerprint() const
+{
+	size_t hash = effects.size();
+	auto mix = [&hash](size_t value) {
+		hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	};
+	for (const Effect& fx : effects) {
+		mix(fx.Opcode);
+		mix(fx.TimingMode);
+		mix(fx.Duration);
+		mix(fx.Parameter1);
+		mix(fx.Parameter2);
+		mix(fx.FirstApply);
+	}
+	return hash;
+}
+
 std::string EffectQueue::dump(bool print) const
 {
 	std::string buffer("EFFECT QUEUE:\n");
@@ -2220,17 +2344,22 @@ Effect *EffectQueue::GetNextEffect(queue_t::iterator &f)
 ieDword EffectQueue::CountEffects(ieDword opcode, ieDword param1, ieDword param2, const ResRef& resource, const ResRef& source) const
 {
 	ieDword cnt = 0;
-
-	for (const auto& fx : effects) {
-		if (opcode != 0xffffffff)
-			MATCH_OPCODE()
-		if( param1!=0xffffffff)
-			MATCH_PARAM1()
-		if( param2!=0xffffffff)
-			MATCH_PARAM2()
-		if (!resource.IsEmpty() && fx.Resource != resource) continue;
-		if (!source.IsEmpty() && fx.SourceRef != source) continue;
+	auto count = [&](const Effect& fx) {
+		if (param1 != 0xffffffff && fx.Parameter1 != param1) return;
+		if (param2 != 0xffffffff && fx.Parameter2 != param2) return;
+		if (!resource.IsEmpty() && fx.Resource != resource) return;
+		if (!source.IsEmpty() && fx.SourceRef != source) return;
 		cnt++;
+	};
+
+	if (opcode == 0xffffffff) {
+		for (const auto& fx : effects) {
+			count(fx);
+		}
+	} else {
+		for (const auto& fx : WithOpcode(opcode)) {
+			if (fx.Opcode == opcode) count(fx);
+		}
 	}
 	return cnt;
 }
@@ -2240,7 +2369,7 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effect_reference, const Effe
 	ieDword cnt = 1;
 	ieDword opcode = ResolveEffect(effect_reference);
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (&fx == fx2) break;
@@ -2251,7 +2380,7 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effect_reference, const Effe
 
 void EffectQueue::ModifyEffectPoint(ieDword opcode, ieDword x, ieDword y)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : WithOpcode(opcode)) {
 		MATCH_OPCODE()
 		fx.Pos = Point(x, y);
 		fx.Parameter3 = 0;
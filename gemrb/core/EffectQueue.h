@@ -37,6 +37,8 @@
 
 #include <cstdlib>
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 namespace GemRB {
 
@@ -165,7 +167,8 @@ enum EffectFlags {
 	EFFECT_NO_ACTOR = 4,
 	EFFECT_REINIT_ON_LOAD = 8,
 	EFFECT_PRESET_TARGET = 16,
-	EFFECT_SPECIAL_UNDO = 32
+	EFFECT_SPECIAL_UNDO = 32,
+	EFFECT_STATIC = 64 // only sets stats from its own parameters, reapplying it changes nothing
 };
 
 // unusual SpellProt types which need hacking (fake stats)
@@ -216,8 +219,36 @@ private:
 	/** Actor which is target of the Effects */
 	Scriptable* Owner = nullptr;
 
+	/** Effects by opcode, each in queue order, so opcode queries skip the rest */
+	using bucket_t = std::vector<Effect*>;
+	mutable std::unordered_map<ieDword, bucket_t> byOpcode;
+	/** set when an applied effect changed its own opcode, the index is rebuilt on the next query */
+	mutable bool indexStale = false;
+
+	template <typename T>
+	class BucketRange {
+		const bucket_t& bucket;
+	public:
+		class iterator {
+			bucket_t::const_iterator it;
+		public:
+			explicit iterator(bucket_t::const_iterator it) : it(it) {}
+			T& operator*() const { return **it; }
+			iterator& operator++() { ++it; return *this; }
+			bool operator!=(const iterator& other) const { return it != other.it; }
+		};
+
+		explicit BucketRange(const bucket_t& bucket) : bucket(bucket) {}
+		iterator begin() const { return iterator(bucket.begin()); }
+		iterator end() const { return iterator(bucket.end()); }
+	};
+
 public:
 	EffectQueue() noexcept {};
+	EffectQueue(const EffectQueue& other);
+	EffectQueue(EffectQueue&& other) noexcept;
+	EffectQueue& operator=(const EffectQueue& other);
+	EffectQueue& operator=(EffectQueue&& other) noexcept;
 	
 	explicit operator bool() const {
 		return !effects.empty();
@@ -316,6 +347,10 @@ public:
 	int BonusForParam2(EffectRef &effect_reference, ieDword param2) const;
 	int MaxParam1(EffectRef &effect_reference, bool positive) const;
 	bool HasAnyDispellableEffect() const;
+	/* game time until which reapplying the queue gives the same stats, 0 if it can't be told */
+	ieDword StableUntil() const;
+	/* cheap summary of the queue contents, changes whenever an effect is added, removed or altered */
+	size_t Fingerprint() const;
 	//getting summarised effects
 	int BonusAgainstCreature(EffectRef &effect_reference, const Actor *actor) const;
 	//getting weapon immunity flag
@@ -340,6 +375,9 @@ public:
 	static bool OverrideTarget(const Effect *fx);
 	bool HasHostileEffects() const;
 	static bool CheckIWDTargeting(const Scriptable* Owner, Actor* target, ieDword value, ieDword type, Effect* fx = nullptr);
+	/** the effects with this opcode, in queue order; don't add or remove effects while iterating */
+	BucketRange<Effect> WithOpcode(ieDword opcode) { return BucketRange<Effect>(Bucket(opcode)); }
+	BucketRange<const Effect> WithOpcode(ieDword opcode) const { return BucketRange<const Effect>(Bucket(opcode)); }
 private:
 	/** counts effects of specific opcode, parameters and resource */
 	ieDword CountEffects(ieDword opcode, ieDword param1, ieDword param2, const ResRef& = ResRef(), const ResRef& = ResRef()) const;
@@ -363,6 +401,10 @@ private:
 	int BonusAgainstCreature(ieDword opcode, const Actor *actor) const;
 	bool WeaponImmunity(ieDword opcode, int enchantment, ieDword weapontype) const;
 	void RemoveBonusMemorizations(const Effect& fx);
+
+	const bucket_t& Bucket(ieDword opcode) const;
+	void Unindex(const Effect& fx);
+	void RebuildIndex() const;
 };
 
 }
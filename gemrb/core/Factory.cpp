@@ -20,11 +20,28 @@
 
 #include "Factory.h"
 
+#include <algorithm>
+
 namespace GemRB {
 
-void Factory::AddFactoryObject(object_t fobject)
+Factory::Factory(size_t softLimit) noexcept
+: softLimit(softLimit), nextSweep(softLimit)
+{}
+
+void Factory::AddFactoryObject(object_t fobject, bool pin)
 {
+	if (fobjects.size() >= nextSweep) {
+		// leave some headroom, so we don't sweep on every addition
+		Evict(softLimit - softLimit / 4);
+		nextSweep = std::max(softLimit, fobjects.size() + softLimit / 4);
+	}
+
+	Key key { fobject->resRef, fobject->SuperClassID };
+	// the first one wins, like with the old linear lookup
+	index.emplace(key, fobjects.size());
 	fobjects.push_back(std::move(fobject));
+	lastUse.push_back(++useClock);
+	pinned.push_back(pin);
 }
 
 int Factory::IsLoaded(const ResRef& resref, SClass_ID type) const
@@ -33,14 +50,12 @@ int Factory::IsLoaded(const ResRef& resref, SClass_ID type) const
 		return -1;
 	}
 
-	for (unsigned int i = 0; i < fobjects.size(); i++) {
-		if (fobjects[i]->SuperClassID == type) {
-			if (fobjects[i]->resRef == resref) {
-				return i;
-			}
-		}
+	auto it = index.find(Key { resref, type });
+	if (it == index.end()) {
+		return -1;
 	}
-	return -1;
+	lastUse[it->second] = ++useClock;
+	return static_cast<int>(it->second);
 }
 
 Factory::object_t Factory::GetFactoryObject(int pos) const
@@ -48,4 +63,50 @@ Factory::object_t Factory::GetFactoryObject(int pos) const
 	return fobjects[pos];
 }
 
+size_t Factory::Evict(size_t keep)
+{
+	if (fobjects.size() <= keep) {
+		return 0;
+	}
+
+	std::vector<size_t> candidates;
+	for (size_t i = 0; i < fobjects.size(); ++i) {
+		// only we still hold it and it can be loaded again
+		if (!pinned[i] && fobjects[i].use_count() == 1) {
+			candidates.push_back(i);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+		return lastUse[a] < lastUse[b];
+	});
+
+	size_t excess = fobjects.size() - keep;
+	size_t evicted = std::min(excess, candidates.size());
+	for (size_t i = 0; i < evicted; ++i) {
+		fobjects[candidates[i]] = nullptr;
+	}
+
+	size_t out = 0;
+	for (size_t i = 0; i < fobjects.size(); ++i) {
+		if (!fobjects[i]) continue;
+		fobjects[out] = std::move(fobjects[i]);
+		lastUse[out] = lastUse[i];
+		pinned[out] = pinned[i];
+		++out;
+	}
+	fobjects.resize(out);
+	lastUse.resize(out);
+	pinned.resize(out);
+	RebuildIndex();
+	return evicted;
+}
+
+void Factory::RebuildIndex()
+{
+	index.clear();
+	for (size_t i = 0; i < fobjects.size(); ++i) {
+		index.emplace(Key { fobjects[i]->resRef, fobjects[i]->SuperClassID }, i);
+	}
+}
+
 }
@@ -28,22 +28,56 @@
 #include "FactoryObject.h"
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace GemRB {
 
+/**
+ * Cache of the shared animation and image factories, indexed by resref and type.
+ * Objects nobody else holds on to anymore are evicted, least recently used
+ * first, once the cache grows past its soft limit. Pinned objects, which were
+ * built in memory and can't be reloaded, are never evicted.
+ */
 class GEM_EXPORT Factory {
 public:
 	using object_t = std::shared_ptr<FactoryObject>;
 
 	Factory() noexcept = default;
+	explicit Factory(size_t softLimit) noexcept;
 	Factory(const Factory&) = delete;
 	Factory& operator=(const Factory&) = delete;
 
-	void AddFactoryObject(object_t fobject);
+	void AddFactoryObject(object_t fobject, bool pinned = false);
 	int IsLoaded(const ResRef& resRef, SClass_ID type) const;
 	object_t GetFactoryObject(int pos) const;
+	/** drops unreferenced unpinned objects until at most keep remain, returns how many went */
+	size_t Evict(size_t keep);
+	size_t Size() const { return fobjects.size(); }
+
 private:
+	struct Key {
+		ResRef resRef;
+		SClass_ID type;
+
+		bool operator==(const Key& other) const { return type == other.type && resRef == other.resRef; }
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const { return CstrHashCI()(key.resRef) ^ (size_t(key.type) << 1); }
+	};
+
 	std::vector<object_t> fobjects;
+	// parallel to fobjects, the use clock at the last lookup
+	mutable std::vector<uint64_t> lastUse;
+	// parallel to fobjects too
+	std::vector<bool> pinned;
+	mutable uint64_t useClock = 0;
+	std::unordered_map<Key, size_t, KeyHash> index;
+	size_t softLimit = 1024;
+	size_t nextSweep = 1024;
+
+	void RebuildIndex();
 };
 
 }
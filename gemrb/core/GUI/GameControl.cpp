@@ -1436,6 +1436,9 @@ void GameControl::DebugPaint(const Point& p, bool sample) const noexcept
 			DebugPropVal = map->tileProps.QueryTileProp(tile, prop);
 		} else {
 			map->tileProps.SetTileProp(tile, prop, DebugPropVal);
+			if (prop == TileProps::Property::SEARCH_MAP) {
+				map->InvalidateVision();
+			}
 		}
 	}
 }
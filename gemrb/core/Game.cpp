@@ -866,6 +866,9 @@ int Game::LoadMap(const ResRef &resRef, bool loadscreen)
 
 	PlacePersistents(newMap, resRef);
 	newMap->InitActors();
+	if (core->config.HierarchicalPathfinding) {
+		newMap->BuildPathClusters();
+	}
 
 	//this feature exists in all blackisle games but not in bioware games
 	// make sure to do it after other actors, so UpdateFog can run and
@@ -1366,6 +1369,7 @@ void Game::IncrementChapter() {
 	} else if (!core->HasFeature(GFFlags::NO_NEW_VARIABLES)) {
 		locals["CHAPTER"] = 0;
 	}
+	StateChanged();
 
 	//clear statistics
 	for (const auto& pc : PCs) {
@@ -1404,6 +1408,7 @@ void Game::AddGold(int add)
 	}
 	ieDword old = PartyGold;
 	PartyGold = std::max(0, signed(PartyGold) + add);
+	StateChanged();
 	if (old<PartyGold) {
 		displaymsg->DisplayConstantStringValue(HCStrings::GotGold, GUIColors::GOLD, PartyGold - old);
 	} else {
@@ -1569,12 +1574,15 @@ static bool ShouldChangeSong(bool combatChange)
 // runs all area scripts
 void Game::UpdateScripts()
 {
+	TriggerMemo::Scope triggerMemo;
 	Update();
 
 	PartyAttack = false;
 
 	for (size_t idx = 0; idx < Maps.size(); idx++) {
+		Maps[idx]->CollectPathRequests();
 		Maps[idx]->UpdateScripts();
+		Maps[idx]->DispatchPathRequests();
 	}
 
 	bool combatEnded = false;
@@ -1700,6 +1708,7 @@ void Game::TextDream()
 		}
 
 		locals["DREAM"] = dream + 1;
+		StateChanged();
 		core->SetEventFlag(EF_TEXTSCREEN);
 	}
 }
@@ -308,6 +308,7 @@ private:
 	void LoadCRTable();
 	Actor* timestopper = nullptr;
 	ieDword timestopEnd = 0;
+	unsigned int stateVersion = 0;
 
 public:
 	/** Returns the PC's slot count for partyID */
@@ -458,6 +459,9 @@ public:
 	size_t GetLoadedMapCount() const { return Maps.size(); }
 	/** Adds or removes gold */
 	void AddGold(int add);
+	/** Notes a change to globals, party gold or inventories, which cached trigger results depend on */
+	void StateChanged() { ++stateVersion; }
+	unsigned int GetStateVersion() const { return stateVersion; }
 	/** Adds ticks to game time */
 	void AdvanceTime(ieDword add, bool fatigue=true);
 	/** Runs the script engine on the global script and the area scripts
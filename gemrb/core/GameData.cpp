@@ -117,8 +117,9 @@ int GameData::LoadCreature(const ResRef& creature, unsigned int PartySlot, bool
 /** Loads a 2DA Table, returns -1 on error or the Table Index on success */
 AutoTable GameData::LoadTable(const ResRef& tableRef, bool silent)
 {
-	if (tables.count(tableRef)) {
-		return tables.at(tableRef);
+	auto cached = tables.find(tableRef);
+	if (cached != tables.end()) {
+		return cached->second;
 	}
 
 	PluginHolder<TableMgr> tm = MakePluginHolder<TableMgr>(IE_2DA_CLASS_ID);
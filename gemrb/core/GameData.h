@@ -147,7 +147,8 @@ public:
 	{
 		static_assert(std::is_base_of<FactoryObject, T>::value, "T must be a FactoryObject.");
 		auto obj = std::make_shared<T>(std::forward<ARGS>(args)...);
-		factory.AddFactoryObject(obj);
+		// built in memory, so there is nothing to reload it from
+		factory.AddFactoryObject(obj, true);
 		return obj;
 	}
 
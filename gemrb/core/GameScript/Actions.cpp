@@ -1211,7 +1211,7 @@ void GameScript::MoveToPointNoRecticle(Scriptable* Sender, Action* parameters)
 	if (!actor->InMove() || actor->Destination != parameters->pointParameter) {
 		actor->WalkTo(parameters->pointParameter, IF_NORETICLE);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1229,7 +1229,7 @@ void GameScript::MoveToPointNoInterrupt(Scriptable* Sender, Action* parameters)
 		actor->WalkTo(parameters->pointParameter, IF_NOINT);
 	}
 	// should we always force IF_NOINT here?
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->Interrupt();
 		actor->ClearPath();
@@ -1248,7 +1248,7 @@ void GameScript::RunToPointNoRecticle(Scriptable* Sender, Action* parameters)
 		actor->SetOrientation(actor->Pos, parameters->pointParameter, false);
 		actor->WalkTo(parameters->pointParameter, IF_NORETICLE | IF_RUNNING);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1266,7 +1266,7 @@ void GameScript::RunToPoint(Scriptable* Sender, Action* parameters)
 		actor->SetOrientation(actor->Pos, parameters->pointParameter, false);
 		actor->WalkTo(parameters->pointParameter, IF_RUNNING);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1291,7 +1291,7 @@ void GameScript::TimedMoveToPoint(Scriptable* Sender, Action* parameters)
 	}
 
 	//hopefully this hack will prevent lockups
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1329,7 +1329,7 @@ void GameScript::MoveToPoint(Scriptable* Sender, Action* parameters)
 	}
 
 	// give up if we can't move there (no path was found)
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1375,7 +1375,7 @@ void GameScript::ReturnToSavedLocation(Scriptable* Sender, Action* parameters)
 	if (!actor->InMove() || actor->Destination != p) {
 		actor->WalkTo(p, 0);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1406,7 +1406,7 @@ void GameScript::RunToSavedLocation(Scriptable* Sender, Action* parameters)
 	if (!actor->InMove() || actor->Destination != p) {
 		actor->WalkTo(p, IF_RUNNING);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1436,7 +1436,7 @@ void GameScript::ReturnToSavedLocationDelete(Scriptable* Sender, Action* paramet
 		actor->WalkTo(p, 0);
 	}
 	//what else?
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1462,7 +1462,7 @@ void GameScript::ReturnToStartLocation(Scriptable* Sender, Action* parameters)
 	if (!actor->InMove() || actor->Destination != p) {
 		actor->WalkTo(p, 0, parameters->int0Parameter);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -1568,7 +1568,7 @@ void GameScript::MoveToCenterOfScreen(Scriptable* Sender, Action* /*parameters*/
 	if (!actor->InMove() || actor->Destination != p) {
 		actor->WalkTo(p, IF_NOINT);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->Interrupt();
 		actor->ClearPath();
@@ -1587,7 +1587,7 @@ void GameScript::MoveToOffset(Scriptable* Sender, Action* parameters)
 	if (!actor->InMove() || actor->Destination != p) {
 		actor->WalkTo(p, 0);
 	}
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		// we should probably instead keep retrying until we reach dest
 		actor->ClearPath();
 		Sender->ReleaseCurrentAction();
@@ -6345,6 +6345,7 @@ void GameScript::PickUpItem(Scriptable* Sender, Action* parameters)
 	if (res != -1) { // it is gold and we got the party pool!
 		if (scr->IsPartyMember()) {
 			core->GetGame()->PartyGold += res;
+			core->GetGame()->StateChanged();
 			// if you want message here then use core->GetGame()->AddGold(res);
 		} else {
 			scr->SetBase(IE_GOLD, scr->GetBase(IE_GOLD) + res);
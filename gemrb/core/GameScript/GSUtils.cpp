@@ -1449,7 +1449,7 @@ void MoveToObjectCore(Scriptable *Sender, Action *parameters, ieDword flags, boo
 	}
 
 	//hopefully this hack will prevent lockups
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		if (flags&IF_NOINT) {
 			actor->Interrupt();
 		}
@@ -1650,7 +1650,7 @@ int MoveNearerTo(Scriptable *Sender, const Point &p, int distance, int dont_rele
 		actor->WalkTo(p, flags, distance);
 	}
 
-	if (!actor->InMove()) {
+	if (!actor->InMove() && !actor->HasPendingPath()) {
 		//didn't release
 		if (dont_release) {
 			return dont_release;
@@ -1733,6 +1733,7 @@ Action *ParamCopyNoOverride(const Action *parameters)
 void SetVariable(Scriptable* Sender, const StringParam& VarName, ieDword value, VarContext context)
 {
 	ieVariable key{VarName};
+	TriggerMemo::Invalidate();
 
 	auto SetLocalVariable = [=](ieVarsMap& vars, const ieVariable& key, ieDword value) {
 		auto lookup = vars.find(key);
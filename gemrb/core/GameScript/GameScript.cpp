@@ -53,8 +53,10 @@
 #include "GUI/GameControl.h"
 #include "GameScript/GSUtils.h"
 #include "GameScript/Matching.h"
+#include "GameScript/ScriptProfiler.h"
 
 #include <cstdarg>
+#include <unordered_map>
 
 namespace GemRB {
 
@@ -141,9 +143,9 @@ static const TriggerLink triggernames[] = {
 	{"detected", GameScript::Detected, 0}, //trap or secret door detected
 	{"die", GameScript::Die, 0},
 	{"died", GameScript::Died, 0},
-	{"difficulty", GameScript::Difficulty, 0},
-	{"difficultygt", GameScript::DifficultyGT, 0},
-	{"difficultylt", GameScript::DifficultyLT, 0},
+	{"difficulty", GameScript::Difficulty, TF_WORLD},
+	{"difficultygt", GameScript::DifficultyGT, TF_WORLD},
+	{"difficultylt", GameScript::DifficultyLT, TF_WORLD},
 	{"disarmed", GameScript::Disarmed, 0},
 	{"disarmfailed", GameScript::DisarmFailed, 0},
 	{"e", GameScript::E, 0},
@@ -165,18 +167,18 @@ static const TriggerLink triggernames[] = {
 	{"g", GameScript::G_Trigger, 0},
 	{"gender", GameScript::Gender, 0},
 	{"general", GameScript::General, 0},
-	{"ggt", GameScript::GGT_Trigger, 0},
-	{"glt", GameScript::GLT_Trigger, 0},
-	{"global", GameScript::Global,TF_MERGESTRINGS},
+	{"ggt", GameScript::GGT_Trigger, TF_WORLD},
+	{"glt", GameScript::GLT_Trigger, TF_WORLD},
+	{"global", GameScript::Global,TF_MERGESTRINGS|TF_WORLD},
 	{"globalandglobal", GameScript::GlobalAndGlobal_Trigger,TF_MERGESTRINGS},
 	{"globalband", GameScript::BitCheck,TF_MERGESTRINGS},
 	{"globalbandglobal", GameScript::GlobalBAndGlobal_Trigger,TF_MERGESTRINGS},
 	{"globalbandglobalexact", GameScript::GlobalBAndGlobalExact,TF_MERGESTRINGS},
 	{"globalbitglobal", GameScript::GlobalBitGlobal_Trigger,TF_MERGESTRINGS},
 	{"globalequalsglobal", GameScript::GlobalsEqual,TF_MERGESTRINGS}, //this is the same
-	{"globalgt", GameScript::GlobalGT,TF_MERGESTRINGS},
+	{"globalgt", GameScript::GlobalGT,TF_MERGESTRINGS|TF_WORLD},
 	{"globalgtglobal", GameScript::GlobalGTGlobal,TF_MERGESTRINGS},
-	{"globallt", GameScript::GlobalLT,TF_MERGESTRINGS},
+	{"globallt", GameScript::GlobalLT,TF_MERGESTRINGS|TF_WORLD},
 	{"globalltglobal", GameScript::GlobalLTGlobal,TF_MERGESTRINGS},
 	{"globalorglobal", GameScript::GlobalOrGlobal_Trigger,TF_MERGESTRINGS},
 	{"globalsequal", GameScript::GlobalsEqual, 0},
@@ -382,11 +384,11 @@ static const TriggerLink triggernames[] = {
 	{"partycounteq", GameScript::PartyCountEQ, 0},
 	{"partycountgt", GameScript::PartyCountGT, 0},
 	{"partycountlt", GameScript::PartyCountLT, 0},
-	{"partygold", GameScript::PartyGold, 0},
-	{"partygoldgt", GameScript::PartyGoldGT, 0},
-	{"partygoldlt", GameScript::PartyGoldLT, 0},
-	{"partyhasitem", GameScript::PartyHasItem, 0},
-	{"partyhasitemidentified", GameScript::PartyHasItemIdentified, 0},
+	{"partygold", GameScript::PartyGold, TF_WORLD},
+	{"partygoldgt", GameScript::PartyGoldGT, TF_WORLD},
+	{"partygoldlt", GameScript::PartyGoldLT, TF_WORLD},
+	{"partyhasitem", GameScript::PartyHasItem, TF_WORLD},
+	{"partyhasitemidentified", GameScript::PartyHasItemIdentified, TF_WORLD},
 	{"partyitemcounteq", GameScript::NumItemsParty, 0},
 	{"partyitemcountgt", GameScript::NumItemsPartyGT, 0},
 	{"partyitemcountlt", GameScript::NumItemsPartyLT, 0},
@@ -451,10 +453,10 @@ static const TriggerLink triggernames[] = {
 	{"systemvariable", GameScript::SystemVariable_Trigger, 0}, //gemrb
 	{"targetunreachable", GameScript::TargetUnreachable, 0},
 	{"team", GameScript::Team, 0},
-	{"time", GameScript::Time, 0},
-	{"timegt", GameScript::TimeGT, 0},
-	{"timelt", GameScript::TimeLT, 0},
-	{"timeofday", GameScript::TimeOfDay, 0},
+	{"time", GameScript::Time, TF_WORLD},
+	{"timegt", GameScript::TimeGT, TF_WORLD},
+	{"timelt", GameScript::TimeLT, TF_WORLD},
+	{"timeofday", GameScript::TimeOfDay, TF_WORLD},
 	{"timeractive", GameScript::TimerActive, 0},
 	{"timerexpired", GameScript::TimerExpired, 0},
 	{"timestopcounter", GameScript::TimeStopCounter, 0},
@@ -1820,8 +1822,10 @@ bool GameScript::Update(bool *continuing, bool *done)
 	bool continueExecution = false;
 	if (continuing) continueExecution = *continuing;
 
+	ScriptProfiler::ScriptScope profiled(Name);
 	RandomNumValue = RAND<int>();
 	for (size_t a = 0; a < script->responseBlocks.size(); a++) {
+		ScriptProfiler::Sample blockSample(ScriptProfiler::Kind::Block, static_cast<int>(a));
 		ResponseBlock* rB = script->responseBlocks[a];
 		if (!rB->condition->Evaluate(MySelf)) {
 			continue;
@@ -1969,6 +1973,113 @@ int GameScript::EvaluateString(Scriptable* Sender, const char* String)
 	return 0;
 }
 
+static struct {
+	std::unordered_map<const Trigger*, int> results;
+	ieDword gameTime = 0;
+	unsigned int stateVersion = 0;
+	int depth = 0;
+	TriggerMemo::Stats stats;
+} triggerMemo;
+
+TriggerMemo::Scope::Scope() noexcept
+{
+	if (!triggerMemo.depth++) {
+		triggerMemo.results.clear();
+	}
+}
+
+TriggerMemo::Scope::~Scope()
+{
+	if (!--triggerMemo.depth) {
+		triggerMemo.results.clear();
+	}
+}
+
+bool TriggerMemo::Lookup(const Trigger* trigger, int& result)
+{
+	if (!triggerMemo.depth) return false;
+	const Game* game = core->GetGame();
+	if (!game) return false;
+
+	// globals, gold and items also change outside of actions, eg. through effects or deaths
+	if (game->GameTime != triggerMemo.gameTime || game->GetStateVersion() != triggerMemo.stateVersion) {
+		triggerMemo.results.clear();
+		triggerMemo.gameTime = game->GameTime;
+		triggerMemo.stateVersion = game->GetStateVersion();
+	}
+	auto it = triggerMemo.results.find(trigger);
+	if (it == triggerMemo.results.end()) {
+		triggerMemo.stats.misses++;
+		return false;
+	}
+	triggerMemo.stats.hits++;
+	result = it->second;
+	return true;
+}
+
+void TriggerMemo::Store(const Trigger* trigger, int result)
+{
+	if (!triggerMemo.depth) return;
+	triggerMemo.results[trigger] = result;
+}
+
+void TriggerMemo::Invalidate()
+{
+	triggerMemo.results.clear();
+}
+
+TriggerMemo::Stats TriggerMemo::GetStats()
+{
+	Stats stats = triggerMemo.stats;
+	stats.entries = triggerMemo.results.size();
+	return stats;
+}
+
+static StringView TriggerName(unsigned short triggerID)
+{
+	StringView name = triggersTable->GetValue(triggerID);
+	if (name.empty()) {
+		name = triggersTable->GetValue(triggerID | 0x4000);
+	}
+	return name;
+}
+
+// unhandled triggers are reported once and then always evaluate to false
+static TriggerFunction ResolveTrigger(unsigned short triggerID)
+{
+	if (triggerID >= MAX_TRIGGERS) {
+		Log(ERROR, "GameScript", "Corrupted (too high) trigger code: {}", triggerID);
+		return nullptr;
+	}
+	TriggerFunction func = triggers[triggerID];
+	if (!func) {
+		triggers[triggerID] = GameScript::False;
+		Log(WARNING, "GameScript", "Unhandled trigger code: {:#x} {}",
+			triggerID, TriggerName(triggerID));
+	}
+	return func;
+}
+
+// variable checks are only sender independent in the global scope
+static bool IsWorldTrigger(const Trigger* tR)
+{
+	if (!(triggerflags[tR->triggerID] & TF_WORLD)) return false;
+	if (!(triggerflags[tR->triggerID] & TF_MERGESTRINGS)) return true;
+	return strnicmp(tR->string0Parameter.c_str(), "GLOBAL", 6) == 0;
+}
+
+void Condition::Compile() const
+{
+	compiled.clear();
+	compiled.reserve(triggers.size());
+	for (const Trigger* tR : triggers) {
+		TriggerFunction func = ResolveTrigger(tR->triggerID);
+		// keep the slot, so Or() counting stays the same
+		bool world = func && IsWorldTrigger(tR);
+		compiled.push_back({ func ? func : GameScript::False, tR, func && (tR->flags & TF_NEGATE), world });
+	}
+}
+
 bool Condition::Evaluate(Scriptable *Sender) const
 {
 	int ORcount = 0;
@@ -1978,12 +2089,22 @@ bool Condition::Evaluate(Scriptable *Sender) const
 	if (triggers.empty()) {
 		return true;
 	}
+	if (compiled.size() != triggers.size()) {
+		Compile();
+	}
 
-	for (const Trigger *tR : triggers) {
-		//do not evaluate triggers in an Or() block if one of them
-		//was already True() ... but this sane approach was only used in iwd2!
-		if (!core->HasFeature(GFFlags::EFFICIENT_OR) || !ORcount || !subresult) {
-			result = tR->Evaluate(Sender);
+	//do not evaluate triggers in an Or() block if one of them
+	//was already True() ... but this sane approach was only used in iwd2!
+	bool efficientOr = core->HasFeature(GFFlags::EFFICIENT_OR);
+	for (const CompiledTrigger& tR : compiled) {
+		if (!efficientOr || !ORcount || !subresult) {
+			int ret;
+			if (!tR.world || !TriggerMemo::Lookup(tR.trigger, ret)) {
+				ScriptProfiler::Sample sample(ScriptProfiler::Kind::Trigger, tR.trigger->triggerID);
+				ret = tR.trigger->Evaluate(Sender, tR.function);
+				if (tR.world) TriggerMemo::Store(tR.trigger, ret);
+			}
+			result = tR.negate ? !ret : ret;
 		}
 		if (result > 1) {
 			//we started an Or() block
@@ -2018,24 +2139,12 @@ bool Condition::Evaluate(Scriptable *Sender) const
 /* this may return more than a boolean, in case of Or(x) */
 int Trigger::Evaluate(Scriptable *Sender) const
 {
-	if (triggerID >= MAX_TRIGGERS) {
-		Log(ERROR, "GameScript", "Corrupted (too high) trigger code: {}", triggerID);
-		return 0;
-	}
-	TriggerFunction func = triggers[triggerID];
-	StringView tmpstr = triggersTable->GetValue(triggerID);
-	if (tmpstr.empty()) {
-		tmpstr = triggersTable->GetValue(triggerID|0x4000);
-	}
+	TriggerFunction func = ResolveTrigger(triggerID);
 	if (!func) {
-		triggers[triggerID] = GameScript::False;
-		Log(WARNING, "GameScript", "Unhandled trigger code: {:#x} {}",
-			triggerID, tmpstr );
 		return 0;
 	}
-	ScriptDebugLog(DebugMode::TRIGGERS, "Executing trigger code: {:#x} {} (Sender: {} / {})", triggerID, tmpstr, Sender->GetScriptName(), fmt::WideToChar{Sender->GetName()});
 
-	int ret = func( Sender, this );
+	int ret = Evaluate(Sender, func);
 	if (flags & TF_NEGATE) {
 		return !ret;
 	}
@@ -2044,6 +2153,15 @@ int Trigger::Evaluate(Scriptable *Sender) const
 	return ret;
 }
 
+int Trigger::Evaluate(Scriptable* Sender, TriggerFunction func) const
+{
+	// the name is only needed for the log, so don't fetch it otherwise
+	if (InDebugMode(DebugMode::TRIGGERS)) {
+		ScriptDebugLog(DebugMode::TRIGGERS, "Executing trigger code: {:#x} {} (Sender: {} / {})", triggerID, TriggerName(triggerID), Sender->GetScriptName(), fmt::WideToChar { Sender->GetName() });
+	}
+	return func(Sender, this);
+}
+
 int ResponseSet::Execute(Scriptable* Sender)
 {
 	switch(responses.size()) {
@@ -2186,6 +2304,9 @@ static bool CheckDeadException(const Scriptable* sender, int actionID)
 void GameScript::ExecuteAction(Scriptable* Sender, Action* aC)
 {
 	int actionID = aC->actionID;
+	ScriptProfiler::Sample sample(ScriptProfiler::Kind::Action, actionID);
+	// whatever the action changes, shared trigger results are stale afterwards
+	TriggerMemo::Invalidate();
 
 	// reallow area scripts after us, if they were disabled
 	if (aC->flags & ACF_REALLOW_SCRIPTS) {
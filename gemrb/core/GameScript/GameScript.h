@@ -155,6 +155,9 @@ public:
 	bool isNull() const;
 };
 
+class Trigger;
+using TriggerFunction = int (*)(Scriptable*, const Trigger*);
+
 class GEM_EXPORT Trigger final : protected Canary {
 public:
 	Trigger() noexcept : string0Parameter(), string1Parameter() {};
@@ -166,6 +169,8 @@ public:
 		}
 	}
 	int Evaluate(Scriptable *Sender) const;
+	// the function is already resolved, see Condition::Compile
+	int Evaluate(Scriptable* Sender, TriggerFunction func) const;
 
 	unsigned short triggerID = 0;
 	int int0Parameter = 0;
@@ -196,6 +201,17 @@ public:
 };
 
 class GEM_EXPORT Condition final : protected Canary {
+	// triggers lowered for evaluation: the function is resolved just once
+	struct CompiledTrigger {
+		TriggerFunction function;
+		const Trigger* trigger;
+		bool negate;
+		bool world; // can be shared through TriggerMemo
+	};
+	mutable std::vector<CompiledTrigger> compiled;
+
+	void Compile() const;
+
 public:
 	~Condition() noexcept override
 	{
@@ -375,7 +391,6 @@ public:
 	}
 };
 
-using TriggerFunction = int (*)(Scriptable*, const Trigger*);
 using ActionFunction = void (*)(Scriptable*, Action*);
 using ObjectFunction = Targets* (*)(const Scriptable*, Targets*, int ga_flags);
 using IDSFunction = int (*)(const Actor*, int parameter);
@@ -385,6 +400,7 @@ using IDSFunction = int (*)(const Actor*, int parameter);
 #define TF_SAVED        2 //trigger is in svtriobj.ids
 #define TF_MERGESTRINGS 8 //same value as actions' mergestring
 #define TF_HAS_OBJECT   16 // whether it has an object parameter
+#define TF_WORLD        32 // result only depends on the game state, not on the sender
 
 struct TriggerLink {
 	const char* Name;
@@ -476,6 +492,35 @@ extern void ScriptDebugLog(DebugMode bit, const char* message, ARGS&&... args)
 
 	Log(DEBUG, "GameScript", message, std::forward<ARGS>(args)...);
 }
+/**
+ * Results of triggers that only depend on the game state (TF_WORLD), shared by
+ * all scriptables running the same script while the game runs its scripts.
+ * Any executed action or variable change drops them, as does a new game time
+ * or a change of Game::GetStateVersion.
+ */
+class GEM_EXPORT TriggerMemo {
+public:
+	struct Stats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t entries = 0;
+	};
+
+	// results are only shared while a Scope is alive, so eg. dialogs are unaffected
+	class GEM_EXPORT Scope {
+	public:
+		Scope() noexcept;
+		Scope(const Scope&) = delete;
+		~Scope();
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	static bool Lookup(const Trigger* trigger, int& result);
+	static void Store(const Trigger* trigger, int result);
+	static void Invalidate();
+	static Stats GetStats();
+};
+
 extern int RandomNumValue;
 extern int NextTriggerObjectID;
 
@@ -70,15 +70,10 @@ static inline Targets *DoObjectFiltering(const Scriptable *Sender, Targets *tgts
 		ga_flags &= ~GA_NO_HIDDEN;
 	}
 
-	targetlist::iterator m;
-	const targettype *tt = tgts->GetFirstTarget(m, ST_ACTOR);
-	while (tt) {
-		const Actor *target = static_cast<const Actor*>(tt->actor);
-		if (oC->objectName[0] || target->ValidTarget(GA_NO_DEAD)) {
-			tt = tgts->GetNextTarget(m, ST_ACTOR);
-		} else {
-			tt = tgts->RemoveTargetAt(m);
-		}
+	if (!oC->objectName[0]) {
+		tgts->RemoveIf([](const targettype& t) {
+			return t.actor->Type == ST_ACTOR && !static_cast<const Actor*>(t.actor)->ValidTarget(GA_NO_DEAD);
+		});
 	}
 
 	for (int i = 0; i < MaxObjectNesting; i++) {
@@ -612,18 +607,10 @@ Targets *XthNearestMyGroupOfType(const Scriptable *origin, Targets *parameters,
 	//determining the specifics of origin
 	ieDword type = actor->GetStat(IE_SPECIFIC); //my group
 
-	while ( t ) {
-		if (t->actor->Type!=ST_ACTOR) {
-			t=parameters->RemoveTargetAt(m);
-			continue;
-		}
-		actor = static_cast<const Actor*>(t->actor);
-		if (actor->GetStat(IE_SPECIFIC) != type) {
-			t=parameters->RemoveTargetAt(m);
-			continue;
-		}
-		t = parameters->GetNextTarget(m, ST_ACTOR);
-	}
+	// only actors are filtered, as before; XthNearestOf doesn't look at the rest anyway
+	parameters->RemoveIf([type](const targettype& tt) {
+		return tt.actor->Type == ST_ACTOR && static_cast<const Actor*>(tt.actor)->GetStat(IE_SPECIFIC) != type;
+	});
 	return XthNearestOf(parameters,count, ga_flags);
 }
 
@@ -702,30 +689,17 @@ Targets *XthNearestEnemyOfType(const Scriptable *origin, Targets *parameters, un
 	}
 
 	ieDword gametime = core->GetGame()->GameTime;
-	while ( t ) {
-		if (t->actor->Type!=ST_ACTOR) {
-			t=parameters->RemoveTargetAt(m);
-			continue;
-		}
-		actor = static_cast<const Actor*>(t->actor);
+	// only actors are filtered, as before; XthNearestOf doesn't look at the rest anyway
+	parameters->RemoveIf([gametime, type](const targettype& tt) {
+		if (tt.actor->Type != ST_ACTOR) return false;
+		const Actor* target = static_cast<const Actor*>(tt.actor);
 		// IDS targeting already did object checks (unless we need to override Detect?)
-		if (!actor->Schedule(gametime, true)) {
-			t = parameters->RemoveTargetAt(m);
-			continue;
-		}
+		if (!target->Schedule(gametime, true)) return true;
 		if (type == GroupType::PC) {
-			if (actor->GetStat(IE_EA) <= EA_EVILCUTOFF) {
-				t=parameters->RemoveTargetAt(m);
-				continue;
-			}
-		} else {
-			if (actor->GetStat(IE_EA) >= EA_GOODCUTOFF) {
-				t=parameters->RemoveTargetAt(m);
-				continue;
-			}
+			return target->GetStat(IE_EA) <= EA_EVILCUTOFF;
 		}
-		t = parameters->GetNextTarget(m, ST_ACTOR);
-	}
+		return target->GetStat(IE_EA) >= EA_GOODCUTOFF;
+	});
 	return XthNearestOf(parameters,count, ga_flags);
 }
 
@@ -0,0 +1,154 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "GameScript/ScriptProfiler.h"
+
+#include "GameScript/GSUtils.h"
+
+#include "Logging/Logging.h"
+#include "Streams/FileStream.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace GemRB {
+
+struct ProfileKey {
+	ResRef script;
+	ScriptProfiler::Kind kind;
+	int id;
+
+	bool operator<(const ProfileKey& other) const
+	{
+		return std::tie(kind, id, script) < std::tie(other.kind, other.id, other.script);
+	}
+};
+
+struct ProfileEntry {
+	size_t calls = 0;
+	std::chrono::nanoseconds time {};
+};
+
+static std::map<ProfileKey, ProfileEntry> profile;
+static ResRef currentScript;
+
+static void Record(const ResRef& script, ScriptProfiler::Kind kind, int id, std::chrono::steady_clock::time_point start)
+{
+	ProfileEntry& entry = profile[{ script, kind, id }];
+	entry.calls++;
+	entry.time += std::chrono::steady_clock::now() - start;
+}
+
+ScriptProfiler::Sample::Sample(Kind kind, int id) noexcept
+	: kind(kind), id(id), active(Enabled())
+{
+	if (active) {
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+ScriptProfiler::Sample::~Sample()
+{
+	if (!active) return;
+
+	// queued actions don't belong to the script that queued them
+	Record(kind == Kind::Action ? ResRef() : currentScript, kind, id, start);
+}
+
+ScriptProfiler::ScriptScope::ScriptScope(const ResRef& script) noexcept
+	: previous(currentScript), active(Enabled())
+{
+	currentScript = script;
+	if (active) {
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+ScriptProfiler::ScriptScope::~ScriptScope()
+{
+	if (active) {
+		Record(currentScript, Kind::Script, 0, start);
+	}
+	currentScript = previous;
+}
+
+void ScriptProfiler::Reset()
+{
+	profile.clear();
+}
+
+static std::string EntryName(const ProfileKey& key)
+{
+	switch (key.kind) {
+		case ScriptProfiler::Kind::Script:
+			return fmt::format("script {}", key.script);
+		case ScriptProfiler::Kind::Block:
+			return fmt::format("script {} block {}", key.script, key.id);
+		case ScriptProfiler::Kind::Trigger:
+			return fmt::format("trigger {:#x} {} ({})", key.id, triggersTable->GetValue(key.id), key.script);
+		default:
+			return fmt::format("action {} {}", key.id, actionsTable->GetValue(key.id));
+	}
+}
+
+std::string ScriptProfiler::Report(size_t limit)
+{
+	using Row = std::pair<const ProfileKey*, const ProfileEntry*>;
+	std::vector<Row> rows;
+	rows.reserve(profile.size());
+	for (const auto& item : profile) {
+		rows.emplace_back(&item.first, &item.second);
+	}
+	std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+		return a.second->time > b.second->time;
+	});
+	if (limit && rows.size() > limit) {
+		rows.resize(limit);
+	}
+
+	std::string report = "total ms    calls      avg us  name\n";
+	for (const Row& row : rows) {
+		double total = std::chrono::duration<double, std::milli>(row.second->time).count();
+		report += fmt::format("{:10.3f} {:8} {:11.3f}  {}\n", total, row.second->calls, total * 1000 / row.second->calls, EntryName(*row.first));
+	}
+	return report;
+}
+
+bool ScriptProfiler::Dump(const path_t& path)
+{
+	std::string report = Report();
+	if (path.empty()) {
+		Log(MESSAGE, "ScriptProfiler", "Script profile:\n{}", report);
+		return true;
+	}
+
+	FileStream file;
+	if (!file.Create(path)) {
+		Log(ERROR, "ScriptProfiler", "Cannot write the script profile to {}!", path);
+		return false;
+	}
+	file.Write(report.c_str(), report.size());
+	file.Close();
+	return true;
+}
+
+}
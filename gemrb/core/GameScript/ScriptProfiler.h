@@ -0,0 +1,91 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SCRIPTPROFILER_H
+#define SCRIPTPROFILER_H
+
+#include "exports.h"
+
+#include "Debug.h"
+#include "ie_types.h"
+
+#include "System/VFS.h"
+
+#include <chrono>
+#include <string>
+
+namespace GemRB {
+
+/**
+ * Opt-in (DebugMode::PROFILER) timing of scripts, their response blocks and
+ * the triggers and actions they run. Samples are aggregated per script resref
+ * and block index or trigger/action id, until the report is dumped.
+ * Actions run from the queue are outside any script, so they are only
+ * aggregated by id.
+ */
+class GEM_EXPORT ScriptProfiler {
+public:
+	enum class Kind : uint8_t {
+		Script,
+		Block,
+		Trigger,
+		Action
+	};
+
+	// times its own lifetime, if profiling is on
+	class GEM_EXPORT Sample {
+	public:
+		Sample(Kind kind, int id) noexcept;
+		Sample(const Sample&) = delete;
+		~Sample();
+		Sample& operator=(const Sample&) = delete;
+
+	private:
+		Kind kind;
+		int id;
+		bool active;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	// makes script the owner of the samples taken while it runs
+	class GEM_EXPORT ScriptScope {
+	public:
+		explicit ScriptScope(const ResRef& script) noexcept;
+		ScriptScope(const ScriptScope&) = delete;
+		~ScriptScope();
+		ScriptScope& operator=(const ScriptScope&) = delete;
+
+	private:
+		ResRef previous;
+		bool active;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	static bool Enabled() { return InDebugMode(DebugMode::PROFILER); }
+	static void Reset();
+	/** The limit most expensive entries, one per line */
+	static std::string Report(size_t limit = 0);
+	/** Writes the full report to path, or logs it if path is empty */
+	static bool Dump(const path_t& path);
+};
+
+}
+
+#endif
@@ -25,9 +25,70 @@
 
 namespace GemRB {
 
+// script evaluation is single threaded, the pool is per thread just to stay safe
+static constexpr size_t MAX_SPARE_TARGETS = 32;
+
+struct TargetsPool {
+	std::vector<void*> blocks;
+	std::vector<targetlist> lists;
+
+	~TargetsPool()
+	{
+		for (void* block : blocks) {
+			::operator delete(block);
+		}
+	}
+};
+
+static TargetsPool& GetPool()
+{
+	static thread_local TargetsPool pool;
+	return pool;
+}
+
+Targets::Targets() noexcept
+{
+	TargetsPool& pool = GetPool();
+	if (!pool.lists.empty()) {
+		objects = std::move(pool.lists.back());
+		pool.lists.pop_back();
+	}
+}
+
+Targets::~Targets()
+{
+	TargetsPool& pool = GetPool();
+	if (objects.capacity() && pool.lists.size() < MAX_SPARE_TARGETS) {
+		objects.clear();
+		pool.lists.push_back(std::move(objects));
+	}
+}
+
+void* Targets::operator new(size_t size)
+{
+	TargetsPool& pool = GetPool();
+	if (size != sizeof(Targets) || pool.blocks.empty()) {
+		return ::operator new(size);
+	}
+	void* block = pool.blocks.back();
+	pool.blocks.pop_back();
+	return block;
+}
+
+void Targets::operator delete(void* ptr) noexcept
+{
+	if (!ptr) return;
+	TargetsPool& pool = GetPool();
+	if (pool.blocks.size() < MAX_SPARE_TARGETS) {
+		pool.blocks.push_back(ptr);
+	} else {
+		::operator delete(ptr);
+	}
+}
+
 size_t Targets::Count() const
 {
-	return objects.size();
+	return objects.size() - head;
 }
 
 targettype* Targets::RemoveTargetAt(targetlist::iterator& m)
@@ -41,8 +102,7 @@ targettype* Targets::RemoveTargetAt(targetlist::iterator& m)
 
 const targettype* Targets::GetLastTarget(ScriptableType type)
 {
-	targetlist::const_iterator m = objects.end();
-	while (m-- != objects.begin()) {
+	for (auto m = objects.rbegin(); m != objects.rend() - head; ++m) {
 		if (type == ST_ANY || (*m).actor->Type == type) {
 			return &(*m);
 		}
@@ -52,7 +112,7 @@ const targettype* Targets::GetLastTarget(ScriptableType type)
 
 const targettype* Targets::GetFirstTarget(targetlist::iterator& m, ScriptableType type)
 {
-	m = objects.begin();
+	m = Begin();
 	while (m != objects.end()) {
 		if (type != ST_ANY && (*m).actor->Type != type) {
 			m++;
@@ -78,7 +138,7 @@ const targettype* Targets::GetNextTarget(targetlist::iterator& m, ScriptableType
 
 Scriptable* Targets::GetTarget(unsigned int index, ScriptableType type)
 {
-	targetlist::iterator m = objects.begin();
+	targetlist::iterator m = Begin();
 	while (m != objects.end()) {
 		if (type == ST_ANY || (*m).actor->Type == type) {
 			if (!index) {
@@ -113,27 +173,25 @@ void Targets::AddTarget(Scriptable* target, unsigned int distance, int flags)
 			break;
 	}
 
-	targettype newTarget = { target, distance };
-	for (auto m = objects.begin(); m != objects.end(); ++m) {
-		if ((*m).distance > distance) {
-			objects.insert(m, newTarget);
-			return;
-		}
-	}
-	objects.push_back(newTarget);
+	// after any targets at the same distance, like before
+	auto pos = std::upper_bound(Begin(), objects.end(), distance, [](unsigned int dist, const targettype& t) {
+		return dist < t.distance;
+	});
+	objects.insert(pos, { target, distance });
 }
 
 void Targets::Clear()
 {
 	objects.clear();
+	head = 0;
 }
 
 void Targets::dump() const
 {
 	Log(DEBUG, "GameScript", "Target dump (actors only):");
-	for (const auto& object : objects) {
-		if (object.actor->Type == ST_ACTOR) {
-			Log(DEBUG, "GameScript", "{}", fmt::WideToChar { object.actor->GetName() });
+	for (auto object = objects.cbegin() + head; object != objects.cend(); ++object) {
+		if (object->actor->Type == ST_ACTOR) {
+			Log(DEBUG, "GameScript", "{}", fmt::WideToChar { object->actor->GetName() });
 		}
 	}
 }
@@ -143,13 +201,9 @@ void Targets::FilterObjectRect(const Object* oC)
 	// can't match anything if the second pair of coordinates (or all of them) are unset
 	if (oC->objectRect.w <= 0 || oC->objectRect.h <= 0) return;
 
-	for (auto m = objects.begin(); m != objects.end();) {
-		if (!IsInObjectRect((*m).actor->Pos, oC->objectRect)) {
-			m = objects.erase(m);
-		} else {
-			++m;
-		}
-	}
+	RemoveIf([oC](const targettype& t) {
+		return !IsInObjectRect(t.actor->Pos, oC->objectRect);
+	});
 }
 
 }
@@ -25,6 +25,9 @@
 
 #include "Scriptable/Scriptable.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace GemRB {
 
 class Actor;
@@ -35,16 +38,29 @@ struct targettype {
 	unsigned int distance;
 };
 
-using targetlist = std::list<targettype>;
+// kept sorted by distance; a vector, since the lists are short and rebuilt all the time
+using targetlist = std::vector<targettype>;
 
 class GEM_EXPORT Targets {
 	targetlist objects;
+	size_t head = 0; // entries before it were popped
+
+	targetlist::iterator Begin() { return objects.begin() + head; }
 
 public:
-	Targets() noexcept {};
+	Targets() noexcept;
+	Targets(const Targets&) = delete;
+	~Targets();
+	Targets& operator=(const Targets&) = delete;
+
+	// a Targets is created and dropped for nearly every object reference a
+	// script evaluates, so both the objects and their buffers are recycled
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr) noexcept;
 
 	size_t Count() const;
-	void Pop() { objects.pop_front(); };
+	/** drops the nearest target */
+	void Pop() { if (head < objects.size()) ++head; };
 	targettype* RemoveTargetAt(targetlist::iterator& m);
 	const targettype* GetNextTarget(targetlist::iterator& m, ScriptableType type);
 	const targettype* GetLastTarget(ScriptableType type);
@@ -53,6 +69,12 @@ public:
 	void AddTarget(Scriptable* target, unsigned int distance, int flags);
 	void Clear();
 	void FilterObjectRect(const Object* oC);
+	/** removes all targets matching pred in place, keeping the order */
+	template<typename PRED>
+	void RemoveIf(PRED pred)
+	{
+		objects.erase(std::remove_if(Begin(), objects.end(), pred), objects.end());
+	}
 	void dump() const;
 };
 
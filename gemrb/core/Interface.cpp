@@ -58,6 +58,7 @@
 #include "SpellMgr.h"
 #include "StoreMgr.h"
 #include "SymbolMgr.h"
+#include "ThreadPool.h"
 #include "TileMap.h"
 #include "VEFObject.h"
 #include "Video/Video.h"
@@ -76,6 +77,7 @@
 #include "RNG.h"
 #include "Scriptable/Container.h"
 #include "Streams/FileStream.h"
+#include "Streams/MemoryStream.h"
 #include "System/FileFilters.h"
 
 #include <utility>
@@ -260,13 +262,16 @@ Interface::Interface(CoreSettings&& cfg)
 	Control::ActionRepeatDelay = config.ActionRepeatDelay;
 	GameControl::DebugFlags = config.DebugFlags;
 
+	workerPool = std::make_unique<ThreadPool>();
+	Log(MESSAGE, "Core", "Started {} worker threads.", workerPool->ThreadCount());
+
 	Log(MESSAGE, "Core", "Initializing search path...");
 	if (!IsAvailable(PLUGIN_RESOURCE_DIRECTORY)) {
 		throw CIE("no DirectoryImporter!");
 	}
 
 	path_t path = config.CachePath;
-	if (!gamedata->AddSource(path, "Cache", PLUGIN_RESOURCE_DIRECTORY)) {
+	if (!gamedata->AddSource(path, "Cache", PLUGIN_RESOURCE_INDEXEDDIRECTORY)) {
 		throw CIE("The cache path couldn't be registered, please check!");
 	}
 
@@ -284,16 +289,22 @@ Interface::Interface(CoreSettings&& cfg)
 	path = PathJoin(config.GemRBOverridePath, "override", "shared");
 	gamedata->AddSource(path, "shared GemRB Override", PLUGIN_RESOURCE_CACHEDDIRECTORY);
 
+	// the game sources below are already resolved into the pack, they only
+	// answer for what was added after it was built
+	if (!config.ContentPack.empty()) {
+		gamedata->AddSource(config.ContentPack, "Content pack", PLUGIN_RESOURCE_PACK);
+	}
+
 	path = PathJoin(config.GamePath, config.GameOverridePath);
 	gamedata->AddSource(path, "Override", PLUGIN_RESOURCE_CACHEDDIRECTORY);
 
 	// GAME sounds are intentionally not cached, in IWD there are directory structures,
 	// that are not cacheable, also it is totally pointless (this fixed charsounds in IWD)
 	path = PathJoin(config.GamePath, config.GameSoundsPath);
-	gamedata->AddSource(path, "Sounds", PLUGIN_RESOURCE_DIRECTORY);
+	gamedata->AddSource(path, "Sounds", PLUGIN_RESOURCE_INDEXEDDIRECTORY);
 
 	path = PathJoin(config.GamePath, config.GameMoviesPath);
-	gamedata->AddSource(path, "Movies", PLUGIN_RESOURCE_DIRECTORY);
+	gamedata->AddSource(path, "Movies", PLUGIN_RESOURCE_INDEXEDDIRECTORY);
 
 	path = PathJoin(config.GamePath, config.GameScriptsPath);
 	gamedata->AddSource(path, "Scripts", PLUGIN_RESOURCE_CACHEDDIRECTORY);
@@ -634,6 +645,9 @@ Interface::~Interface() noexcept
 	delete displaymsg;
 	delete TooltipBG;
 
+	// background jobs may still use the resource sources and the cache
+	if (workerPool) workerPool->Stop();
+
 	// delete and nullify this global data as well
 	delete gamedata;
 	gamedata = nullptr;
@@ -1003,6 +1017,8 @@ void Interface::Main()
 			lastGameUpdate = time;
 		}
 
+		sgiterator->FinishPendingSave();
+
 		winmgr->DrawWindows();
 		if (config.DrawFPS) {
 			frame++;
@@ -2377,6 +2393,9 @@ void Interface::LoadGame(Holder<SaveGame> sg, int ver_override)
 
 	// Yes, it uses goto. Other ways seemed too awkward for me.
 
+	// a save still being written could be the one we load
+	sgiterator->FinishPendingSave(true);
+
 	gamedata->SaveAllStores();
 	strings->CloseAux();
 	tokens.clear(); //clearing the token dictionary
@@ -3726,24 +3745,24 @@ static bool IsBlobSaveItem(const path_t& path) {
 	return areExt != path_t::npos && areExt == pathLength - 4;
 }
 
-int Interface::CompressSave(const path_t& folder, bool overrideRunning)
+int Interface::CollectSaveFiles(SaveGameWriter::Job& job, bool overrideRunning)
 {
-	FileStream str;
-
-	str.Create(folder, GameNameResRef.c_str(), IE_SAV_CLASS_ID);
 	DirectoryIterator dir(config.CachePath);
 	if (!dir) {
 		return GEM_ERROR;
 	}
-	PluginHolder<ArchiveImporter> ai = MakePluginHolder<ArchiveImporter>(IE_SAV_CLASS_ID);
-	ai->CreateArchive( &str);
+	job.savName = GameNameResRef.c_str();
+	job.archiver = MakePluginHolder<ArchiveImporter>(IE_SAV_CLASS_ID);
 
-	tick_t startTime = GetMilliseconds();
 	// If we override the savegame we are running to fetch AREs from, it has already dumped
-	// itself as "ares.blb" into the cache folder. Otherwise, just copy directly.
-	if (!overrideRunning && saveGameAREExtractor.copyRetainedAREs(&str) == GEM_ERROR) {
-		Log(ERROR, "Interface", "Failed to copy ARE files into new save game.");
-		return GEM_ERROR;
+	// itself as "ares.blb" into the cache folder. Otherwise, they get copied directly.
+	if (!overrideRunning && saveGameAREExtractor.hasSaveGame()) {
+		job.retainedSource.reset(saveGameAREExtractor.openSave());
+		if (!job.retainedSource) {
+			Log(ERROR, "Interface", "Failed to copy ARE files into new save game.");
+			return GEM_ERROR;
+		}
+		job.retained = std::make_unique<SaveGameAREExtractor>(saveGameAREExtractor);
 	}
 
 	dir.SetFlags(DirectoryIterator::Files);
@@ -3752,22 +3771,29 @@ int Interface::CompressSave(const path_t& folder, bool overrideRunning)
 	while(priority) {
 		do {
 			const path_t& name = dir.GetName();
-			if (SavedExtension(name) == priority) {
-				path_t dtmp = dir.GetFullPath();
-				FileStream fs;
-				if (!fs.Open(dtmp)) {
-					Log(ERROR, "Interface", "Failed to open \"{}\".", dtmp);
-				}
+			if (SavedExtension(name) != priority) continue;
 
-				if (IsBlobSaveItem(dtmp)) {
-					if (overrideRunning) {
-						saveGameAREExtractor.updateSaveGame(str.GetPos());
-						ai->AddToSaveGameCompressed(&str, &fs);
-					}
-				} else {
-					ai->AddToSaveGame(&str, &fs);
-				}
+			path_t dtmp = dir.GetFullPath();
+			bool blob = IsBlobSaveItem(dtmp);
+			if (blob && !overrideRunning) continue;
+
+			// the game goes on and may rewrite the cache, so take a copy
+			FileStream fs;
+			if (!fs.Open(dtmp)) {
+				Log(ERROR, "Interface", "Failed to open \"{}\".", dtmp);
+				continue;
+			}
+			strpos_t size = fs.Size();
+			void* data = malloc(size);
+			if (fs.Read(data, size) == GEM_ERROR) {
+				Log(ERROR, "Interface", "Failed to read \"{}\".", dtmp);
+				free(data);
+				continue;
 			}
+			SaveGameWriter::File file;
+			file.stream = std::make_unique<MemoryStream>(dtmp, data, size);
+			file.compressed = blob;
+			job.files.push_back(std::move(file));
 		} while (++dir);
 		//reopen list for the second round
 		priority--;
@@ -3776,8 +3802,6 @@ int Interface::CompressSave(const path_t& folder, bool overrideRunning)
 		}
 	}
 
-	tick_t endTime = GetMilliseconds();
-	Log(WARNING, "Core", "{} ms (compressing SAV file)", endTime - startTime);
 	return GEM_OK;
 }
 
@@ -40,6 +40,7 @@
 #include "InterfaceConfig.h"
 #include "Orientation.h"
 #include "SaveGameAREExtractor.h"
+#include "SaveGameWriter.h"
 #include "Strings/StringMap.h"
 #include "StringMgr.h"
 #include "TableMgr.h"
@@ -80,6 +81,7 @@ class Sprite2D;
 class Store;
 class SymbolMgr;
 class TextArea;
+class ThreadPool;
 class WindowManager;
 class WorldMap;
 class WorldMapArray;
@@ -295,6 +297,7 @@ private:
 	WindowManager* winmgr = nullptr;
 	PluginHolder<ScriptEngine> guiscript;
 	std::unique_ptr<FogRenderer> fogRenderer;
+	std::unique_ptr<ThreadPool> workerPool;
 	GameControl* gamectrl = nullptr;
 	SaveGameIterator *sgiterator = nullptr;
 	tokens_t tokens;
@@ -423,6 +426,8 @@ public:
 	bool HasFeedback(int type) const;
 	/** Get the SaveGameIterator */
 	SaveGameIterator * GetSaveGameIterator() const;
+	/** Get the pool of background worker threads */
+	ThreadPool* GetWorkerPool() const { return workerPool.get(); }
 	/** Get the Variables Dictionary */
 	variables_t& GetDictionary();
 	/** Get the Token Dictionary */
@@ -592,8 +597,8 @@ public:
 	int WriteGame(const path_t& folder);
 	/** saves the worldmap object to the destination folder */
 	int WriteWorldMap(const path_t& folder);
-	/** saves the .are and .sto files to the destination folder */
-	int CompressSave(const path_t& folder, bool overrideRunning);
+	/** reads the .are and .sto files from the cache, so they can be compressed into the save */
+	int CollectSaveFiles(SaveGameWriter::Job& job, bool overrideRunning);
 	/** toggles the pause. returns either PAUSE_ON or PAUSE_OFF to reflect the script state after toggling. */
 	PauseState TogglePause() const;
 	/** returns true the passed pause setting was applied. false otherwise. */
@@ -162,6 +162,8 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 		}
 	};
 
+	CONFIG_INT("AsyncPathfinding", config.AsyncPathfinding);
+	CONFIG_INT("BackgroundSaving", config.BackgroundSaving);
 	CONFIG_INT("Bpp", config.Bpp);
 	CONFIG_INT("CaseSensitive", config.CaseSensitive);
 	CONFIG_INT("DoubleClickDelay", config.DoubleClickDelay);
@@ -171,15 +173,22 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 	CONFIG_INT("EnableCheatKeys", config.CheatFlag);
 	CONFIG_INT("GCDebug", config.DebugFlags);
 	CONFIG_INT("GUIEnhancements", config.GUIEnhancements);
+	CONFIG_INT("HeadlessFramebuffer", config.HeadlessFramebuffer);
 	CONFIG_INT("Height", config.Height);
+	CONFIG_INT("HierarchicalPathfinding", config.HierarchicalPathfinding);
+	CONFIG_INT("IncrementalStats", config.IncrementalStats);
+	CONFIG_INT("IndexDirectories", config.IndexDirectories);
 	CONFIG_INT("KeepCache", config.KeepCache);
+	CONFIG_INT("MaxOpenBIFs", config.MaxOpenBIFs);
 	CONFIG_INT("MaxPartySize", config.MaxPartySize);
 	config.MaxPartySize = std::min(std::max(1, config.MaxPartySize), 10);
 	CONFIG_INT("MouseFeedback", config.MouseFeedback);
 	CONFIG_INT("MultipleQuickSaves", config.MultipleQuickSaves);
+	CONFIG_INT("PrewarmCache", config.PrewarmCache);
 	CONFIG_INT("UseAsLibrary", config.UseAsLibrary);
 	CONFIG_INT("RepeatKeyDelay", config.ActionRepeatDelay);
 	CONFIG_INT("SaveAsOriginal", config.SaveAsOriginal);
+	CONFIG_INT("SpriteAtlas", config.SpriteAtlas);
 	CONFIG_INT("SpriteFogOfWar", config.SpriteFoW);
 	CONFIG_INT("DebugMode", config.debugMode);
 	CONFIG_INT("TouchInput", config.TouchInput);
@@ -191,6 +200,7 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 	CONFIG_INT("GamepadPointerSpeed", config.GamepadPointerSpeed);
 	CONFIG_INT("Logging", config.Logging);
 	CONFIG_INT("LogColor", config.LogColor);
+	CONFIG_INT("LogLevel", config.MaxLogLevel);
 
 	auto CONFIG_STRING = [&cfg](const std::string& key, auto& field) {
 		if (cfg.Contains(key)) {
@@ -211,6 +221,7 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 
 	// TODO: make CustomFontPath default cross platform
 	CONFIG_PATH("CustomFontPath", config.CustomFontPath);
+	CONFIG_PATH("ContentPack", config.ContentPack);
 	CONFIG_PATH("GameCharactersPath", config.GameCharactersPath);
 	CONFIG_PATH("GameDataPath", config.GameDataPath);
 	CONFIG_PATH("GameOverridePath", config.GameOverridePath);
@@ -295,6 +306,7 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 	CONFIG_STRING("SkipPlugin", config.SkipPlugin);
 	CONFIG_STRING("DelayPlugin", config.DelayPlugin);
 	CONFIG_STRING("Encoding", config.Encoding);
+	CONFIG_STRING("LogChannels", config.LogChannels);
 	CONFIG_STRING("ScaleQuality", config.ScaleQuality);
 
 	auto value = cfg.Get("ModPath", "");
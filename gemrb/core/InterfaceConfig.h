@@ -66,6 +66,7 @@ struct CoreSettings {
 	std::vector<path_t> CD[MAX_CD];
 	std::vector<path_t> ModPath;
 	path_t CustomFontPath = "/usr/share/fonts/TTF";
+	path_t ContentPack; // prebuilt pack of the game resources, see tools/make_content_pack.py
 
 	path_t GemRBPath = GemDataPath();
 	path_t GemRBOverridePath;
@@ -96,14 +97,25 @@ struct CoreSettings {
 	int CapFPS = 0;
 	bool FullScreen = false;
 	bool SpriteFoW = false;
+	bool SpriteAtlas = true; // SDL2: pack small sprites into shared textures
+	bool HeadlessFramebuffer = false; // null video driver: software render, so screenshots work
 	uint32_t debugMode = 0;
+	bool HierarchicalPathfinding = false; // answer long path queries on a cluster graph first
+	bool AsyncPathfinding = false; // search WalkTo paths on worker threads, answered on the next tick
+	int IncrementalStats = 0; // 1 skips stat rebuilds of unchanged actors, 2 also verifies them
 	bool Logging = true;
 	int LogColor = -1; // -1 is to automatically determine
+	int MaxLogLevel = 5; // DEBUG, everything
+	std::string LogChannels; // per owner levels, eg. "GameScript=5,ResourceManager=1"
 	bool CheatFlag = false; /** Cheats enabled? */
 	int MaxPartySize = 6;
 	int GUIEnhancements = 23;
 
 	bool KeepCache = false;
+	bool IndexDirectories = false; // keep the listings of plain directory sources in memory
+	int MaxOpenBIFs = 16; // how many parsed archives KEYImporter keeps open
+	bool PrewarmCache = false; // decompress all compressed archives in the background on startup
+	bool BackgroundSaving = false; // compress and write saves on a worker thread
 	bool MultipleQuickSaves = false;
 	bool UseAsLibrary = false;
 	// once GemRB own format is working well, this might be set to 0
@@ -185,6 +185,11 @@ void Inventory::CalculateWeight()
 	if (Owner) {
 		Owner->SetBase(IE_ENCUMBRANCE, Weight);
 	}
+	// called after every change to the contents, which PartyHasItem depends on
+	Game* game = core->GetGame();
+	if (game) {
+		game->StateChanged();
+	}
 }
 
 void Inventory::AddSlotEffects(ieDword index)
@@ -896,6 +901,11 @@ bool Inventory::ChangeItemFlag(ieDword slot, ieDword arg, BitOp op) const
 		return false;
 	}
 	SetBits(item->Flags, arg, op);
+	// eg. identification, see PartyHasItemIdentified
+	Game* game = core->GetGame();
+	if (game) {
+		game->StateChanged();
+	}
 	return true;
 }
 
@@ -1478,6 +1488,19 @@ bool Inventory::MagicSlotEquipped() const
 	return false;
 }
 
+size_t Inventory::Fingerprint() const
+{
+	size_t hash = std::hash<int>()(Equipped) ^ (size_t(EquippedHeader) << 16);
+	for (const CREItem* item : Slots) {
+		size_t value = std::hash<const CREItem*>()(item);
+		if (item) {
+			value ^= item->Flags;
+		}
+		hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	}
+	return hash;
+}
+
 //returns the fist weapon if there is nothing else
 //This will return the actual weapon, I mean the bow in the case of bow+arrow combination
 CREItem *Inventory::GetUsedWeapon(bool leftorright, int &slot) const
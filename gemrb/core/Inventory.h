@@ -335,6 +335,8 @@ public:
 	int MergeItems(int slot, CREItem *item);
 	bool FistsEquipped() const;
 	bool MagicSlotEquipped() const;
+	/** cheap summary of the slots and the equipped weapon, changes whenever they do */
+	size_t Fingerprint() const;
 	//setting important constants
 	static void Init();
 	static void SetArmorSlot(int arg);
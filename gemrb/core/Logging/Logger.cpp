@@ -20,6 +20,7 @@
 
 #include "Logging/Logging.h"
 
+#include <cstddef>
 #include <cstdio>
 
 namespace GemRB {
@@ -36,12 +37,20 @@ const EnumArray<LogLevel, LOG_FMT> Logger::LevelFormat {
 const LOG_FMT Logger::MSG_STYLE = fmt::fg(fmt::color::ghost_white);
 
 Logger::Logger(std::deque<WriterPtr> writers)
-: writers(std::move(writers))
-{}
+: messageQueue(std::make_unique<Slot[]>(QueueSize)), writers(std::move(writers))
+{
+	for (size_t i = 0; i < QueueSize; ++i) {
+		messageQueue[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
 
 Logger::~Logger()
 {
-	running = false;
+	{
+		// under the lock, so the logging thread can't miss it between its check and going to sleep
+		std::lock_guard<std::mutex> l(queueLock);
+		running = false;
+	}
 	cv.notify_all();
 	if (loggingThread.joinable())
 		loggingThread.join();
@@ -50,13 +59,19 @@ Logger::~Logger()
 void Logger::StartProcessingThread()
 {
 	loggingThread = std::thread([this] {
-		while (running) {
-			QueueType queue;
-			std::unique_lock<std::mutex> lk(queueLock);
-			cv.wait(lk, [this]() { return !messageQueue.empty() || !running; });
-			queue.swap(messageQueue);
-			lk.unlock();
-			ProcessMessages(std::move(queue));
+		bool stopping = false;
+		// the last round empties the queue after a stop, so nothing logged before it gets lost
+		while (!stopping) {
+			{
+				std::unique_lock<std::mutex> lk(queueLock);
+				waiting = true;
+				// pairs with the fence in LogMsg: either we see the new message or its producer sees us waiting
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				cv.wait(lk, [this]() { return HasQueued() || !running; });
+				waiting = false;
+				stopping = !running;
+			}
+			ProcessMessages();
 		}
 	});
 }
@@ -72,14 +87,68 @@ void Logger::AddLogWriter(WriterPtr writer)
 	}
 }
 
-void Logger::ProcessMessages(QueueType queue)
+bool Logger::Push(LogMessage& msg)
+{
+	Slot* slot;
+	size_t pos = enqueuePos.load(std::memory_order_relaxed);
+	while (true) {
+		slot = &messageQueue[pos & (QueueSize - 1)];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+		if (diff == 0) {
+			// the slot is free, claim it
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// the consumer hasn't freed it yet, so we're full
+			return false;
+		} else {
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->message = std::move(msg);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool Logger::Pop(LogMessage& msg)
+{
+	Slot& slot = messageQueue[dequeuePos & (QueueSize - 1)];
+	if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+		return false;
+	}
+
+	msg = std::move(slot.message);
+	slot.sequence.store(dequeuePos + QueueSize, std::memory_order_release);
+	++dequeuePos;
+	return true;
+}
+
+bool Logger::HasQueued() const
+{
+	const Slot& slot = messageQueue[dequeuePos & (QueueSize - 1)];
+	return slot.sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+}
+
+void Logger::ProcessMessages()
 {
 	std::lock_guard<std::mutex> l(writerLock);
-	while (!queue.empty()) {
+	LogMessage msg;
+	while (Pop(msg)) {
 		for (const auto& writer : writers) {
-			writer->WriteLogMessage(queue.front());
+			writer->WriteLogMessage(msg);
+		}
+	}
+
+	// after the queued ones, which made it in before the queue filled up
+	size_t lost = dropped.exchange(0);
+	if (lost) {
+		LogMessage note(WARNING, "Logger", fmt::format("The log queue was full, dropped {} messages.", lost), MSG_STYLE);
+		for (const auto& writer : writers) {
+			writer->WriteLogMessage(note);
 		}
-		queue.pop_front();
 	}
 }
 
@@ -96,10 +165,15 @@ void Logger::LogMsg(LogMessage&& msg)
 		for (const auto& writer : writers) {
 			writer->WriteLogMessage(msg);
 		}
+	} else if (Push(msg)) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiting) {
+			// the lock holds us until the logging thread has checked the queue or is asleep
+			std::lock_guard<std::mutex> l(queueLock);
+			cv.notify_one();
+		}
 	} else {
-		std::lock_guard<std::mutex> l(queueLock);
-		messageQueue.push_back(std::move(msg));
-		cv.notify_all();
+		++dropped;
 	}
 }
 
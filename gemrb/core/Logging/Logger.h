@@ -65,6 +65,7 @@ public:
 		std::string message;
 		LOG_FMT format;
 		
+		LogMessage() noexcept = default;
 		LogMessage(LogLevel level, std::string owner, std::string message, LOG_FMT fmt)
 		: level(level), owner(std::move(owner)), message(std::move(message)), format(fmt) {}
 	};
@@ -86,18 +87,31 @@ public:
 
 	using WriterPtr = std::shared_ptr<LogWriter>;
 private:
-	using QueueType = std::deque<LogMessage>;
-	QueueType messageQueue;
+	// bounded queue for any number of producers, the logging thread is the only consumer
+	struct Slot {
+		std::atomic<size_t> sequence {0};
+		LogMessage message;
+	};
+	static constexpr size_t QueueSize = 4096; // must be a power of two
+	std::unique_ptr<Slot[]> messageQueue;
+	std::atomic<size_t> enqueuePos {0};
+	size_t dequeuePos = 0;
+	// messages lost to a full queue, reported by the logging thread
+	std::atomic<size_t> dropped {0};
 	std::deque<WriterPtr> writers;
 	
 	std::atomic_bool running {true};
+	// set while the logging thread is about to sleep, only then producers need to wake it
+	std::atomic_bool waiting {false};
 	std::condition_variable cv;
 	std::mutex queueLock;
 	std::mutex writerLock;
 	std::thread loggingThread;
 	
-	void threadLoop();
-	void ProcessMessages(QueueType queue);
+	bool Push(LogMessage& msg);
+	bool Pop(LogMessage& msg);
+	bool HasQueued() const;
+	void ProcessMessages();
 	void StartProcessingThread();
 
 public:
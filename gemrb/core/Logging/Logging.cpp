@@ -22,9 +22,11 @@
 
 #include "GUI/GUIScriptInterface.h"
 #include "GUI/TextArea.h"
+#include "Strings/StringMap.h"
 
 #include <cstdarg>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #ifndef STATIC_LINK
@@ -40,6 +42,20 @@ static std::atomic<LogLevel> CWLL;
 static std::deque<Logger::WriterPtr> writers;
 static std::unique_ptr<Logger> logger;
 
+static std::atomic<LogLevel> writerLevel {DEBUG};
+// per owner overrides, rarely set, so every change publishes a new immutable
+// snapshot and checking a level never needs a lock
+struct ChannelLevels {
+	StringMap<LogLevel> levels;
+	// bounds of the overrides, which settle most checks without a lookup
+	LogLevel least = DEBUG;
+	LogLevel most = FATAL;
+};
+static std::atomic<const ChannelLevels*> channelLevels {nullptr};
+static std::mutex channelLock; // only for the writers
+// replaced snapshots are kept, since other threads may still be reading them
+static std::vector<std::unique_ptr<const ChannelLevels>> channelSnapshots;
+
 void ToggleLogging(bool enable)
 {
 	if (enable && logger == nullptr) {
@@ -82,6 +98,45 @@ void SetConsoleWindowLogLevel(LogLevel level)
 	CWLL = level;
 }
 
+void SetLogLevel(LogLevel level)
+{
+	writerLevel = std::min(level, DEBUG);
+}
+
+void SetChannelLogLevel(StringView owner, LogLevel level)
+{
+	level = std::min(level, DEBUG);
+	std::lock_guard<std::mutex> l(channelLock);
+	auto snapshot = std::make_unique<ChannelLevels>();
+	const ChannelLevels* current = channelLevels.load(std::memory_order_relaxed);
+	if (current) {
+		*snapshot = *current;
+	}
+	snapshot->levels.Set(owner, level);
+	// changing an override may leave the bounds wider than needed, which is harmless
+	snapshot->least = std::min(snapshot->least, level);
+	snapshot->most = std::max(snapshot->most, level);
+
+	channelLevels.store(snapshot.get(), std::memory_order_release);
+	channelSnapshots.push_back(std::move(snapshot));
+}
+
+bool LogLevelEnabled(LogLevel level, const char* owner)
+{
+	if (level == INTERNAL || level == FATAL) return true;
+	// the console window can be more verbose than the writers
+	if (level <= CWLL) return true;
+	if (!logger) return false;
+
+	LogLevel threshold = writerLevel;
+	const ChannelLevels* channels = channelLevels.load(std::memory_order_acquire);
+	if (channels && level > std::min(threshold, channels->least)) {
+		if (level > std::max(threshold, channels->most)) return false;
+		threshold = channels->levels.Get(StringView(owner), threshold);
+	}
+	return level <= threshold;
+}
+
 void LogMsg(LogMessage&& msg)
 {
 	ConsoleWinLogMsg(msg);
@@ -120,8 +175,36 @@ static void addGemRBLog(const CoreSettings& config)
 	}
 }
 
+void SetChannelLogLevels(StringView list)
+{
+	for (auto& channel : Explode<StringView, std::string>(list, ',')) {
+		RTrim(channel);
+		auto sep = channel.find('=');
+		if (sep == std::string::npos) continue;
+		std::string owner = channel.substr(0, sep);
+		RTrim(owner);
+		const char* start = channel.c_str() + sep + 1;
+		char* end = nullptr;
+		long level = strtol(start, &end, 10);
+		// a typo must not silence a channel
+		if (owner.empty() || end == start || *end != '\0') {
+			Log(WARNING, "Logging", "Ignoring the malformed log channel '{}'.", channel);
+			continue;
+		}
+		SetChannelLogLevel(owner, LogLevel(Clamp<long>(level, 0, DEBUG)));
+	}
+}
+
+// LogChannels is a list like "GameScript=5,ResourceManager=1"
+static void setLogLevels(const CoreSettings& config)
+{
+	SetLogLevel(LogLevel(Clamp(config.MaxLogLevel, 0, int(DEBUG))));
+	SetChannelLogLevels(StringView(config.LogChannels));
+}
+
 }
 
 GEMRB_PLUGIN(unused, "tmp/file logger")
+PLUGIN_INITIALIZER(setLogLevels)
 PLUGIN_INITIALIZER(addGemRBLog)
 END_PLUGIN()
@@ -41,10 +41,29 @@ GEM_EXPORT void AddLogWriter(Logger::WriterPtr&&);
 GEM_EXPORT void SetConsoleWindowLogLevel(LogLevel level);
 GEM_EXPORT void LogMsg(Logger::LogMessage&& msg);
 GEM_EXPORT void FlushLogs();
+/** The most verbose level passed on to the log writers */
+GEM_EXPORT void SetLogLevel(LogLevel level);
+/** Overrides SetLogLevel for the messages of one owner, eg. "GameScript" */
+GEM_EXPORT void SetChannelLogLevel(StringView owner, LogLevel level);
+/** Applies a list like "GameScript=5, ResourceManager=1", skipping malformed entries */
+GEM_EXPORT void SetChannelLogLevels(StringView list);
+/** Whether anything would show a message, so it's worth formatting */
+GEM_EXPORT bool LogLevelEnabled(LogLevel level, const char* owner);
+
+// building with DISABLE_DEBUG_LOGS compiles DEBUG messages out completely
+#ifdef DISABLE_DEBUG_LOGS
+constexpr LogLevel MaxCompiledLogLevel = COMBAT;
+#else
+constexpr LogLevel MaxCompiledLogLevel = DEBUG;
+#endif
 
 template<typename... ARGS>
 void Log(LogLevel level, const char* owner, const char* message, ARGS&&... args)
 {
+	// filter before formatting, so dropped messages cost next to nothing
+	if (level > MaxCompiledLogLevel && level != INTERNAL) return;
+	if (!LogLevelEnabled(level, owner)) return;
+
 	auto formattedMsg = fmt::format(message, std::forward<ARGS>(args)...);
 	LogMsg(Logger::LogMessage(level, owner, std::move(formattedMsg), Logger::MSG_STYLE));
 }
@@ -36,6 +36,7 @@
 #include "ImageMgr.h"
 #include "Palette.h"
 #include "Particles.h"
+#include "PathClusters.h"
 #include "PluginMgr.h"
 #include "Projectile.h"
 #include "SaveGameIterator.h"
@@ -53,8 +54,10 @@
 #include "Scriptable/Door.h"
 #include "Scriptable/InfoPoint.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstring>
 #include <limits>
 #include <utility>
 #include <unordered_map>
@@ -213,6 +216,103 @@ void TileProps::PaintSearchMap(const Point& Pos, uint16_t blocksize, const PathM
 	}
 }
 
+PathMapFlags TileProps::QueryBlocked(const Point& p) const noexcept
+{
+	PathMapFlags ret = QuerySearchMap(p);
+	if (bool(ret & PathMapFlags::TRAVEL)) {
+		ret |= PathMapFlags::PASSABLE;
+	}
+	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR))) {
+		ret &= ~PathMapFlags::PASSABLE;
+	}
+	if (bool(ret & PathMapFlags::DOOR_OPAQUE)) {
+		ret = PathMapFlags::SIDEWALL;
+	}
+	return ret;
+}
+
+PathMapFlags TileProps::QueryBlockedInRadius(const Point& tp, uint16_t size, bool stopOnImpassable) const
+{
+	// We check a circle of radius size-2 around (px,py)
+	// TODO: recheck that this matches originals
+	// these circles are perhaps slightly different for sizes 7 and up.
+
+	PathMapFlags ret = PathMapFlags::IMPASSABLE;
+	size = Clamp<uint16_t>(size, 2, MAX_CIRCLESIZE);
+	uint16_t r = size - 2;
+	
+	std::vector<Point> points;
+	if (r == 0) { // avoid generating 16 identical points
+		points.push_back(tp);
+		points.push_back(tp);
+	} else {
+		points = PlotCircle(tp, r);
+	}
+	for (size_t i = 0; i < points.size(); i += 2)
+	{
+		const Point& p1 = points[i];
+		const Point& p2 = points[i + 1];
+		assert(p1.y == p2.y);
+		assert(p2.x <= p1.x);
+		
+		for (int x = p2.x; x <= p1.x; ++x) {
+			PathMapFlags flags = QueryBlocked(Point(x, p1.y));
+			if (stopOnImpassable && flags == PathMapFlags::IMPASSABLE) {
+				return PathMapFlags::IMPASSABLE;
+			}
+			ret |= flags;
+		}
+	}
+
+	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR|PathMapFlags::SIDEWALL))) {
+		ret &= ~PathMapFlags::PASSABLE;
+	}
+	if (bool(ret & PathMapFlags::DOOR_OPAQUE)) {
+		ret = PathMapFlags::SIDEWALL;
+	}
+
+	return ret;
+}
+
+PathMapFlags TileProps::QueryBlockedInLine(const Point& s, const Point& d, bool stopOnImpassable, float_t stepFactor) const
+{
+	PathMapFlags ret = PathMapFlags::IMPASSABLE;
+	Point p = s;
+	const Point sms = Map::ConvertCoordToTile(s);
+	while (p != d) {
+		float_t dx = d.x - p.x;
+		float_t dy = d.y - p.y;
+		Map::NormalizeDeltas(dx, dy, stepFactor);
+		p.x += dx;
+		p.y += dy;
+		const Point tile = Map::ConvertCoordToTile(p);
+		if (sms == tile) continue;
+
+		PathMapFlags blockStatus = QueryBlocked(tile);
+		if (stopOnImpassable && blockStatus == PathMapFlags::IMPASSABLE) {
+			return PathMapFlags::IMPASSABLE;
+		}
+		ret |= blockStatus;
+	}
+	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR|PathMapFlags::SIDEWALL))) {
+		ret &= ~PathMapFlags::PASSABLE;
+	}
+	if (bool(ret & PathMapFlags::DOOR_OPAQUE)) {
+		ret = PathMapFlags::SIDEWALL;
+	}
+
+	return ret;
+}
+
+TileProps TileProps::Snapshot() const
+{
+	size_t bytes = size.Area() * sizeof(uint32_t);
+	void* pixels = malloc(bytes);
+	std::memcpy(pixels, propPtr, bytes);
+	auto copy = MakeHolder<Sprite2D>(Region(Point(), size), pixels, propImage->Format(), size.w * 4);
+	return TileProps(std::move(copy));
+}
+
 struct Spawns {
 	ResRefMap<SpawnGroup> vars;
 	
@@ -914,6 +1014,7 @@ void Map::DoStepForActor(Actor *actor, ieDword time) const
 	}
 
 	if (!(actor->GetBase(IE_STATE_ID)&STATE_CANTMOVE) ) {
+		actor->CollectPath();
 		actor->DoStep(walkScale, time);
 	}
 }
@@ -1791,7 +1892,7 @@ void Map::UpdateEffects()
 {
 	size_t i = actors.size();
 	while (i--) {
-		actors[i]->RefreshEffects();
+		actors[i]->UpdateEffects();
 	}
 }
 
@@ -1924,7 +2025,9 @@ void Map::MarkVisited(const Actor *actor) const
 		if (!key.Format("{}_visited", scriptName)) {
 			Log(ERROR, "Map", "Area {} has a too long script name for generating _visited globals!", scriptName);
 		}
-		core->GetGame()->locals[key] = 1;
+		Game* game = core->GetGame();
+		game->locals[key] = 1;
+		game->StateChanged();
 	}
 }
 
@@ -1934,11 +2037,46 @@ void Map::AddActor(Actor* actor, bool init)
 	actor->AreaName = scriptName;
 	if (!HasActor(actor)) {
 		actors.push_back( actor );
+		actorGrid.Insert(actor, actor->Pos);
 	}
 	if (init) {
 		actor->SetMap(this);
 		MarkVisited(actor);
 	}
+	ActorMoved(actor);
+}
+
+void Map::ActorMoved(const Actor* actor)
+{
+	actorGrid.Move(actor, actor->Pos);
+	maxActorCircle = std::max(maxActorCircle, actor->circleSize);
+}
+
+// how far beyond its position an actor's circle can reach (see IsOver and PersonalDistance)
+unsigned int Map::ActorCircleReach() const
+{
+	return std::max(16, (maxActorCircle - 1) * 16);
+}
+
+// below this, scanning everyone is cheaper than collecting the grid cells
+static const size_t ActorGridThreshold = 128;
+
+const std::vector<Actor*>& Map::ActorsNear(const Point& p, unsigned int radius, std::vector<Actor*>& nearby) const
+{
+	if (actors.size() < ActorGridThreshold) {
+		return actors;
+	}
+	nearby = actorGrid.Query(p, radius);
+	return nearby;
+}
+
+const std::vector<Actor*>& Map::ActorsNear(const Region& reach, std::vector<Actor*>& nearby) const
+{
+	if (actors.size() < ActorGridThreshold) {
+		return actors;
+	}
+	nearby = actorGrid.Query(reach);
+	return nearby;
 }
 
 bool Map::AnyPCSeesEnemy() const
@@ -1980,6 +2118,7 @@ void Map::DeleteActor(size_t idx)
 		}
 	}
 	//remove the actor from the area's actor list
+	actorGrid.Remove(actor);
 	actors.erase(actors.begin() + idx);
 }
 
@@ -2123,7 +2262,8 @@ Actor* Map::GetActor(const Point &p, int flags, const Movable *checker) const
 
 Actor* Map::GetActorInRadius(const Point& p, int flags, unsigned int radius, const Scriptable* checker) const
 {
-	for (auto actor : actors) {
+	std::vector<Actor*> nearby;
+	for (auto actor : ActorsNear(p, std::min(radius, 1U << 24) + ActorCircleReach() + 1, nearby)) {
 		if (PersonalDistance( p, actor ) > radius)
 			continue;
 		if (!actor->ValidTarget(flags, checker)) {
@@ -2137,7 +2277,10 @@ Actor* Map::GetActorInRadius(const Point& p, int flags, unsigned int radius, con
 std::vector<Actor *> Map::GetAllActorsInRadius(const Point &p, int flags, unsigned int radius, const Scriptable *see) const
 {
 	std::vector<Actor *> neighbours;
-	for (auto actor : actors) {
+	// a foot is at most 16 pixels, see Feet2Pixels
+	unsigned int reach = std::min(radius, 1U << 20) * 16 + 1;
+	std::vector<Actor*> nearby;
+	for (auto actor : ActorsNear(p, reach, nearby)) {
 		if (!WithinRange(actor, p, radius)) {
 			continue;
 		}
@@ -2262,6 +2405,7 @@ void Map::PurgeArea(bool items)
 		if (!actor->ValidTarget(GA_NO_DEAD|GA_NO_UNSCHEDULED|GA_NO_ALLY|GA_NO_ENEMY)) continue;
 		if (!actor->HomeLocation.IsZero() && !actor->HomeLocation.IsInvalid() && actor->Pos != actor->HomeLocation) {
 			actor->Pos = actor->HomeLocation;
+			ActorMoved(actor);
 		}
 	}
 }
@@ -2378,8 +2522,10 @@ Actor *Map::GetActorByScriptName(const ieVariable& name) const
 std::vector<Actor*> Map::GetActorsInRect(const Region& rgn, int excludeFlags) const
 {
 	std::vector<Actor*> actorlist;
-	actorlist.reserve(actors.size());
-	for (auto actor : actors) {
+	Region reach = rgn;
+	reach.ExpandAllSides(static_cast<int>(ActorCircleReach()));
+	std::vector<Actor*> nearby;
+	for (auto actor : ActorsNear(reach, nearby)) {
 		if (!actor->ValidTarget(excludeFlags))
 			continue;
 		if (!rgn.PointInside(actor->Pos)
@@ -2497,17 +2643,7 @@ PathMapFlags Map::GetBlockedTile(const SearchmapPoint& p, int size) const
 // p is in tile coords
 PathMapFlags Map::GetBlockedTile(const SearchmapPoint& p) const
 {
-	PathMapFlags ret = tileProps.QuerySearchMap(p);
-	if (bool(ret & PathMapFlags::TRAVEL)) {
-		ret |= PathMapFlags::PASSABLE;
-	}
-	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR))) {
-		ret &= ~PathMapFlags::PASSABLE;
-	}
-	if (bool(ret & PathMapFlags::DOOR_OPAQUE)) {
-		ret = PathMapFlags::SIDEWALL;
-	}
-	return ret;
+	return tileProps.QueryBlocked(p);
 }
 
 // p is in map coords
@@ -2519,75 +2655,13 @@ PathMapFlags Map::GetBlockedInRadius(const Point& p, unsigned int size, bool sto
 // p is in tile coords
 PathMapFlags Map::GetBlockedInRadiusTile(const SearchmapPoint& tp, uint16_t size, const bool stopOnImpassable) const
 {
-	// We check a circle of radius size-2 around (px,py)
-	// TODO: recheck that this matches originals
-	// these circles are perhaps slightly different for sizes 7 and up.
-
-	PathMapFlags ret = PathMapFlags::IMPASSABLE;
-	size = Clamp<uint16_t>(size, 2, MAX_CIRCLESIZE);
-	uint16_t r = size - 2;
-	
-	std::vector<Point> points;
-	if (r == 0) { // avoid generating 16 identical points
-		points.push_back(tp);
-		points.push_back(tp);
-	} else {
-		points = PlotCircle(tp, r);
-	}
-	for (size_t i = 0; i < points.size(); i += 2)
-	{
-		const Point& p1 = points[i];
-		const Point& p2 = points[i + 1];
-		assert(p1.y == p2.y);
-		assert(p2.x <= p1.x);
-		
-		for (int x = p2.x; x <= p1.x; ++x) {
-			PathMapFlags flags = GetBlockedTile(SearchmapPoint(x, p1.y));
-			if (stopOnImpassable && flags == PathMapFlags::IMPASSABLE) {
-				return PathMapFlags::IMPASSABLE;
-			}
-			ret |= flags;
-		}
-	}
-
-	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR|PathMapFlags::SIDEWALL))) {
-		ret &= ~PathMapFlags::PASSABLE;
-	}
-	if (bool(ret & PathMapFlags::DOOR_OPAQUE)) {
-		ret = PathMapFlags::SIDEWALL;
-	}
-
-	return ret;
+	return tileProps.QueryBlockedInRadius(tp, size, stopOnImpassable);
 }
 
 PathMapFlags Map::GetBlockedInLine(const Point &s, const Point &d, bool stopOnImpassable, const Actor *caller) const
 {
-	PathMapFlags ret = PathMapFlags::IMPASSABLE;
-	Point p = s;
-	const SearchmapPoint sms = ConvertCoordToTile(s);
 	float_t factor = caller && caller->GetSpeed() ? float_t(gamedata->GetStepTime()) / float_t(caller->GetSpeed()) : 1;
-	while (p != d) {
-		float_t dx = d.x - p.x;
-		float_t dy = d.y - p.y;
-		NormalizeDeltas(dx, dy, factor);
-		p.x += dx;
-		p.y += dy;
-		if (sms == ConvertCoordToTile(p)) continue;
-
-		PathMapFlags blockStatus = GetBlocked(p);
-		if (stopOnImpassable && blockStatus == PathMapFlags::IMPASSABLE) {
-			return PathMapFlags::IMPASSABLE;
-		}
-		ret |= blockStatus;
-	}
-	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR|PathMapFlags::SIDEWALL))) {
-		ret &= ~PathMapFlags::PASSABLE;
-	}
-	if (bool(ret & PathMapFlags::DOOR_OPAQUE)) {
-		ret = PathMapFlags::SIDEWALL;
-	}
-
-	return ret;
+	return tileProps.QueryBlockedInLine(s, d, stopOnImpassable, factor);
 }
 
 // PathMapFlags::SIDEWALL obstructs LOS, while PathMapFlags::IMPASSABLE doesn't
@@ -2871,6 +2945,7 @@ void Map::RemoveActor(Actor* actor)
 			ClearSearchMapFor(actor);
 			actor->SetMap(NULL);
 			actor->AreaName.Reset();
+			actorGrid.Remove(actor);
 			actors.erase( actors.begin()+i );
 			return;
 		}
@@ -3369,6 +3444,8 @@ Size Map::GetSize() const
 void Map::FillExplored(bool explored)
 {
 	ExploredBitmap.fill(explored ? 0xff : 0x00);
+	// the cached sweeps would not explore their tiles again
+	InvalidateVision();
 }
 
 void Map::ExploreTile(const Point &p, bool fogOnly)
@@ -3381,8 +3458,16 @@ void Map::ExploreTile(const Point &p, bool fogOnly)
 	}
 	
 	ExploredBitmap[fogP] = true;
-	if (!fogOnly) {
-		VisibleBitmap[fogP] = true;
+	if (fogOnly) {
+		return;
+	}
+
+	int idx = fogP.y * fogSize.w + fogP.x;
+	if (visionSink) {
+		visionSink->push_back(idx);
+	} else if (!static_cast<const Bitmap&>(VisibleBitmap)[idx]) {
+		VisibleBitmap[idx] = true;
+		revealedTiles.push_back(idx);
 	}
 }
 
@@ -3432,12 +3517,46 @@ void Map::ExploreMapChunk(const Point &Pos, int range, int los)
 	}
 }
 
+void Map::InvalidateVision()
+{
+	visionDirty = true;
+}
+
+void Map::ReleaseVision(ActorVision& vision)
+{
+	for (int idx : vision.tiles) {
+		if (--visionRefs[idx] == 0) {
+			VisibleBitmap[idx] = false;
+		}
+	}
+	vision.tiles.clear();
+}
+
+// only explorers that moved or whose sight changed are swept again,
+// the rest keep their share of VisibleBitmap from the previous update
 void Map::UpdateFog()
 {
 	TRACY(ZoneScoped);
-	VisibleBitmap.fill(0);
-	
+	if (visionDirty) {
+		actorVision.clear();
+		revealedTiles.clear();
+		visionRefs.assign(FogMapSize().Area(), 0);
+		VisibleBitmap.fill(0);
+		visionDirty = false;
+	}
+
+	// drop what was revealed since the last update, unless an explorer sees it too
+	for (int idx : revealedTiles) {
+		VisibleBitmap[idx] = visionRefs[idx] > 0;
+	}
+	revealedTiles.clear();
+
+	for (auto& vision : actorVision) {
+		vision.second.seen = false;
+	}
+
 	std::set<Spawn*> potentialSpawns;
+	std::vector<int> sweep;
 	for (const auto actor : actors) {
 		if (!actor->Modified[IE_EXPLORE]) continue;
 
@@ -3446,12 +3565,49 @@ void Map::UpdateFog()
 		
 		int vis2 = actor->Modified[IE_VISUALRANGE];
 		if ((state&STATE_BLIND) || (vis2<2)) vis2=2; //can see only themselves
-		ExploreMapChunk (actor->Pos, vis2+actor->GetAnims()->GetCircleSize(), 1);
-		
-		Spawn *sp = GetSpawnRadius(actor->Pos, SPAWN_RANGE); //30 * 12
-		if (sp) {
-			potentialSpawns.insert(sp);
+		int range = vis2 + actor->GetAnims()->GetCircleSize();
+
+		ActorVision& vision = actorVision[actor];
+		vision.seen = true;
+		if (vision.pos != actor->Pos || vision.range != range) {
+			ReleaseVision(vision);
+			vision.pos = actor->Pos;
+			vision.range = range;
+
+			sweep.clear();
+			visionSink = &sweep;
+			ExploreMapChunk(actor->Pos, range, 1);
+			visionSink = nullptr;
+			// rays overlap near the origin
+			std::sort(sweep.begin(), sweep.end());
+			sweep.erase(std::unique(sweep.begin(), sweep.end()), sweep.end());
+			for (int idx : sweep) {
+				if (visionRefs[idx]++ == 0) {
+					VisibleBitmap[idx] = true;
+				}
+			}
+			vision.tiles = sweep;
+			vision.spawnCount = 0;
+		}
+
+		// spawns are only ever added, so the lookup holds until the actor moves
+		if (vision.spawnCount != spawns.size()) {
+			vision.spawn = GetSpawnRadius(actor->Pos, SPAWN_RANGE); //30 * 12
+			vision.spawnCount = spawns.size();
+		}
+		if (vision.spawn) {
+			potentialSpawns.insert(vision.spawn);
+		}
+	}
+
+	// explorers that left, died or went blind
+	for (auto it = actorVision.begin(); it != actorVision.end();) {
+		if (it->second.seen) {
+			++it;
+			continue;
 		}
+		ReleaseVision(it->second);
+		it = actorVision.erase(it);
 	}
 	
 	for (Spawn* spawn : potentialSpawns) {
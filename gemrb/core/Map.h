@@ -30,15 +30,16 @@
 #include "Scriptable/Scriptable.h"
 #include "PathFinder.h"
 #include "Polygon.h"
+#include "SpatialGrid.h"
 #include "Video/Video.h"
 #include "WorldMap.h"
 
 #include <algorithm>
+#include <future>
+#include <memory>
 #include <queue>
 #include <unordered_map>
 
-template <class V> class FibonacciHeap;
-
 namespace GemRB {
 
 class Actor;
@@ -50,6 +51,7 @@ class GameControl;
 class IniSpawn;
 class Palette;
 class Particles;
+class PathClusters;
 struct PathListNode;
 class Projectile;
 class ScriptedAnimation;
@@ -350,6 +352,15 @@ public:
 	
 	void PaintSearchMap(const Point&, PathMapFlags value) const noexcept;
 	void PaintSearchMap(const Point& Pos, uint16_t blocksize, PathMapFlags value) const noexcept;
+
+	// searchmap queries, taking doors and actors into account; points are in tile coords
+	PathMapFlags QueryBlocked(const Point& p) const noexcept;
+	PathMapFlags QueryBlockedInRadius(const Point& p, uint16_t size, bool stopOnImpassable) const;
+	// s and d are in map coords, stepFactor scales the walking steps like in Map::NormalizeDeltas
+	PathMapFlags QueryBlockedInLine(const Point& s, const Point& d, bool stopOnImpassable, float_t stepFactor) const;
+
+	// a private copy of the current data, safe to query from other threads
+	TileProps Snapshot() const;
 };
 
 class GEM_EXPORT Map : public Scriptable {
@@ -384,6 +395,10 @@ private:
 
 	std::list<AreaAnimation> animations;
 	std::vector< Actor*> actors;
+	// buckets the actors by position for the radius/rect queries
+	SpatialGrid<Actor> actorGrid;
+	// largest circle size seen, bounds how far a personal distance reaches
+	int maxActorCircle = 1;
 	std::vector<WallPolygonGroup> wallGroups;
 	std::list< VEFObject*> vvcCells;
 	std::list< Projectile*> projectiles;
@@ -417,6 +432,30 @@ private:
 	};
 	
 	std::unique_ptr<MapReverb> reverb;
+	// abstract searchmap graph, only built while hierarchical pathfinding is enabled;
+	// replaced instead of modified, so searches can keep using the one they started with
+	std::shared_ptr<const PathClusters> pathClusters;
+	std::vector<std::shared_ptr<PathRequest>> queuedPaths;
+	std::vector<std::shared_ptr<PathRequest>> dispatchedPaths;
+	std::vector<std::future<void>> runningSearches;
+
+	// what an explorer saw on its last sweep, reused by UpdateFog until it moves
+	struct ActorVision {
+		Point pos;
+		int range = 0;
+		bool seen = false;
+		Spawn* spawn = nullptr;
+		size_t spawnCount = 0;
+		std::vector<int> tiles; // fog tile indices
+	};
+	std::unordered_map<const Actor*, ActorVision> actorVision;
+	// how many explorers currently see each fog tile
+	std::vector<uint16_t> visionRefs;
+	// tiles revealed outside UpdateFog (scripts, effects), they only last until the next update
+	std::vector<int> revealedTiles;
+	// while set, ExploreTile collects visible tiles here instead of setting them
+	std::vector<int>* visionSink = nullptr;
+	bool visionDirty = true;
 	MapReverb::id_t reverbID = EFX_PROFILE_REVERB_INVALID;
 
 	struct MainAmbients {
@@ -492,6 +531,8 @@ public:
 	void InitActors();
 	void MarkVisited(const Actor *actor) const;
 	void AddActor(Actor* actor, bool init);
+	// keeps the spatial index in sync, call after changing an actor's position or circle
+	void ActorMoved(const Actor* actor);
 	//counts the summons already in the area
 	int CountSummons(ieDword flag, ieDword sex) const;
 	//returns true if an enemy is near P (used in resting/saving)
@@ -588,6 +629,8 @@ public:
 	void ClearSearchMapFor(const Movable *actor) const;
 	/* update VisibleBitmap by resolving vision of all explore actors */
 	void UpdateFog();
+	/* forget the cached actor vision, eg. after line of sight changed */
+	void InvalidateVision();
 	//PathFinder
 	/* Finds the nearest passable point */
 	void AdjustPosition(Point& goal, const Size& startingRadius = ZeroSize, int size = -1) const;
@@ -604,6 +647,16 @@ public:
 	Path GetLinePath(const Point &start, const Point &dest, int speed, orient_t Orientation, int flags) const;
 	/* Finds the path which leads to near d */
 	PathListNode* FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance = 0, int flags = PF_SIGHT, const Actor *caller = NULL) const;
+	/* Queues a FindPath, the batch is searched on worker threads and answered on the next tick */
+	std::shared_ptr<PathRequest> RequestPath(const Point& s, const Point& d, unsigned int size, unsigned int minDistance = 0, int flags = PF_SIGHT, const Actor* caller = nullptr);
+	/* Starts searching the requests of this tick, call at the end of it */
+	void DispatchPathRequests();
+	/* Waits for the dispatched searches and marks their requests done */
+	void CollectPathRequests();
+	/* (Re)builds the cluster graph used by the hierarchical pathfinder */
+	void BuildPathClusters();
+	/* Patches the cluster graph after the searchmap changed at these tiles */
+	void UpdatePathClusters(const std::vector<SearchmapPoint>& tiles);
 
 	bool IsVisible(const Point &p) const;
 	bool IsExplored(const Point &p) const;
@@ -666,6 +719,14 @@ private:
 	VEFObject *GetNextScriptedAnimation(const scaIterator &iter) const;
 	Actor *GetNextActor(int &q, size_t &index) const;
 	Container* GetNextPile (size_t& index) const;
+	bool PreparePathQuery(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller, PathQuery& query) const;
+	PathListNode* FindPathDirect(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller) const;
+	PathListNode* FindPathHierarchical(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller) const;
+	unsigned int ActorCircleReach() const;
+	/** Candidates for the radius/rect queries, all actors when there are too few for the grid to pay off */
+	const std::vector<Actor*>& ActorsNear(const Point& p, unsigned int radius, std::vector<Actor*>& nearby) const;
+	const std::vector<Actor*>& ActorsNear(const Region& reach, std::vector<Actor*>& nearby) const;
+	void ReleaseVision(ActorVision& vision);
 
 	void RedrawScreenStencil(const Region& vp, const WallPolygonGroup& walls);
 	void DrawStencil(const VideoBufferPtr& stencilBuffer, const Region& vp, const WallPolygonGroup& walls) const;
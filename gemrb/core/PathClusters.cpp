@@ -0,0 +1,278 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "PathClusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <set>
+
+namespace GemRB {
+
+// walking costs match the navmap size of a searchmap tile
+constexpr unsigned int STEP_COST_X = 16;
+constexpr unsigned int STEP_COST_Y = 12;
+constexpr unsigned int UNREACHABLE = std::numeric_limits<unsigned int>::max();
+
+using CostNode = std::pair<unsigned int, int>;
+using OpenSet = std::priority_queue<CostNode, std::vector<CostNode>, std::greater<CostNode>>;
+
+constexpr int PathClusters::ClusterSize;
+
+PathClusters::PathClusters(const Size& mapSize, Passable passable)
+: mapSize(mapSize), passable(std::move(passable))
+{
+	gridSize.w = (mapSize.w + ClusterSize - 1) / ClusterSize;
+	gridSize.h = (mapSize.h + ClusterSize - 1) / ClusterSize;
+	clusters.resize(gridSize.Area());
+	for (int cy = 0; cy < gridSize.h; ++cy) {
+		for (int cx = 0; cx < gridSize.w; ++cx) {
+			BuildCluster(cx, cy);
+		}
+	}
+}
+
+int PathClusters::ClusterIndex(const SearchmapPoint& p) const
+{
+	return (p.y / ClusterSize) * gridSize.w + p.x / ClusterSize;
+}
+
+int PathClusters::ClusterDistance(const SearchmapPoint& a, const SearchmapPoint& b) const
+{
+	return std::max(std::abs(a.x / ClusterSize - b.x / ClusterSize), std::abs(a.y / ClusterSize - b.y / ClusterSize));
+}
+
+size_t PathClusters::NodeCount() const
+{
+	size_t count = 0;
+	for (const auto& cluster : clusters) {
+		count += cluster.nodes.size();
+	}
+	return count;
+}
+
+void PathClusters::Update(const std::vector<SearchmapPoint>& tiles)
+{
+	// border transitions are shared, so the neighbours need rebuilding too
+	std::set<std::pair<int, int>> dirty;
+	for (const auto& tile : tiles) {
+		if (!mapSize.PointInside(tile)) continue;
+		int cx = tile.x / ClusterSize;
+		int cy = tile.y / ClusterSize;
+		dirty.emplace(cx, cy);
+		dirty.emplace(cx - 1, cy);
+		dirty.emplace(cx + 1, cy);
+		dirty.emplace(cx, cy - 1);
+		dirty.emplace(cx, cy + 1);
+	}
+
+	for (const auto& cell : dirty) {
+		if (cell.first < 0 || cell.second < 0 || cell.first >= gridSize.w || cell.second >= gridSize.h) continue;
+		BuildCluster(cell.first, cell.second);
+	}
+}
+
+void PathClusters::AddTransitions(Cluster& cluster, const SearchmapPoint& from, const SearchmapPoint& step, const SearchmapPoint& across, int length) const
+{
+	unsigned int acrossCost = across.x ? STEP_COST_X : STEP_COST_Y;
+	int runStart = -1;
+	// one past the end, so the last run gets closed too
+	for (int i = 0; i <= length; ++i) {
+		bool open = false;
+		if (i < length) {
+			SearchmapPoint p(from.x + step.x * i, from.y + step.y * i);
+			open = passable(p) && passable(p + across);
+		}
+		if (open && runStart < 0) {
+			runStart = i;
+		} else if (!open && runStart >= 0) {
+			// both sides pick the same middle tile, since they see the same run
+			int mid = runStart + (i - 1 - runStart) / 2;
+			SearchmapPoint p(from.x + step.x * mid, from.y + step.y * mid);
+			SearchmapPoint q = p + across;
+			cluster.nodes[p.y * mapSize.w + p.x].push_back({ q.y * mapSize.w + q.x, acrossCost });
+			runStart = -1;
+		}
+	}
+}
+
+void PathClusters::BuildCluster(int cx, int cy)
+{
+	Cluster& cluster = clusters[cy * gridSize.w + cx];
+	int x0 = cx * ClusterSize;
+	int y0 = cy * ClusterSize;
+	cluster.bounds = Region(x0, y0, std::min(ClusterSize, mapSize.w - x0), std::min(ClusterSize, mapSize.h - y0));
+	cluster.nodes.clear();
+
+	const Region& r = cluster.bounds;
+	if (cx > 0) {
+		AddTransitions(cluster, Point(r.x, r.y), Point(0, 1), Point(-1, 0), r.h);
+	}
+	if (cx + 1 < gridSize.w) {
+		AddTransitions(cluster, Point(r.x + r.w - 1, r.y), Point(0, 1), Point(1, 0), r.h);
+	}
+	if (cy > 0) {
+		AddTransitions(cluster, Point(r.x, r.y), Point(1, 0), Point(0, -1), r.w);
+	}
+	if (cy + 1 < gridSize.h) {
+		AddTransitions(cluster, Point(r.x, r.y + r.h - 1), Point(1, 0), Point(0, 1), r.w);
+	}
+
+	// connect the nodes within the cluster
+	std::vector<int> tiles;
+	for (const auto& node : cluster.nodes) {
+		tiles.push_back(node.first);
+	}
+	for (int tile : tiles) {
+		std::vector<unsigned int> dist = Flood(cluster, SearchmapPoint(tile % mapSize.w, tile / mapSize.w), passable);
+		auto& edges = cluster.nodes[tile];
+		for (int other : tiles) {
+			if (other == tile) continue;
+			int local = (other / mapSize.w - r.y) * r.w + (other % mapSize.w - r.x);
+			if (dist[local] == UNREACHABLE) continue;
+			edges.push_back({ other, dist[local] });
+		}
+	}
+}
+
+std::vector<unsigned int> PathClusters::Flood(const Cluster& cluster, const SearchmapPoint& origin, const Passable& isPassable) const
+{
+	const Region& r = cluster.bounds;
+	std::vector<unsigned int> dist(r.w * r.h, UNREACHABLE);
+	if (!isPassable(origin)) return dist;
+
+	static const SearchmapPoint steps[] = { Point(1, 0), Point(-1, 0), Point(0, 1), Point(0, -1) };
+	OpenSet open;
+	int start = (origin.y - r.y) * r.w + (origin.x - r.x);
+	dist[start] = 0;
+	open.emplace(0, start);
+	while (!open.empty()) {
+		CostNode current = open.top();
+		open.pop();
+		if (current.first > dist[current.second]) continue;
+
+		SearchmapPoint p(r.x + current.second % r.w, r.y + current.second / r.w);
+		for (const auto& step : steps) {
+			SearchmapPoint q = p + step;
+			if (q.x < r.x || q.y < r.y || q.x >= r.x + r.w || q.y >= r.y + r.h) continue;
+			if (!isPassable(q)) continue;
+			int local = (q.y - r.y) * r.w + (q.x - r.x);
+			unsigned int cost = current.first + (step.x ? STEP_COST_X : STEP_COST_Y);
+			if (cost >= dist[local]) continue;
+			dist[local] = cost;
+			open.emplace(cost, local);
+		}
+	}
+	return dist;
+}
+
+bool PathClusters::FindWaypoints(const SearchmapPoint& start, const SearchmapPoint& goal, std::vector<SearchmapPoint>& waypoints) const
+{
+	return FindWaypoints(start, goal, waypoints, passable);
+}
+
+bool PathClusters::FindWaypoints(const SearchmapPoint& start, const SearchmapPoint& goal, std::vector<SearchmapPoint>& waypoints, const Passable& isPassable) const
+{
+	waypoints.clear();
+	if (!mapSize.PointInside(start) || !mapSize.PointInside(goal)) return false;
+	// neighbouring clusters are cheap enough for a direct search
+	if (ClusterDistance(start, goal) <= 1) return false;
+
+	const Cluster& startCluster = clusters[ClusterIndex(start)];
+	const Cluster& goalCluster = clusters[ClusterIndex(goal)];
+	std::vector<unsigned int> startDist = Flood(startCluster, start, isPassable);
+	std::vector<unsigned int> goalDist = Flood(goalCluster, goal, isPassable);
+
+	int startTile = start.y * mapSize.w + start.x;
+	int goalTile = goal.y * mapSize.w + goal.x;
+	auto localIndex = [this](const Cluster& cluster, int tile) {
+		const Region& r = cluster.bounds;
+		return (tile / mapSize.w - r.y) * r.w + (tile % mapSize.w - r.x);
+	};
+	auto heuristic = [this, &goal](int tile) {
+		int dx = tile % mapSize.w - goal.x;
+		int dy = tile / mapSize.w - goal.y;
+		return static_cast<unsigned int>(std::hypot(dx * float_t(STEP_COST_X), dy * float_t(STEP_COST_Y)));
+	};
+
+	std::unordered_map<int, unsigned int> costs;
+	std::unordered_map<int, int> parents;
+	OpenSet open;
+	costs[startTile] = 0;
+	open.emplace(heuristic(startTile), startTile);
+
+	auto relax = [&](int from, int to, unsigned int cost) {
+		auto known = costs.find(to);
+		if (known != costs.end() && known->second <= cost) return;
+		costs[to] = cost;
+		parents[to] = from;
+		open.emplace(cost + heuristic(to), to);
+	};
+
+	bool found = false;
+	while (!open.empty()) {
+		int tile = open.top().second;
+		open.pop();
+		if (tile == goalTile) {
+			found = true;
+			break;
+		}
+		unsigned int cost = costs[tile];
+
+		if (tile == startTile) {
+			for (const auto& node : startCluster.nodes) {
+				unsigned int d = startDist[localIndex(startCluster, node.first)];
+				if (d != UNREACHABLE) relax(tile, node.first, cost + d);
+			}
+		}
+
+		const Cluster& cluster = clusters[ClusterIndex(SearchmapPoint(tile % mapSize.w, tile / mapSize.w))];
+		auto node = cluster.nodes.find(tile);
+		if (node == cluster.nodes.end()) continue;
+		for (const auto& edge : node->second) {
+			relax(tile, edge.tile, cost + edge.cost);
+		}
+		if (&cluster == &goalCluster) {
+			unsigned int d = goalDist[localIndex(goalCluster, tile)];
+			if (d != UNREACHABLE) relax(tile, goalTile, cost + d);
+		}
+	}
+	if (!found) return false;
+
+	std::vector<SearchmapPoint> path;
+	for (int tile = goalTile; tile != startTile; tile = parents[tile]) {
+		path.emplace_back(tile % mapSize.w, tile / mapSize.w);
+	}
+	std::reverse(path.begin(), path.end());
+
+	// keep only the waypoints needed so every leg stays within neighbouring clusters
+	SearchmapPoint legStart = start;
+	for (size_t i = 0; i + 1 < path.size(); ++i) {
+		if (ClusterDistance(legStart, path[i + 1]) > 1) {
+			waypoints.push_back(path[i]);
+			legStart = path[i];
+		}
+	}
+	waypoints.push_back(goal);
+	return true;
+}
+
+}
@@ -0,0 +1,91 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef PATHCLUSTERS_H
+#define PATHCLUSTERS_H
+
+#include "exports.h"
+
+#include "PathFinder.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * Abstract graph over the searchmap for hierarchical pathfinding (HPA*).
+ * The searchmap is split into square clusters, neighbouring clusters are
+ * connected at the middle of every passable stretch of their shared border
+ * and the nodes of a cluster are connected with their walking distances.
+ * Long queries are answered on this small graph and the caller refines the
+ * returned waypoints with short searches on the real searchmap.
+ * Only static passability is considered, actors are left to the refinement.
+ */
+class GEM_EXPORT PathClusters {
+public:
+	using Passable = std::function<bool(const SearchmapPoint&)>;
+	static constexpr int ClusterSize = 16;
+
+	PathClusters(const Size& mapSize, Passable passable);
+
+	/** Rebuilds the clusters around the changed tiles, eg. after a door toggled */
+	void Update(const std::vector<SearchmapPoint>& tiles);
+
+	/**
+	 * Fills waypoints (searchmap points, ending with goal) for a walk from start
+	 * to goal. Returns false if there is no abstract path or both points are
+	 * close enough that a direct search is cheaper.
+	 */
+	bool FindWaypoints(const SearchmapPoint& start, const SearchmapPoint& goal, std::vector<SearchmapPoint>& waypoints) const;
+	/** The same, but checking the tiles around start and goal with isPassable, eg. on a snapshot of the searchmap */
+	bool FindWaypoints(const SearchmapPoint& start, const SearchmapPoint& goal, std::vector<SearchmapPoint>& waypoints, const Passable& isPassable) const;
+
+	/** Chebyshev distance of the clusters holding a and b */
+	int ClusterDistance(const SearchmapPoint& a, const SearchmapPoint& b) const;
+	size_t NodeCount() const;
+
+private:
+	struct Edge {
+		int tile; // searchmap index of the target node
+		unsigned int cost;
+	};
+
+	struct Cluster {
+		Region bounds;
+		// node tile index -> edges to other nodes of this cluster and across the borders
+		std::unordered_map<int, std::vector<Edge>> nodes;
+	};
+
+	Size mapSize;
+	Size gridSize;
+	Passable passable;
+	std::vector<Cluster> clusters;
+
+	int ClusterIndex(const SearchmapPoint& p) const;
+	void BuildCluster(int cx, int cy);
+	void AddTransitions(Cluster& cluster, const SearchmapPoint& from, const SearchmapPoint& step, const SearchmapPoint& across, int length) const;
+	// walking distances from origin to every tile of the cluster
+	std::vector<unsigned int> Flood(const Cluster& cluster, const SearchmapPoint& origin, const Passable& isPassable) const;
+};
+
+}
+
+#endif
@@ -35,14 +35,18 @@
 // which is solved with a P regulator, see Scriptable.cpp
 
 #include "Debug.h"
-#include "FibonacciHeap.h"
 #include "GameData.h"
+#include "Interface.h"
 #include "Map.h"
+#include "PathClusters.h"
 #include "PathFinder.h"
 #include "RNG.h"
+#include "ThreadPool.h"
 #include "Scriptable/Actor.h"
 
 #include <array>
+#include <chrono>
+#include <functional>
 #include <limits>
 
 namespace GemRB {
@@ -58,6 +62,76 @@ constexpr std::array<float_t, RAND_DEGREES_OF_FREEDOM> dxRand{{0.000, -0.383, -0
 // Sines
 constexpr std::array<float_t, RAND_DEGREES_OF_FREEDOM> dyRand{{1.000, 0.924, 0.707, 0.383, 0.000, -0.383, -0.707, -0.924, -1.000, -0.924, -0.707, -0.383, 0.000, 0.383, 0.707, 0.924}};
 
+// Scratch space for FindPath, kept per thread and reused between searches.
+// Cells are only valid while their stamp matches the current search, so
+// starting a new one doesn't need to clear the map sized arrays and
+// short searches only touch the cells they expand.
+class PathSearchSpace {
+public:
+	struct Cell {
+		uint32_t seen = 0;
+		uint32_t closed = 0;
+		NavmapPoint parent;
+		unsigned short dist = 0;
+	};
+
+	// the open set, kept as a min-heap in a reused vector
+	std::vector<PQNode> open;
+	bool busy = false;
+
+	void Begin(size_t area)
+	{
+		// only grow, smaller areas just use a prefix; the stamps keep it valid
+		if (cells.size() < area) {
+			cells.resize(area);
+		}
+		if (++generation == 0) {
+			// stamps wrapped around, old ones could look current
+			std::fill(cells.begin(), cells.begin() + area, Cell());
+			generation = 1;
+			clean = area;
+		} else if (clean < area) {
+			// the cells past the area of the last wrap still carry stamps from before it
+			std::fill(cells.begin() + clean, cells.begin() + area, Cell());
+			clean = area;
+		}
+		open.clear();
+	}
+
+	Cell& At(size_t idx)
+	{
+		Cell& cell = cells[idx];
+		if (cell.seen != generation) {
+			cell.seen = generation;
+			cell.parent = Point(0, 0);
+			cell.dist = std::numeric_limits<unsigned short>::max();
+		}
+		return cell;
+	}
+
+	bool IsClosed(size_t idx) const { return cells[idx].closed == generation; }
+	void Close(size_t idx) { cells[idx].closed = generation; }
+
+	void Push(const PQNode& node)
+	{
+		open.push_back(node);
+		std::push_heap(open.begin(), open.end(), std::greater<PQNode>());
+	}
+
+	PQNode Pop()
+	{
+		std::pop_heap(open.begin(), open.end(), std::greater<PQNode>());
+		PQNode node = open.back();
+		open.pop_back();
+		return node;
+	}
+
+private:
+	std::vector<Cell> cells;
+	uint32_t generation = 0;
+	size_t clean = std::numeric_limits<size_t>::max(); // cells known to be free of stale stamps
+};
+
 // Find the best path of limited length that brings us the farthest from d
 PathListNode* Map::RunAway(const Point& s, const Point& d, int maxPathLength, bool backAway, const Actor* caller) const
 {
@@ -270,18 +344,148 @@ PathListNode *Map::GetLine(const Point &p, int steps, orient_t orient) const
 	return step;
 }
 
+using ActorBlocker = std::function<bool(const NavmapPoint&)>;
+
+static bool UsePlainThetaStar()
+{
+	static const bool plain = gamedata->GetMiscRule("LAZY_THETA_STAR") == 0;
+	return plain;
+}
+
+static PathListNode* SearchPath(const TileProps& props, const PathQuery& query, const ActorBlocker& blockedByActor);
+
 // Find a path from start to goal, ending at the specified distance from the
 // target (the goal must be in sight of the end, if PF_SIGHT is specified)
 PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const
 {
 	TRACY(ZoneScoped);
-	if (InDebugMode(DebugMode::PATHFINDER))
+	bool debug = InDebugMode(DebugMode::PATHFINDER);
+	if (debug)
 		Log(DEBUG, "FindPath", "s = {}, d = {}, caller = {}, dist = {}, size = {}",
 			s, d,
 			fmt::WideToChar{caller ? caller->GetShortName() : u"nullptr"},
 			minDistance, size
 		);
-	bool actorsAreBlocking = flags & PF_ACTORS_ARE_BLOCKING;
+
+	auto start = std::chrono::steady_clock::now();
+	PathListNode* path = nullptr;
+	bool hierarchical = core->config.HierarchicalPathfinding;
+	if (hierarchical) {
+		path = FindPathHierarchical(s, d, size, minDistance, flags, caller);
+		hierarchical = path != nullptr;
+	}
+	if (!path) {
+		// short walks and anything the abstract graph can't answer
+		path = FindPathDirect(s, d, size, minDistance, flags, caller);
+	}
+
+	if (debug) {
+		std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+		Log(DEBUG, "FindPath", "{} search took {:.0f}us", hierarchical ? "hierarchical" : "direct", elapsed.count());
+	}
+	return path;
+}
+
+static void DeletePath(PathListNode* path)
+{
+	while (path) {
+		PathListNode* next = path->Next;
+		delete path;
+		path = next;
+	}
+}
+
+// static passability only, actors move and are handled by the refining searches
+static bool ClusterPassable(const TileProps& props, const SearchmapPoint& p)
+{
+	PathMapFlags flags = props.QuerySearchMap(p);
+	if (bool(flags & (PathMapFlags::DOOR_IMPASSABLE | PathMapFlags::DOOR_OPAQUE))) return false;
+	return bool(flags & (PathMapFlags::PASSABLE | PathMapFlags::TRAVEL));
+}
+
+// HPA*: find waypoints on the cluster graph and connect them with short searches,
+// searchLeg(from, to, lastLeg) being the search for a single leg
+template <typename LEG>
+static PathListNode* SearchWaypoints(const PathClusters& clusters, const TileProps& props, const NavmapPoint& s, const NavmapPoint& d, LEG&& searchLeg)
+{
+	std::vector<SearchmapPoint> waypoints;
+	auto passable = [&props](const SearchmapPoint& p) { return ClusterPassable(props, p); };
+	if (!clusters.FindWaypoints(Map::ConvertCoordToTile(s), Map::ConvertCoordToTile(d), waypoints, passable)) {
+		return nullptr;
+	}
+
+	PathListNode* head = nullptr;
+	PathListNode* tail = nullptr;
+	NavmapPoint legStart = s;
+	for (size_t i = 0; i < waypoints.size(); ++i) {
+		bool lastLeg = i + 1 == waypoints.size();
+		// aim for the middle of the waypoint tile
+		NavmapPoint legEnd = lastLeg ? d : Map::ConvertCoordFromTile(waypoints[i]) + Point(8, 6);
+		if (legEnd == legStart) continue;
+
+		PathListNode* leg = searchLeg(legStart, legEnd, lastLeg);
+		if (!leg) {
+			// eg. a big creature not fitting through a gap; let the caller do a full search
+			DeletePath(head);
+			return nullptr;
+		}
+
+		if (tail) {
+			tail->Next = leg;
+			leg->Parent = tail;
+		} else {
+			head = leg;
+		}
+		tail = leg;
+		while (tail->Next) {
+			tail = tail->Next;
+		}
+		legStart = tail->point;
+	}
+	return head;
+}
+
+void Map::BuildPathClusters()
+{
+	auto passable = [this](const SearchmapPoint& p) { return ClusterPassable(tileProps, p); };
+	pathClusters = std::make_shared<PathClusters>(PropsSize(), passable);
+}
+
+void Map::UpdatePathClusters(const std::vector<SearchmapPoint>& tiles)
+{
+	if (!pathClusters) return;
+
+	// copy on write, a running search may still be using the old graph
+	auto updated = std::make_shared<PathClusters>(*pathClusters);
+	updated->Update(tiles);
+	pathClusters = std::move(updated);
+}
+
+PathListNode* Map::FindPathHierarchical(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller) const
+{
+	// built with the area, see Game::LoadMap and GemRB.SetHierarchicalPathfinding
+	if (!pathClusters) {
+		return nullptr;
+	}
+
+	return SearchWaypoints(*pathClusters, tileProps, s, d, [&](const NavmapPoint& from, const NavmapPoint& to, bool lastLeg) {
+		return FindPathDirect(from, to, size, lastLeg ? minDistance : 0, lastLeg ? flags : flags & ~PF_SIGHT, caller);
+	});
+}
+
+// resolves everything the search needs from the live map, so the search itself
+// can also run on a snapshot
+bool Map::PreparePathQuery(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller, PathQuery& query) const
+{
+	query.source = s;
+	query.target = d;
+	query.size = size;
+	query.minDistance = minDistance;
+	query.flags = flags;
+	query.caller = caller;
+	query.stepFactor = caller && caller->GetSpeed() ? float_t(gamedata->GetStepTime()) / float_t(caller->GetSpeed()) : 1;
+	// load the rule here, the search may run on a worker thread
+	UsePlainThetaStar();
 
 	// TODO: we could optimize this function further by doing everything in SearchmapPoint and converting at the end
 	NavmapPoint nmptDest = d;
@@ -293,30 +497,81 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 		// but stop just before it
 		AdjustPositionNavmap(nmptDest);
 	}
+	query.dest = nmptDest;
 	
-	if (nmptDest == nmptSource) return nullptr;
+	if (nmptDest == nmptSource) return false;
 	
 	SearchmapPoint smptSource = Map::ConvertCoordToTile(nmptSource);
 	SearchmapPoint smptDest = Map::ConvertCoordToTile(nmptDest);
 	
 	if (minDistance < size && !(GetBlockedInRadiusTile(smptDest, size) & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR))) {
 		Log(DEBUG, "FindPath", "{} can't fit in destination", fmt::WideToChar{caller ? caller->GetShortName() : u"nullptr"});
+		return false;
+	}
+
+	return PropsSize().PointInside(smptSource);
+}
+
+PathListNode* Map::FindPathDirect(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller) const
+{
+	PathQuery query;
+	if (!PreparePathQuery(s, d, size, minDistance, flags, caller, query)) {
 		return nullptr;
 	}
 
-	const Size& mapSize = PropsSize();
-	if (!mapSize.PointInside(smptSource)) return nullptr;
-
-	// Initialize data structures
-	FibonacciHeap<PQNode> open;
-	std::vector<bool> isClosed(mapSize.Area(), false);
-	std::vector<NavmapPoint> parents(mapSize.Area(), Point(0, 0));
-	std::vector<unsigned short> distFromStart(mapSize.Area(), std::numeric_limits<unsigned short>::max());
-	distFromStart[smptSource.y * mapSize.w + smptSource.x] = 0;
-	parents[smptSource.y * mapSize.w + smptSource.x] = nmptSource;
-	open.emplace(PQNode(nmptSource, 0));
+	bool actorsAreBlocking = flags & PF_ACTORS_ARE_BLOCKING;
+	auto blockedByActor = [&](const NavmapPoint& p) {
+		// If there's an actor, check it can be bumped away
+		const Actor* actor = GetActor(p, GA_NO_DEAD | GA_NO_UNSCHEDULED);
+		return actor && actor != caller && (actorsAreBlocking || !actor->ValidTarget(GA_ONLY_BUMPABLE));
+	};
+	PathListNode* path = SearchPath(tileProps, query, blockedByActor);
+
+	if (!path && InDebugMode(DebugMode::PATHFINDER)) {
+		if (caller) {
+			Log(DEBUG, "FindPath", "Pathing failed for {}", fmt::WideToChar{caller->GetShortName()});
+		} else {
+			Log(DEBUG, "FindPath", "Pathing failed");
+		}
+	}
+	return path;
+}
+
+// The Theta* search itself, only looking at the given searchmap
+static PathListNode* SearchPath(const TileProps& props, const PathQuery& query, const ActorBlocker& blockedByActor)
+{
+	bool actorsAreBlocking = query.flags & PF_ACTORS_ARE_BLOCKING;
+	unsigned int size = query.size;
+	unsigned int minDistance = query.minDistance;
+	int flags = query.flags;
+	NavmapPoint nmptSource = query.source;
+	NavmapPoint nmptDest = query.dest;
+	SearchmapPoint smptSource = Map::ConvertCoordToTile(nmptSource);
+	SearchmapPoint smptDest = Map::ConvertCoordToTile(nmptDest);
+	const Size& mapSize = props.GetSize();
+
+	PathMapFlags walkableMask = PathMapFlags::PASSABLE | (actorsAreBlocking ? PathMapFlags::UNMARKED : PathMapFlags::ACTOR);
+	auto isWalkableTo = [&](const NavmapPoint& from, const NavmapPoint& to) {
+		return bool(props.QueryBlockedInLine(from, to, true, query.stepFactor) & walkableMask);
+	};
+
+	// Initialize data structures, reusing the ones from the last search
+	static thread_local PathSearchSpace threadSpace;
+	PathSearchSpace localSpace;
+	PathSearchSpace& space = threadSpace.busy ? localSpace : threadSpace;
+	struct SpaceLease {
+		PathSearchSpace& space;
+		~SpaceLease() { space.busy = false; }
+	} lease { space };
+	space.busy = true;
+	space.Begin(mapSize.Area());
+	auto parents = [&space](int idx) -> NavmapPoint& { return space.At(idx).parent; };
+	auto distFromStart = [&space](int idx) -> unsigned short& { return space.At(idx).dist; };
+	distFromStart(smptSource.y * mapSize.w + smptSource.x) = 0;
+	parents(smptSource.y * mapSize.w + smptSource.x) = nmptSource;
+	space.Push(PQNode(nmptSource, 0));
 	bool foundPath = false;
-	bool usePlainThetaStar = gamedata->GetMiscRule("LAZY_THETA_STAR") == 0;
+	bool usePlainThetaStar = UsePlainThetaStar();
 	unsigned int squaredMinDist = minDistance * minDistance;
 
 	// Weighted heuristic. Finds sub-optimal paths but should be quite a bit faster
@@ -331,16 +586,15 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 		int crossProduct = std::abs(xDist * dyCross - yDist * dxCross) >> 3;
 		double distance = std::hypot(xDist, yDist);
 		double heuristic = HEURISTIC_WEIGHT * (distance + crossProduct);
-		double estDist = distFromStart[smptChildIdx] + heuristic;
+		double estDist = distFromStart(smptChildIdx) + heuristic;
 		return estDist;
 	};
 
-	while (!open.empty()) {
-		NavmapPoint nmptCurrent = open.top().point;
-		open.pop();
+	while (!space.open.empty()) {
+		NavmapPoint nmptCurrent = space.Pop().point;
 		SearchmapPoint smptCurrent = Map::ConvertCoordToTile(nmptCurrent);
 		int smptCurrentIdx = smptCurrent.y * mapSize.w + smptCurrent.x;
-		if (parents[smptCurrentIdx].IsZero()) {
+		if (parents(smptCurrentIdx).IsZero()) {
 			continue;
 		}
 
@@ -349,15 +603,15 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 			foundPath = true;
 			break;
 		} else if (minDistance &&
-			   parents[smptCurrentIdx] != nmptCurrent &&
+			   parents(smptCurrentIdx) != nmptCurrent &&
 			   SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist &&
-			   (!(flags & PF_SIGHT) || IsVisibleLOS(nmptCurrent, d))) {
+			   (!(flags & PF_SIGHT) || !bool(props.QueryBlockedInLine(nmptCurrent, query.target, false, 1) & PathMapFlags::SIDEWALL))) {
 			smptDest = smptCurrent;
 			nmptDest = nmptCurrent;
 			foundPath = true;
 			break;
 		}
-		isClosed[smptCurrentIdx] = true;
+		space.Close(smptCurrentIdx);
 
 		for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
 			NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
@@ -366,62 +620,59 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 			if (smptChild.x < 0 ||	smptChild.y < 0 || smptChild.x >= mapSize.w || smptChild.y >= mapSize.h) continue;
 			// Already visited
 			int smptChildIdx = smptChild.y * mapSize.w + smptChild.x;
-			if (isClosed[smptChildIdx]) continue;
+			if (space.IsClosed(smptChildIdx)) continue;
 
 			PathMapFlags childBlockStatus;
 			if (size > 2) {
-				childBlockStatus = GetBlockedInRadiusTile(smptChild, size);
+				childBlockStatus = props.QueryBlockedInRadius(smptChild, size, true);
 			} else {
-				childBlockStatus = GetBlockedTile(smptChild);
+				childBlockStatus = props.QueryBlocked(smptChild);
 			}
 			bool childBlocked = !(childBlockStatus & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR));
 			if (childBlocked) continue;
 
-			// If there's an actor, check it can be bumped away
-			const Actor* childActor = GetActor(nmptChild, GA_NO_DEAD | GA_NO_UNSCHEDULED);
-			bool childIsUnbumpable = childActor && childActor != caller && (actorsAreBlocking || !childActor->ValidTarget(GA_ONLY_BUMPABLE));
-			if (childIsUnbumpable) continue;
+			if (blockedByActor(nmptChild)) continue;
 
 			SearchmapPoint smptCurrent2 = Map::ConvertCoordToTile(nmptCurrent);
-			NavmapPoint nmptParent = parents[smptCurrent2.y * mapSize.w + smptCurrent2.x];
-			unsigned short oldDist = distFromStart[smptChildIdx];
+			NavmapPoint nmptParent = parents(smptCurrent2.y * mapSize.w + smptCurrent2.x);
+			unsigned short oldDist = distFromStart(smptChildIdx);
 
 			if (usePlainThetaStar) {
 				// Theta-star path if there is LOS
-				if (IsWalkableTo(nmptParent, nmptChild, actorsAreBlocking, caller)) {
+				if (isWalkableTo(nmptParent, nmptChild)) {
 					SearchmapPoint smptParent = Map::ConvertCoordToTile(nmptParent);
-					unsigned short newDist = distFromStart[smptParent.y * mapSize.w + smptParent.x] + Distance(smptParent, smptChild);
+					unsigned short newDist = distFromStart(smptParent.y * mapSize.w + smptParent.x) + Distance(smptParent, smptChild);
 					if (newDist < oldDist) {
-						parents[smptChildIdx] = nmptParent;
-						distFromStart[smptChildIdx] = newDist;
+						parents(smptChildIdx) = nmptParent;
+						distFromStart(smptChildIdx) = newDist;
 					}
 				// Fall back to A-star path
 				} else {
-					unsigned short newDist = distFromStart[smptCurrent2.y * mapSize.w + smptCurrent2.x] + Distance(smptCurrent2, smptChild);
+					unsigned short newDist = distFromStart(smptCurrent2.y * mapSize.w + smptCurrent2.x) + Distance(smptCurrent2, smptChild);
 					if (newDist < oldDist) {
-						parents[smptChildIdx] = nmptCurrent;
-						distFromStart[smptChildIdx] = newDist;
+						parents(smptChildIdx) = nmptCurrent;
+						distFromStart(smptChildIdx) = newDist;
 					}
 				}
 
-				if (distFromStart[smptChildIdx] < oldDist) {
+				if (distFromStart(smptChildIdx) < oldDist) {
 					PQNode newNode(nmptChild, getHeuristic(smptChild, smptChildIdx));
-					open.emplace(newNode);
+					space.Push(newNode);
 				}
 			} else {
 				// Lazy Theta star*
 				SearchmapPoint smptParent = Map::ConvertCoordToTile(nmptParent);
-				unsigned short newDist = distFromStart[smptParent.y * mapSize.w + smptParent.x] + Distance(smptParent, smptChild);
+				unsigned short newDist = distFromStart(smptParent.y * mapSize.w + smptParent.x) + Distance(smptParent, smptChild);
 				if (newDist < oldDist) {
-					parents[smptChildIdx] = nmptParent;
-					distFromStart[smptChildIdx] = newDist;
+					parents(smptChildIdx) = nmptParent;
+					distFromStart(smptChildIdx) = newDist;
 				}
 
-				if (distFromStart[smptChildIdx] < oldDist) {
+				if (distFromStart(smptChildIdx) < oldDist) {
 					// Theta-star path if there is LOS
-					if (!IsWalkableTo(nmptParent, nmptChild, actorsAreBlocking, caller)) {
+					if (!isWalkableTo(nmptParent, nmptChild)) {
 						// Fall back to A-star path
-						distFromStart[smptChildIdx] = std::numeric_limits<unsigned short>::max();
+						distFromStart(smptChildIdx) = std::numeric_limits<unsigned short>::max();
 						// Find already visited neighbour with shortest: path from start + path to child
 						for (size_t j = 0; j < DEGREES_OF_FREEDOM; j++) {
 							NavmapPoint nmptVis(nmptChild.x + 16 * dxAdjacent[j], nmptChild.y + 12 * dyAdjacent[j]);
@@ -429,20 +680,20 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 							// Outside map
 							if (smptVis.x < 0 || smptVis.y < 0 || smptVis.x >= mapSize.w || smptVis.y >= mapSize.h) continue;
 							// Only consider already visited
-							if (!isClosed[smptVis.y * mapSize.w + smptVis.x]) continue;
+							if (!space.IsClosed(smptVis.y * mapSize.w + smptVis.x)) continue;
 
-							unsigned short oldVisDist = distFromStart[smptChildIdx];
-							newDist = distFromStart[smptVis.y * mapSize.w + smptVis.x] + Distance(smptVis, smptChild);
+							unsigned short oldVisDist = distFromStart(smptChildIdx);
+							newDist = distFromStart(smptVis.y * mapSize.w + smptVis.x) + Distance(smptVis, smptChild);
 							if (newDist < oldVisDist) {
-								parents[smptChildIdx] = nmptVis;
-								distFromStart[smptChildIdx] = newDist;
+								parents(smptChildIdx) = nmptVis;
+								distFromStart(smptChildIdx) = newDist;
 							}
 						}
-						if (distFromStart[smptChildIdx] >= oldDist) continue;
+						if (distFromStart(smptChildIdx) >= oldDist) continue;
 					}
 
 					PQNode newNode(nmptChild, getHeuristic(smptChild, smptChildIdx));
-					open.emplace(newNode);
+					space.Push(newNode);
 				}
 			}
 		}
@@ -453,8 +704,8 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 		NavmapPoint nmptCurrent = nmptDest;
 		NavmapPoint nmptParent;
 		SearchmapPoint smptCurrent = Map::ConvertCoordToTile(nmptCurrent);
-		while (!resultPath || nmptCurrent != parents[smptCurrent.y * mapSize.w + smptCurrent.x]) {
-			nmptParent = parents[smptCurrent.y * mapSize.w + smptCurrent.x];
+		while (!resultPath || nmptCurrent != parents(smptCurrent.y * mapSize.w + smptCurrent.x)) {
+			nmptParent = parents(smptCurrent.y * mapSize.w + smptCurrent.x);
 			PathListNode *newStep = new PathListNode;
 			newStep->point = nmptCurrent;
 			newStep->Next = resultPath;
@@ -477,17 +728,141 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 			smptCurrent = Map::ConvertCoordToTile(nmptCurrent);
 		}
 		return resultPath;
-	} else if (InDebugMode(DebugMode::PATHFINDER)) {
-		if (caller) {
-			Log(DEBUG, "FindPath", "Pathing failed for {}", fmt::WideToChar{caller->GetShortName()});
-		} else {
-			Log(DEBUG, "FindPath", "Pathing failed");
-		}
 	}
 
 	return nullptr;
 }
 
+PathRequest::~PathRequest()
+{
+	DeletePath(path);
+}
+
+PathListNode* PathRequest::TakePath()
+{
+	PathListNode* ret = path;
+	path = nullptr;
+	return ret;
+}
+
+// What a batch of requests is searched against: a copy of the searchmap and
+// of the actors that FindPath would check for bumping
+struct PathSnapshot {
+	struct Footprint {
+		Point pos;
+		int circleSize;
+		const Actor* actor;
+		bool bumpable;
+	};
+
+	TileProps props;
+	std::vector<Footprint> actors;
+	std::shared_ptr<const PathClusters> clusters; // set when long walks are planned hierarchically
+
+	explicit PathSnapshot(TileProps props) : props(std::move(props)) {}
+
+	// mirrors the GetActor check in FindPathDirect
+	bool BlockedByActor(const NavmapPoint& p, const PathQuery& query) const
+	{
+		for (const auto& footprint : actors) {
+			if (!Selectable::CircleContains(footprint.pos, footprint.circleSize, p)) continue;
+			if (footprint.actor == query.caller) return false;
+			return (query.flags & PF_ACTORS_ARE_BLOCKING) || !footprint.bumpable;
+		}
+		return false;
+	}
+};
+
+std::shared_ptr<PathRequest> Map::RequestPath(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller)
+{
+	auto request = std::make_shared<PathRequest>();
+	if (PreparePathQuery(s, d, size, minDistance, flags, caller, request->query)) {
+		queuedPaths.push_back(request);
+	} else {
+		// nothing to search for, answer right away like FindPath would
+		request->done = true;
+	}
+	return request;
+}
+
+void Map::DispatchPathRequests()
+{
+	if (queuedPaths.empty()) return;
+
+	// callers don't block themselves, as with FindPath after ClearSearchMapFor
+	std::vector<const Actor*> callers;
+	for (const auto& request : queuedPaths) {
+		const Actor* caller = request->query.caller;
+		if (caller && caller->BlocksSearchMap()) {
+			ClearSearchMapFor(caller);
+			callers.push_back(caller);
+		}
+	}
+	auto snapshot = std::make_shared<PathSnapshot>(tileProps.Snapshot());
+	for (const Actor* caller : callers) {
+		BlockSearchMapFor(caller);
+	}
+	for (const Actor* actor : actors) {
+		if (!actor->ValidTarget(GA_NO_DEAD | GA_NO_UNSCHEDULED)) continue;
+		snapshot->actors.push_back({ actor->Pos, actor->circleSize, actor, actor->ValidTarget(GA_ONLY_BUMPABLE) });
+	}
+	if (core->config.HierarchicalPathfinding) {
+		snapshot->clusters = pathClusters;
+	}
+
+	auto batch = std::make_shared<std::vector<std::shared_ptr<PathRequest>>>(std::move(queuedPaths));
+	queuedPaths.clear();
+	auto search = [snapshot, batch](size_t first, size_t stride) {
+		for (size_t i = first; i < batch->size(); i += stride) {
+			PathRequest& request = *(*batch)[i];
+			auto blockedByActor = [&](const NavmapPoint& p) { return snapshot->BlockedByActor(p, request.query); };
+			if (snapshot->clusters) {
+				// the same legs FindPathHierarchical searches, only on the snapshot
+				const PathQuery& query = request.query;
+				request.path = SearchWaypoints(*snapshot->clusters, snapshot->props, query.source, query.dest, [&](const NavmapPoint& from, const NavmapPoint& to, bool lastLeg) {
+					PathQuery leg = query;
+					leg.source = from;
+					leg.dest = to;
+					if (!lastLeg) {
+						leg.target = to;
+						leg.minDistance = 0;
+						leg.flags &= ~PF_SIGHT;
+					}
+					return SearchPath(snapshot->props, leg, blockedByActor);
+				});
+			}
+			if (!request.path) {
+				request.path = SearchPath(snapshot->props, request.query, blockedByActor);
+			}
+		}
+	};
+
+	ThreadPool* pool = core->GetWorkerPool();
+	if (pool) {
+		size_t stride = std::min(batch->size(), pool->ThreadCount());
+		for (size_t first = 0; first < stride; ++first) {
+			runningSearches.push_back(pool->Submit(std::bind(search, first, stride)));
+		}
+	} else {
+		search(0, 1);
+	}
+	dispatchedPaths.insert(dispatchedPaths.end(), batch->begin(), batch->end());
+}
+
+void Map::CollectPathRequests()
+{
+	// results only become visible here, so callers see them on the tick after requesting
+	for (const auto& running : runningSearches) {
+		running.wait();
+	}
+	runningSearches.clear();
+
+	for (const auto& request : dispatchedPaths) {
+		request->done = true;
+	}
+	dispatchedPaths.clear();
+}
+
 void Map::NormalizeDeltas(float_t &dx, float_t &dy, float_t factor)
 {
 	constexpr float_t STEP_RADIUS = 2.0;
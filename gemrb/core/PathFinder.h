@@ -31,6 +31,8 @@
 
 namespace GemRB {
 
+class Actor;
+
 //searchmap conversion bits
 
 enum class PathMapFlags : uint8_t {
@@ -81,6 +83,39 @@ enum {
 	PF_ACTORS_ARE_BLOCKING = 4
 };
 
+// The inputs of a single search, resolved by the Map before it runs
+struct PathQuery {
+	NavmapPoint source;
+	NavmapPoint dest; // moved to the nearest free spot if the target was blocked
+	NavmapPoint target; // the requested destination
+	unsigned int size = 0;
+	unsigned int minDistance = 0;
+	int flags = 0;
+	float_t stepFactor = 1; // walking speed of the caller, see Map::NormalizeDeltas
+	const Actor* caller = nullptr; // only compared against, never dereferenced by the search
+};
+
+// A search answered on the next tick, see Map::RequestPath
+class GEM_EXPORT PathRequest {
+public:
+	PathRequest() noexcept = default;
+	PathRequest(const PathRequest&) = delete;
+	~PathRequest();
+	PathRequest& operator=(const PathRequest&) = delete;
+
+	bool Done() const { return done; }
+	// hands the path over, nullptr if none was found
+	PathListNode* TakePath();
+	const PathQuery& Query() const { return query; }
+
+private:
+	friend class Map;
+
+	PathQuery query;
+	PathListNode* path = nullptr;
+	bool done = false;
+};
+
 
 // Point-distance pair, used by the pathfinder's priority queue
 // to sort nodes by their (heuristic) distance from the destination
@@ -26,6 +26,8 @@
 #include "Resource.h"
 #include "ResourceDesc.h"
 
+#include <algorithm>
+
 namespace GemRB {
 
 path_t TypeExt(SClass_ID type)
@@ -92,18 +94,72 @@ bool ResourceManager::AddSource(const path_t& path, const std::string& descripti
 	}
 
 	if (flags & RM_REPLACE_SAME_SOURCE) {
-		for (auto& path2 : searchPath) {
-			if (description == path2->GetDescription()) {
-				path2 = source;
+		for (size_t i = 0; i < searchPath.size(); ++i) {
+			if (description == searchPath[i]->GetDescription()) {
+				searchPath[i] = source;
+				volatileSource[i] = source->IsVolatile();
 				break;
 			}
 		}
 	} else {
 		searchPath.push_back(source);
+		volatileSource.push_back(source->IsVolatile());
 	}
+	staticSources = std::count(volatileSource.begin(), volatileSource.end(), false);
+
+	// the search order or contents changed, so all previous answers are suspect
+	std::lock_guard<std::mutex> lock(lookupMutex);
+	lookupCache.clear();
 	return true;
 }
 
+size_t ResourceManager::LookupKeyHash::operator()(const LookupKey& key) const
+{
+	return std::hash<std::string>()(key.name) ^ (std::hash<const void*>()(key.typeID) << 1) ^ (key.type << 2);
+}
+
+template <typename HAS>
+size_t ResourceManager::Locate(LookupKey&& key, size_t typeCount, HAS&& has) const
+{
+	// nothing would ever be cached, eg. save game or music managers
+	if (staticSources == 0) {
+		return npos;
+	}
+
+	StringToLower(key.name);
+	{
+		std::lock_guard<std::mutex> lock(lookupMutex);
+		const auto cached = lookupCache.find(key);
+		if (cached != lookupCache.cend()) {
+			++lookupStats.hits;
+			return cached->second;
+		}
+		++lookupStats.misses;
+	}
+
+	size_t found = npos;
+	for (size_t t = 0; t < typeCount && found == npos; ++t) {
+		for (size_t i = 0; i < searchPath.size(); ++i) {
+			if (!volatileSource[i] && has(t, *searchPath[i])) {
+				found = t * searchPath.size() + i;
+				break;
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(lookupMutex);
+	lookupCache.emplace(std::move(key), found);
+	return found;
+}
+
+ResourceManager::LookupCacheStats ResourceManager::GetLookupCacheStats() const
+{
+	std::lock_guard<std::mutex> lock(lookupMutex);
+	LookupCacheStats stats = lookupStats;
+	stats.entries = lookupCache.size();
+	return stats;
+}
+
 static void PrintPossibleFiles(std::string& buffer, StringView ResRef, const TypeID *type)
 {
 	const std::vector<ResourceDesc>& types = PluginMgr::Get()->GetResourceDesc(type);
@@ -123,9 +179,12 @@ bool ResourceManager::Exists(StringView ResRef, SClass_ID type, bool silent) con
 {
 	if (ResRef.empty())
 		return false;
-	// TODO: check various caches
-	for (const auto& path : searchPath) {
-		if (path->HasResource(ResRef, type)) {
+
+	size_t found = Locate({ ResRef.MakeString(), nullptr, type }, 1, [&](size_t, ResourceSource& source) {
+		return source.HasResource(ResRef, type);
+	});
+	for (size_t i = 0; i < searchPath.size(); ++i) {
+		if (i == found || (volatileSource[i] && searchPath[i]->HasResource(ResRef, type))) {
 			return true;
 		}
 	}
@@ -140,11 +199,15 @@ bool ResourceManager::Exists(StringView ResRef, const TypeID *type, bool silent)
 {
 	if (ResRef[0] == '\0')
 		return false;
-	// TODO: check various caches
+
 	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
+	size_t found = Locate({ ResRef.MakeString(), type, 0 }, types.size(), [&](size_t t, ResourceSource& source) {
+		return source.HasResource(ResRef, types[t]);
+	});
+	size_t pos = 0;
 	for (const auto& type2 : types) {
-		for (const auto& path : searchPath) {
-			if (path->HasResource(ResRef, type2)) {
+		for (size_t i = 0; i < searchPath.size(); ++i, ++pos) {
+			if (pos == found || (volatileSource[i] && searchPath[i]->HasResource(ResRef, type2))) {
 				return true;
 			}
 		}
@@ -161,7 +224,16 @@ DataStream* ResourceManager::GetResourceStream(StringView ResRef, SClass_ID type
 {
 	if (ResRef.empty())
 		return nullptr;
-	for (const auto& path : searchPath) {
+
+	size_t found = Locate({ ResRef.MakeString(), nullptr, type }, 1, [&](size_t, ResourceSource& source) {
+		return source.HasResource(ResRef, type);
+	});
+	for (size_t i = 0; i < searchPath.size(); ++i) {
+		// non-volatile sources before the located one are known not to have it
+		if (i < found && !volatileSource[i]) {
+			continue;
+		}
+		const auto& path = searchPath[i];
 		DataStream *ds = path->GetResource(ResRef, type);
 		if (ds) {
 			if (!silent) {
@@ -184,8 +256,16 @@ ResourceHolder<Resource> ResourceManager::GetResource(StringView ResRef, const T
 		Log(MESSAGE, "ResourceManager", "Searching for '{}'...", ResRef);
 	}
 	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
+	size_t found = Locate({ ResRef.MakeString(), type, 0 }, types.size(), [&](size_t t, ResourceSource& source) {
+		return source.HasResource(ResRef, types[t]);
+	});
+	size_t pos = 0;
 	for (const auto& type2 : types) {
-		for (const auto& path : searchPath) {
+		for (size_t i = 0; i < searchPath.size(); ++i, ++pos) {
+			if (pos < found && !volatileSource[i]) {
+				continue;
+			}
+			const auto& path = searchPath[i];
 			DataStream *str = path->GetResource(ResRef, type2);
 			if (!str && useCorrupt && core->UseCorruptedHack) {
 				// don't look at other paths if requested
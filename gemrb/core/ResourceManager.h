@@ -29,6 +29,8 @@
 #include "System/VFS.h"
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace GemRB {
@@ -40,6 +42,12 @@ class TypeID;
 
 class GEM_EXPORT ResourceManager {
 public:
+	struct LookupCacheStats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t entries = 0;
+	};
+
 	/**
 	 * Add ResourceSource to search path
 	 * @param[in] path Path to be used for source.
@@ -55,6 +63,8 @@ public:
 	bool Exists(StringView resRef, const TypeID *type, bool silent=false) const;
 	/** Returns stream associated to given resource */
 	DataStream* GetResourceStream(StringView resname, SClass_ID type, bool silent = false) const;
+	/** Returns lookup cache hit and miss counts */
+	LookupCacheStats GetLookupCacheStats() const;
 	
 	template <class T>
 	inline ResourceHolder<T> GetResourceHolder(StringView resname, bool silent = false, bool useCorrupt = false) const
@@ -62,10 +72,40 @@ public:
 		return std::static_pointer_cast<T>(GetResource(resname, &T::ID, silent, useCorrupt));
 	}
 private:
+	static constexpr size_t npos = size_t(-1);
+
+	struct LookupKey {
+		std::string name; // lowercased
+		const TypeID* typeID; // nullptr for SClass_ID lookups
+		SClass_ID type;
+
+		bool operator==(const LookupKey& other) const {
+			return typeID == other.typeID && type == other.type && name == other.name;
+		}
+	};
+
+	struct LookupKeyHash {
+		size_t operator()(const LookupKey& key) const;
+	};
+
 	/** Returns Resource object associated to given resource */
 	ResourceHolder<Resource> GetResource(StringView resname, const TypeID *type, bool silent = false, bool useCorrupt = false) const;
 
+	/**
+	 * Returns the first position (type index * source count + source index) among
+	 * the non-volatile sources where the resource is present, or npos.
+	 * Volatile sources are never cached and have to be probed by the caller.
+	 */
+	template <typename HAS>
+	size_t Locate(LookupKey&& key, size_t typeCount, HAS&& has) const;
+
 	std::vector<PluginHolder<ResourceSource>> searchPath;
+	std::vector<bool> volatileSource;
+	size_t staticSources = 0;
+
+	mutable std::unordered_map<LookupKey, size_t, LookupKeyHash> lookupCache;
+	mutable LookupCacheStats lookupStats;
+	mutable std::mutex lookupMutex;
 };
 
 }
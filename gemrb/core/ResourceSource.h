@@ -42,6 +42,8 @@ public:
 	virtual bool HasResource(StringView resname, const ResourceDesc &type) = 0;
 	virtual DataStream* GetResource(StringView resname, SClass_ID type) = 0;
 	virtual DataStream* GetResource(StringView resname, const ResourceDesc &type) = 0;
+	/** whether the contents can change after Open, so lookups into it can't be cached */
+	virtual bool IsVolatile() const { return true; }
 	const std::string& GetDescription() const { return description; }
 protected:
 	std::string description;
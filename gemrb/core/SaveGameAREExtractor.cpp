@@ -17,6 +17,7 @@
  */
 #include "Interface.h"
 #include "Logging/Logging.h"
+#include "SaveGameIterator.h"
 #include "Streams/FileCache.h"
 #include "Streams/FileStream.h"
 #include "SaveGameAREExtractor.h"
@@ -37,6 +38,13 @@ int32_t SaveGameAREExtractor::copyRetainedAREs(DataStream *destStream, bool trac
 		return GEM_ERROR;
 	}
 
+	int32_t copied = copyRetainedAREs(saveGameStream, destStream, trackLocations);
+	delete saveGameStream;
+
+	return copied;
+}
+
+int32_t SaveGameAREExtractor::copyRetainedAREs(DataStream *saveGameStream, DataStream *destStream, bool trackLocations) {
 	if (trackLocations) {
 		newAreLocations.clear();
 	}
@@ -76,8 +84,6 @@ int32_t SaveGameAREExtractor::copyRetainedAREs(DataStream *destStream, bool trac
 		}
 	}
 
-	delete saveGameStream;
-
 	return i;
 }
 
@@ -103,6 +109,14 @@ int32_t SaveGameAREExtractor::createCacheBlob() {
 
 int32_t SaveGameAREExtractor::extractARE(const ResRef& key) {
 	auto it = areLocations.find(key);
+	if (it == areLocations.cend()) {
+		return GEM_OK;
+	}
+
+	// the save we extract from may still be written in the background, which also moves the areas
+	if (core->GetSaveGameIterator()->FinishPendingSave(true)) {
+		it = areLocations.find(key);
+	}
 	if (it != areLocations.cend() && extractByEntry(key, it) != GEM_OK) {
 		return GEM_ERROR;
 	}
@@ -137,6 +151,11 @@ int32_t SaveGameAREExtractor::extractByEntry(const ResRef& key, RegistryT::const
 	return returnValue;
 }
 
+DataStream* SaveGameAREExtractor::openSave() const
+{
+	return saveGame ? saveGame->GetSave() : nullptr;
+}
+
 bool SaveGameAREExtractor::isRunningSaveGame(const SaveGame& otherGame) const
 {
 	if (saveGame == nullptr) {
@@ -44,9 +44,13 @@ class GEM_EXPORT SaveGameAREExtractor {
 		explicit SaveGameAREExtractor(Holder<SaveGame> saveGame = nullptr);
 
 		int32_t copyRetainedAREs(DataStream*, bool trackLocations = false);
+		// same, but reading from an already opened stream of the running save
+		int32_t copyRetainedAREs(DataStream* source, DataStream* dest, bool trackLocations = false);
 		int32_t createCacheBlob();
 		int32_t extractARE(const ResRef& resRef);
 		bool isRunningSaveGame(const SaveGame&) const;
+		bool hasSaveGame() const { return saveGame != nullptr; }
+		DataStream* openSave() const;
 		void registerLocation(const ResRef& resRef, unsigned long);
 		void registerNewLocation(const path_t&, unsigned long);
 		void updateSaveGame(size_t offset);
@@ -396,8 +396,8 @@ void SaveGameIterator::PruneQuickSave(StringView folder) const
 	}
 }
 
-/** Save game to given directory */
-static bool DoSaveGame(const path_t& Path, bool overrideRunning)
+/** Save game to given directory, assembling it in tmpPath first and replacing the old slot once done */
+static bool DoSaveGame(SaveGameWriter& writer, const path_t& Path, const path_t& tmpPath, const path_t& replaced, bool overrideRunning)
 {
 	const Game *game = core->GetGame();
 	//saving areas to cache currently in memory
@@ -411,24 +411,29 @@ static bool DoSaveGame(const path_t& Path, bool overrideRunning)
 
 	gamedata->SaveAllStores();
 
-	//compress files in cache named: .STO and .ARE
+	auto job = std::make_unique<SaveGameWriter::Job>();
+	job->path = Path;
+	job->tmpPath = tmpPath;
+	job->replaced = replaced;
+
+	//snapshot files in cache named: .STO and .ARE, they get compressed later
 	//no .CRE would be saved in cache
-	if (core->CompressSave(Path, overrideRunning)) {
+	if (core->CollectSaveFiles(*job, overrideRunning)) {
 		return false;
 	}
 
 	//Create .gam file from Game() object
-	if (core->WriteGame(Path)) {
+	if (core->WriteGame(tmpPath)) {
 		return false;
 	}
 
 	//Create .wmp file from WorldMap() object
-	if (core->WriteWorldMap(Path)) {
+	if (core->WriteWorldMap(tmpPath)) {
 		return false;
 	}
 
-	PluginHolder<ImageWriter> im = MakePluginHolder<ImageWriter>(PLUGIN_IMAGE_WRITER_BMP);
-	if (!im) {
+	job->imageWriter = MakePluginHolder<ImageWriter>(PLUGIN_IMAGE_WRITER_BMP);
+	if (!job->imageWriter) {
 		Log(ERROR, "SaveGameIterator", "Couldn't create the BMPWriter!");
 		return false;
 	}
@@ -439,13 +444,10 @@ static bool DoSaveGame(const path_t& Path, bool overrideRunning)
 		Holder<Sprite2D> portrait = actor->CopyPortrait(true);
 
 		if (portrait) {
-			path_t fname = fmt::format("PORTRT{}", i);
-			FileStream outfile;
-			outfile.Create(Path, fname, IE_BMP_CLASS_ID);
 			// NOTE: we save the true portrait size, even tho the preview buttons arent (always) the same
 			// we do this because: 1. the GUI should be able to use whatever size it wants
 			// and 2. its more appropriate to have a flag on the buttons to do the scaling/cropping
-			im->PutImage(&outfile, std::move(portrait));
+			job->images.emplace_back(fmt::format("PORTRT{}", i), std::move(portrait));
 		}
 	}
 
@@ -457,11 +459,9 @@ static bool DoSaveGame(const path_t& Path, bool overrideRunning)
 
 	// scale down to get more of the screen and reduce the size
 	preview = VideoDriver->SpriteScaleDown(preview, 5);
-	FileStream outfile;
-	outfile.Create( Path, core->GameNameResRef.c_str(), IE_BMP_CLASS_ID );
-	im->PutImage(&outfile, std::move(preview));
+	job->images.emplace_back(core->GameNameResRef.c_str(), std::move(preview));
 
-	return true;
+	return writer.Write(std::move(job), core->config.BackgroundSaving);
 }
 
 static EffectRef fx_disable_rest_ref = { "DisableRest", -1 };
@@ -561,7 +561,7 @@ static int CanSave()
 	return 0;
 }
 
-static bool CreateSavePath(path_t& path, int index, StringView slotname)
+static bool CreateSavePath(path_t& path, path_t& tmpPath, const path_t& replaced, int index, StringView slotname)
 {
 	path = PathJoin(core->config.SavePath, SaveDir());
 
@@ -573,16 +573,57 @@ static bool CreateSavePath(path_t& path, int index, StringView slotname)
 	//keep the first part we already determined existing
 
 	path_t dir = fmt::format("{:09d}-{}", index, slotname);
+	// the save is assembled in a hidden directory and only moved in place once complete
+	tmpPath = PathJoin(path, "." + dir);
 	path = PathJoin(path, dir);
 	//this is required in case the old slot wasn't recognised but still there
-	core->DelTree(path, false);
-	if (!MakeDirectory(path)) {
-		Log(ERROR, "SaveGameIterator", "Unable to create save game directory '{}'", path);
+	//the one we overwrite stays until the new save is complete
+	if (path != replaced) {
+		core->DelTree(path, false);
+		RemoveDirectory(path);
+	}
+	core->DelTree(tmpPath, false);
+	path_t backupPath = SaveGameWriter::BackupPath(tmpPath);
+	core->DelTree(backupPath, false);
+	RemoveDirectory(backupPath);
+	if (!MakeDirectory(tmpPath)) {
+		Log(ERROR, "SaveGameIterator", "Unable to create save game directory '{}'", tmpPath);
 		return false;
 	}
 	return true;
 }
 
+int SaveGameIterator::StartSave(const path_t& path, const path_t& tmpPath, const path_t& replaced, bool overrideRunning) const
+{
+	bool started = DoSaveGame(writer, path, tmpPath, replaced, overrideRunning);
+	// saves done right away report here, background ones once they are written
+	int status = FinishPendingSave();
+	if (!started && status == 0) {
+		// failed before anything was handed to the writer
+		core->DelTree(tmpPath, false);
+		RemoveDirectory(tmpPath);
+		displaymsg->DisplayMsgCentered(HCStrings::CantSave, FT_ANY, GUIColors::XPCHANGE);
+		return GEM_ERROR;
+	}
+	return status < 0 ? GEM_ERROR : GEM_OK;
+}
+
+int SaveGameIterator::FinishPendingSave(bool wait) const
+{
+	int status = wait ? writer.Wait() : writer.Poll();
+	if (status < 0) {
+		displaymsg->DisplayMsgCentered(HCStrings::CantSave, FT_ANY, GUIColors::XPCHANGE);
+	} else if (status > 0) {
+		// Save successful / Quick-save successful
+		if (pendingQuickSave) {
+			displaymsg->DisplayMsgCentered(HCStrings::QSaveSuccess, FT_ANY, GUIColors::XPCHANGE);
+		} else {
+			displaymsg->DisplayMsgCentered(HCStrings::SaveSuccess, FT_ANY, GUIColors::XPCHANGE);
+		}
+	}
+	return status;
+}
+
 int SaveGameIterator::CreateSaveGame(int index, bool mqs) const
 {
 	AutoTable tab = gamedata->LoadTable("savegame");
@@ -594,6 +635,9 @@ int SaveGameIterator::CreateSaveGame(int index, bool mqs) const
 		qsave = tab->QueryFieldSigned<int>(index, 1);
 	}
 
+	// the previous save has to be in place before slots are picked or pruned
+	FinishPendingSave(true);
+
 	if (mqs) {
 		assert(qsave);
 		PruneQuickSave(slotname);
@@ -603,6 +647,7 @@ int SaveGameIterator::CreateSaveGame(int index, bool mqs) const
 		return cansave;
 
 	bool overrideRunning = false;
+	path_t replaced;
 	//if index is not an existing savegame, we create a unique slotname
 	for (const auto& save : save_slots) {
 		if (save->GetSaveID() != index) continue;
@@ -614,27 +659,19 @@ int SaveGameIterator::CreateSaveGame(int index, bool mqs) const
 			}
 		}
 
-		DeleteSaveGame(save);
+		// the writer removes it once the new save is in place
+		replaced = save->GetPath();
 		break;
 	}
 	path_t Path;
-	if (!CreateSavePath(Path, index, slotname)) {
-		displaymsg->DisplayMsgCentered(HCStrings::CantSave, FT_ANY, GUIColors::XPCHANGE);
-		return GEM_ERROR;
-	}
-
-	if (!DoSaveGame(Path.c_str(), overrideRunning)) {
+	path_t tmpPath;
+	if (!CreateSavePath(Path, tmpPath, replaced, index, slotname)) {
 		displaymsg->DisplayMsgCentered(HCStrings::CantSave, FT_ANY, GUIColors::XPCHANGE);
 		return GEM_ERROR;
 	}
 
-	// Save successful / Quick-save successful
-	if (qsave) {
-		displaymsg->DisplayMsgCentered(HCStrings::QSaveSuccess, FT_ANY, GUIColors::XPCHANGE);
-	} else {
-		displaymsg->DisplayMsgCentered(HCStrings::SaveSuccess, FT_ANY, GUIColors::XPCHANGE);
-	}
-	return GEM_OK;
+	pendingQuickSave = qsave != 0;
+	return StartSave(Path, tmpPath, replaced, overrideRunning);
 }
 
 int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, const String& slotname, bool force) const {
@@ -648,6 +685,9 @@ int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, StringView slotname,
 		return GEM_ERROR;
 	}
 
+	// the previous save has to be in place before slots are picked
+	FinishPendingSave(true);
+
 	int cannotSave = CanSave();
 	if (cannotSave && !force) {
 		return cannotSave;
@@ -655,6 +695,7 @@ int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, StringView slotname,
 
 	int index;
 	bool overrideRunning = false;
+	path_t replaced;
 
 	if (save) {
 		index = save->GetSaveID();
@@ -666,7 +707,8 @@ int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, StringView slotname,
 			}
 		}
 
-		DeleteSaveGame(save);
+		// the writer removes it once the new save is in place
+		replaced = save->GetPath();
 		save.reset();
 	} else {
 		//leave space for autosaves
@@ -696,19 +738,14 @@ int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, StringView slotname,
 	}
 
 	path_t Path;
-	if (!CreateSavePath(Path, index, slotname)) {
-		displaymsg->DisplayMsgCentered(HCStrings::CantSave, FT_ANY, GUIColors::XPCHANGE);
-		return GEM_ERROR;
-	}
-
-	if (!DoSaveGame(Path.c_str(), overrideRunning)) {
+	path_t tmpPath;
+	if (!CreateSavePath(Path, tmpPath, replaced, index, slotname)) {
 		displaymsg->DisplayMsgCentered(HCStrings::CantSave, FT_ANY, GUIColors::XPCHANGE);
 		return GEM_ERROR;
 	}
 
-	// Save successful
-	displaymsg->DisplayMsgCentered(HCStrings::SaveSuccess, FT_ANY, GUIColors::XPCHANGE);
-	return GEM_OK;
+	pendingQuickSave = false;
+	return StartSave(Path, tmpPath, replaced, overrideRunning);
 }
 
 void SaveGameIterator::DeleteSaveGame(const Holder<SaveGame>& game) const
@@ -24,6 +24,7 @@
 #include "exports.h"
 
 #include "SaveGame.h"
+#include "SaveGameWriter.h"
 
 #include <vector>
 
@@ -35,6 +36,8 @@ class GEM_EXPORT SaveGameIterator {
 private:
 	using charlist = std::vector<Holder<SaveGame>>;
 	charlist save_slots;
+	mutable SaveGameWriter writer;
+	mutable bool pendingQuickSave = false;
 
 public:
 	SaveGameIterator() noexcept = default;
@@ -45,10 +48,18 @@ public:
 	int CreateSaveGame(Holder<SaveGame>, StringView slotname, bool force = false) const;
 	int CreateSaveGame(int index, bool mqs = false) const;
 	Holder<SaveGame> GetSaveGame(const String& slotname);
+	/**
+	 * Reports the outcome of the last save once it is written, blocking
+	 * for it if wait is set. Returns 0 if there was nothing to report,
+	 * otherwise like SaveGameWriter::Poll.
+	 */
+	int FinishPendingSave(bool wait = false) const;
+	SaveGameWriter::Progress GetSaveProgress() const { return writer.GetProgress(); }
 private:
 	bool RescanSaveGames();
 	static Holder<SaveGame> BuildSaveGame(std::string slotname);
 	void PruneQuickSave(StringView folder) const;
+	int StartSave(const path_t& path, const path_t& tmpPath, const path_t& replaced, bool overrideRunning) const;
 };
 
 }
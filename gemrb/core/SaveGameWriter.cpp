@@ -0,0 +1,171 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "SaveGameWriter.h"
+
+#include "Interface.h"
+#include "ThreadPool.h"
+#include "Logging/Logging.h"
+#include "Streams/FileStream.h"
+#include "System/VFS.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace GemRB {
+
+SaveGameWriter::SaveGameWriter() noexcept = default;
+
+SaveGameWriter::~SaveGameWriter()
+{
+	// never leave a save half written, even when quitting
+	if (result.valid()) {
+		result.wait();
+	}
+}
+
+bool SaveGameWriter::Write(std::unique_ptr<Job> newJob, bool background)
+{
+	// saves are written one after the other
+	Wait();
+
+	job = std::move(newJob);
+	done = 0;
+	total = job->files.size() + job->images.size();
+
+	if (!background) {
+		succeeded = Run(*job);
+		return succeeded;
+	}
+
+	if (!worker) {
+		worker = std::make_unique<ThreadPool>(1);
+	}
+	Job* current = job.get();
+	result = worker->Submit([this, current]() {
+		succeeded = Run(*current);
+	});
+	return true;
+}
+
+int SaveGameWriter::Wait()
+{
+	if (!job) return 0;
+
+	if (result.valid()) {
+		result.wait();
+	}
+	return Complete() ? 1 : -1;
+}
+
+int SaveGameWriter::Poll()
+{
+	if (!job) return 0;
+
+	if (result.valid() && result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return 0;
+	}
+	return Complete() ? 1 : -1;
+}
+
+SaveGameWriter::Progress SaveGameWriter::GetProgress() const
+{
+	Progress progress;
+	progress.pending = job != nullptr;
+	progress.done = done;
+	progress.total = total;
+	return progress;
+}
+
+bool SaveGameWriter::Run(Job& saveJob)
+{
+	tick_t startTime = GetMilliseconds();
+	{
+		FileStream str;
+		if (!str.Create(saveJob.tmpPath, saveJob.savName, IE_SAV_CLASS_ID)) {
+			Log(ERROR, "SaveGameWriter", "Cannot create the save archive in '{}'.", saveJob.tmpPath);
+			return false;
+		}
+		saveJob.archiver->CreateArchive(&str);
+
+		if (saveJob.retained && saveJob.retained->copyRetainedAREs(saveJob.retainedSource.get(), &str) == GEM_ERROR) {
+			Log(ERROR, "SaveGameWriter", "Failed to copy ARE files into new save game.");
+			return false;
+		}
+
+		for (const auto& file : saveJob.files) {
+			if (file.compressed) {
+				saveJob.blobOffset = str.GetPos();
+				saveJob.blobWritten = true;
+				saveJob.archiver->AddToSaveGameCompressed(&str, file.stream.get());
+			} else {
+				saveJob.archiver->AddToSaveGame(&str, file.stream.get());
+			}
+			++done;
+		}
+	}
+	Log(WARNING, "Core", "{} ms (compressing SAV file)", GetMilliseconds() - startTime);
+
+	for (const auto& image : saveJob.images) {
+		FileStream outfile;
+		outfile.Create(saveJob.tmpPath, image.first, IE_BMP_CLASS_ID);
+		// pass a copy, our reference keeps the sprite alive until the main thread drops it
+		saveJob.imageWriter->PutImage(&outfile, image.second);
+		++done;
+	}
+
+	// everything is in place, move the old slot aside and make the save visible in one go
+	path_t backupPath = BackupPath(saveJob.tmpPath);
+	bool hasOld = !saveJob.replaced.empty() && DirExists(saveJob.replaced);
+	if (hasOld && rename(saveJob.replaced.c_str(), backupPath.c_str())) {
+		Log(ERROR, "SaveGameWriter", "Cannot move the overwritten save '{}' aside.", saveJob.replaced);
+		return false;
+	}
+	if (rename(saveJob.tmpPath.c_str(), saveJob.path.c_str())) {
+		Log(ERROR, "SaveGameWriter", "Cannot move the finished save to '{}'.", saveJob.path);
+		if (hasOld && rename(backupPath.c_str(), saveJob.replaced.c_str())) {
+			Log(ERROR, "SaveGameWriter", "Cannot restore the overwritten save, it is left in '{}'.", backupPath);
+		}
+		return false;
+	}
+	if (hasOld) {
+		core->DelTree(backupPath, false);
+		RemoveDirectory(backupPath);
+	}
+	return true;
+}
+
+bool SaveGameWriter::Complete()
+{
+	result = std::future<void>();
+	bool ok = succeeded;
+
+	if (ok && job->blobWritten) {
+		core->saveGameAREExtractor.updateSaveGame(job->blobOffset);
+	} else if (!ok) {
+		core->DelTree(job->tmpPath, false);
+		RemoveDirectory(job->tmpPath);
+	}
+
+	// the sprites and streams go away on the main thread
+	job.reset();
+	return ok;
+}
+
+}
@@ -0,0 +1,121 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SAVEGAMEWRITER_H
+#define SAVEGAMEWRITER_H
+
+#include "exports.h"
+
+#include "ArchiveImporter.h"
+#include "ImageWriter.h"
+#include "SaveGameAREExtractor.h"
+#include "Sprite2D.h"
+#include "Streams/DataStream.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+class ThreadPool;
+
+/**
+ * Finishes saves, optionally on a worker thread. The main thread takes a
+ * snapshot first: the cache is read into memory and the images are prepared.
+ * The writer then compresses the .sav and writes everything into a hidden
+ * directory, which is renamed into place once complete, so a half written
+ * save never shows up in the save list. An overwritten slot is only removed
+ * then too, so a failed save leaves the old one intact.
+ */
+class GEM_EXPORT SaveGameWriter {
+public:
+	struct File {
+		std::unique_ptr<DataStream> stream;
+		bool compressed = false; // stored as is, eg. the areas of the overwritten running save
+	};
+
+	/** Everything needed to finish a save without touching the game */
+	struct Job {
+		path_t path; // the final slot directory
+		path_t tmpPath; // where the save is assembled
+		path_t replaced; // the slot directory this save overwrites, if any
+		path_t savName;
+		PluginHolder<ArchiveImporter> archiver;
+		// areas still inside the running save, copied over compressed
+		std::unique_ptr<SaveGameAREExtractor> retained;
+		std::unique_ptr<DataStream> retainedSource;
+		// cache contents in the order they go into the .sav
+		std::vector<File> files;
+		PluginHolder<ImageWriter> imageWriter;
+		std::vector<std::pair<path_t, Holder<Sprite2D>>> images;
+
+		// where the precompressed areas ended up, for the area extractor
+		bool blobWritten = false;
+		strpos_t blobOffset = 0;
+	};
+
+	struct Progress {
+		bool pending = false;
+		size_t done = 0; // written files
+		size_t total = 0;
+	};
+
+	SaveGameWriter() noexcept;
+	SaveGameWriter(const SaveGameWriter&) = delete;
+	~SaveGameWriter();
+	SaveGameWriter& operator=(const SaveGameWriter&) = delete;
+
+	/**
+	 * Finishes the job, either right away or in the background, after
+	 * waiting for the previous one. Either way the outcome is reported by
+	 * Poll or Wait, the return value only tells if a save done right away
+	 * succeeded.
+	 */
+	bool Write(std::unique_ptr<Job> job, bool background);
+	/** Blocks until the save is done, then reports like Poll */
+	int Wait();
+	/**
+	 * Main thread: returns 1 if a save completed since the last call, -1 if
+	 * it failed and 0 if there is nothing (yet) to report.
+	 */
+	int Poll();
+	bool Pending() const { return job != nullptr; }
+	Progress GetProgress() const;
+	/** Where the overwritten slot waits while the new save is moved in place */
+	static path_t BackupPath(const path_t& tmpPath) { return tmpPath + ".old"; }
+
+private:
+	std::unique_ptr<ThreadPool> worker;
+	std::unique_ptr<Job> job;
+	std::future<void> result;
+	std::atomic_bool succeeded {false};
+	std::atomic<size_t> done {0};
+	size_t total = 0;
+
+	bool Run(Job& job);
+	// main thread, hands the results back to the game
+	bool Complete();
+};
+
+}
+
+#endif
@@ -2810,6 +2810,7 @@ void Actor::RefreshEffects(bool first, const stats_t& previous)
 	if (Immobile()) {
 		timeStartStep = game->Ticks;
 	}
+	CacheStats();
 }
 
 void Actor::RefreshEffects()
@@ -2818,6 +2819,79 @@ void Actor::RefreshEffects()
 	RefreshEffects(first, ResetStats(first));
 }
 
+// remember until when this rebuild stays valid, if it can be reused at all
+void Actor::CacheStats()
+{
+	statCache.stableUntil = 0;
+	// party members have fatigue, portrait icons and more ticking along
+	if (InParty || Timers.checkHP || Modified[IE_PUPPETID] || Immobile()) {
+		return;
+	}
+
+	ieDword stableUntil = fxqueue.StableUntil();
+	if (!stableUntil) {
+		return;
+	}
+
+	// morale recovery and constitution regeneration happen at fixed intervals
+	ieDword gameTime = core->GetGame()->GameTime;
+	if (HasPlayerClass()) {
+		int mrec = GetStat(IE_MORALERECOVERYTIME);
+		if (mrec && ShouldModifyMorale()) {
+			stableUntil = std::min(stableUntil, ieDword(gameTime / mrec + 1) * mrec);
+		}
+		int rate = GetConHealAmount();
+		if (rate) {
+			stableUntil = std::min(stableUntil, ieDword(gameTime / rate + 1) * rate);
+		}
+	}
+
+	statCache.stableUntil = stableUntil;
+	statCache.effects = fxqueue.Fingerprint();
+	statCache.inventory = inventory.Fingerprint();
+	statCache.base = BaseStats;
+	statCache.modified = Modified;
+}
+
+bool Actor::StatsStale() const
+{
+	if (!statCache.stableUntil || core->GetGame()->GameTime >= statCache.stableUntil) {
+		return true;
+	}
+	if (InParty || Timers.checkHP || Immobile()) {
+		return true;
+	}
+	for (const auto& trigger : triggers) {
+		if (!(trigger.flags & TEF_PROCESSED_EFFECTS)) return true;
+	}
+	// anything writing stats directly expects the next refresh to reconcile them
+	if (BaseStats != statCache.base || Modified != statCache.modified) {
+		return true;
+	}
+	return fxqueue.Fingerprint() != statCache.effects || inventory.Fingerprint() != statCache.inventory;
+}
+
+void Actor::UpdateEffects()
+{
+	int mode = core->config.IncrementalStats;
+	if (!mode || StatsStale()) {
+		RefreshEffects();
+		return;
+	}
+	if (mode == 1) {
+		return;
+	}
+
+	// validation mode: rebuild anyway and report where skipping would have been wrong
+	stats_t incremental = Modified;
+	RefreshEffects();
+	for (int i = 0; i < MAX_STATS; ++i) {
+		if (incremental[i] != Modified[i]) {
+			Log(WARNING, "Actor", "Incremental stats of {} are stale: stat {} is {}, the rebuild gives {}", fmt::WideToChar{GetName()}, i, incremental[i], Modified[i]);
+		}
+	}
+}
+
 int Actor::GetProficiency(ieByte proftype) const
 {
 	switch(proftype) {
@@ -5388,6 +5462,7 @@ void Actor::Die(Scriptable *killer, bool grantXP)
 
 	if (InParty && killerPC) {
 		UpdateOrCreateVariable(game->locals, "PM_KILLED", 1);
+		game->StateChanged();
 	}
 
 	// EXTRACOUNT is updated at the moment of death
@@ -5558,6 +5633,7 @@ bool Actor::CheckOnDeath()
 		}
 		j += j;
 	}
+	game->StateChanged();
 
 	if (disintegrated) return true;
 
@@ -7840,7 +7916,7 @@ void Actor::NewPath()
 		return;
 	}
 	WalkTo(savedDest, InternalFlags, pathfindingDistance);
-	if (!GetPath()) {
+	if (!GetPath() && !HasPendingPath()) {
 		IncrementPathTries();
 	}
 }
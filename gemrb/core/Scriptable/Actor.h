@@ -549,6 +549,15 @@ private:
 	// true when command has been played after select
 	bool playedCommandSound = false;
 
+	// what the last full RefreshEffects depended on, so unchanged actors can skip it
+	struct {
+		ieDword stableUntil = 0; // game time, 0 if the result can't be reused
+		size_t effects = 0; // EffectQueue::Fingerprint
+		size_t inventory = 0; // Inventory::Fingerprint
+		stats_t base {};
+		stats_t modified {};
+	} statCache;
+
 	//trap we're trying to disarm
 	ieDword disarmTrap = 0;
 	ieDword InTrap = 0;
@@ -607,6 +616,8 @@ private:
 
 	stats_t ResetStats(bool init);
 	void RefreshEffects(bool init, const stats_t& prev);
+	void CacheStats();
+	bool StatsStale() const;
 
 public:
 	Actor(void);
@@ -635,6 +646,8 @@ public:
 	void CheckPuppet(Actor *puppet, ieDword type);
 	/** Re/Inits the Modified vector */
 	void RefreshEffects();
+	/** Per tick refresh, skips the rebuild if nothing it depends on changed (see IncrementalStats) */
+	void UpdateEffects();
 	void AddEffects(EffectQueue&& eqfx);
 	/** gets saving throws */
 	void RollSaves();
@@ -101,6 +101,11 @@ void Door::UpdateDoor()
 		ImpedeBlocks(open_ib, PathMapFlags::IMPASSABLE);
 		ImpedeBlocks(closed_ib, pmdflags);
 	}
+	std::vector<SearchmapPoint> changed = open_ib;
+	changed.insert(changed.end(), closed_ib.begin(), closed_ib.end());
+	area->UpdatePathClusters(changed);
+	// doors block line of sight too
+	area->InvalidateVision();
 
 	InfoPoint *ip = area->TMap->GetInfoPoint(LinkedInfo);
 	if (ip) {
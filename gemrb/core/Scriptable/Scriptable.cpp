@@ -56,9 +56,12 @@ static const unsigned short ClearActionsID = 133; // same for all games
  ***********************/
 Scriptable::Scriptable(ScriptableType type)
 {
-	startActive = core->HasFeature(GFFlags::START_ACTIVE);
-	third = core->HasFeature(GFFlags::RULES_3ED);
-	pst_flags = core->HasFeature(GFFlags::PST_STATE_FLAGS);
+	// there's no core in unit tests
+	if (core) {
+		startActive = core->HasFeature(GFFlags::START_ACTIVE);
+		third = core->HasFeature(GFFlags::RULES_3ED);
+		pst_flags = core->HasFeature(GFFlags::PST_STATE_FLAGS);
+	}
 
 	globalID = ++globalActorCounter;
 	if (globalActorCounter == 0) {
@@ -1681,15 +1684,19 @@ void Selectable::DrawCircle(const Point& p) const
 // Check if P is over our ground circle
 bool Selectable::IsOver(const Point &P) const
 {
-	int csize = circleSize;
-	if (csize < 2) {
-		Point d = P - Pos;
+	return CircleContains(Pos, circleSize, P);
+}
+
+bool Selectable::CircleContains(const Point& center, int circleSize, const Point& p)
+{
+	if (circleSize < 2) {
+		Point d = p - center;
 		if (d.x < -16 || d.x > 16) return false;
 		if (d.y < -12 || d.y > 12) return false;
 		return true;
 	}
 	// TODO: make sure to match the actual blocking shape; use GetEllipseSize/GetEllipseOffset instead?
-	return P.IsWithinEllipse(csize - 1, Pos);
+	return p.IsWithinEllipse(circleSize - 1, center);
 }
 
 bool Selectable::IsSelected() const
@@ -1715,6 +1722,10 @@ void Selectable::SetCircle(int circlesize, float_t factor, const Color &color, H
 {
 	circleSize = circlesize;
 	sizeFactor = factor;
+	const Actor* actor = As<Actor>();
+	if (actor && area) {
+		area->ActorMoved(actor);
+	}
 	selectedColor = color;
 	overColor.r = color.r >> 1;
 	overColor.g = color.g >> 1;
@@ -2235,6 +2246,9 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 	Pos.x += dx;
 	Pos.y += dy;
 	oldPos = Pos;
+	if (actor) {
+		area->ActorMoved(actor);
+	}
 	if (actor && blocksSearch) {
 		auto flag = actor->IsPartyMember() ? PathMapFlags::PC : PathMapFlags::NPC;
 		area->tileProps.PaintSearchMap(Map::ConvertCoordToTile(Pos), circleSize, flag);
@@ -2312,11 +2326,40 @@ void Movable::WalkTo(const Point &Des, int distance)
 		return;
 	}
 
-	if (BlocksSearchMap()) area->ClearSearchMapFor(this);
-	PathListNode* newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT | PF_ACTORS_ARE_BLOCKING, actor);
-	if (!newPath && actor && actor->ValidTarget(GA_CAN_BUMP)) {
-		Log(DEBUG, "WalkTo", "{} re-pathing ignoring actors", fmt::WideToChar{actor->GetShortName()});
-		newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT, actor);
+	PathListNode* newPath = nullptr;
+	if (core->config.AsyncPathfinding) {
+		// the search runs in the background and is answered on the next tick,
+		// a pending one only fits if it was asked the same question
+		if (pathRequest) {
+			const PathQuery& query = pathRequest->Query();
+			if (query.target != Des || query.minDistance != unsigned(distance) || query.size != unsigned(circleSize)) {
+				pathRequest.reset();
+			}
+		}
+		if (!pathRequest) {
+			pathRequest = area->RequestPath(Pos, Des, circleSize, distance, PF_SIGHT | PF_ACTORS_ARE_BLOCKING, actor);
+		}
+		if (!pathRequest->Done()) {
+			return;
+		}
+		newPath = pathRequest->TakePath();
+		bool actorsWereBlocking = pathRequest->Query().flags & PF_ACTORS_ARE_BLOCKING;
+		pathRequest.reset();
+		if (!newPath && actorsWereBlocking && actor && actor->ValidTarget(GA_CAN_BUMP)) {
+			Log(DEBUG, "WalkTo", "{} re-pathing ignoring actors", fmt::WideToChar{actor->GetShortName()});
+			pathRequest = area->RequestPath(Pos, Des, circleSize, distance, PF_SIGHT, actor);
+			return;
+		}
+		if (newPath && BlocksSearchMap()) {
+			area->ClearSearchMapFor(this);
+		}
+	} else {
+		if (BlocksSearchMap()) area->ClearSearchMapFor(this);
+		newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT | PF_ACTORS_ARE_BLOCKING, actor);
+		if (!newPath && actor && actor->ValidTarget(GA_CAN_BUMP)) {
+			Log(DEBUG, "WalkTo", "{} re-pathing ignoring actors", fmt::WideToChar{actor->GetShortName()});
+			newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT, actor);
+		}
 	}
 
 	if (newPath) {
@@ -2332,6 +2375,14 @@ void Movable::WalkTo(const Point &Des, int distance)
 	}
 }
 
+void Movable::CollectPath()
+{
+	if (pathRequest && pathRequest->Done()) {
+		const PathQuery& query = pathRequest->Query();
+		WalkTo(query.target, query.minDistance);
+	}
+}
+
 void Movable::RunAwayFrom(const Point &Source, int PathLength, bool noBackAway)
 {
 	ClearPath(true);
@@ -2417,6 +2468,10 @@ void Movable::MoveTo(const Point &Des)
 	Pos = Des;
 	oldPos = Des;
 	Destination = Des;
+	const Actor* actor = As<Actor>();
+	if (actor) {
+		area->ActorMoved(actor);
+	}
 	if (BlocksSearchMap()) {
 		area->BlockSearchMapFor(this);
 	}
@@ -2443,6 +2498,7 @@ void Movable::ClearPath(bool resetDestination)
 		}
 		HandleAnkhegStance(true);
 		InternalFlags &= ~IF_NORETICLE;
+		pathRequest.reset();
 	}
 	PathListNode* thisNode = path;
 	while (thisNode) {
@@ -47,6 +47,7 @@ class Map;
 class Movable;
 class Object;
 struct PathListNode;
+class PathRequest;
 class Projectile;
 class Scriptable;
 class Selectable;
@@ -441,6 +442,8 @@ public:
 	void SetBBox(const Region &newBBox);
 	void DrawCircle(const Point& p) const;
 	bool IsOver(const Point &Pos) const;
+	// IsOver for a circle of circleSize at center
+	static bool CircleContains(const Point& center, int circleSize, const Point& p);
 	void SetOver(bool over);
 	bool IsSelected() const;
 	void Select(int Value);
@@ -499,6 +502,7 @@ private: //these seem to be sensitive, so get protection
 
 	PathListNode* path = nullptr; // whole path
 	PathListNode* step = nullptr; // actual step
+	std::shared_ptr<PathRequest> pathRequest; // a path being searched for WalkTo
 	unsigned int prevTicks = 0;
 	int bumpBackTries = 0;
 	bool pathAbandoned = false;
@@ -538,6 +542,10 @@ public:
 	inline bool IsBumped() const { return bumped; }
 	PathListNode *GetNextStep(int x) const;
 	inline PathListNode *GetPath() const { return path; };
+	/** an async search for WalkTo hasn't been picked up yet, so the walk is still on */
+	inline bool HasPendingPath() const { return pathRequest != nullptr; }
+	/** starts walking a finished async search, for walks nobody repeats WalkTo for */
+	void CollectPath();
 	inline int GetPathTries() const	{ return pathTries; }
 	inline void IncrementPathTries() { pathTries++; }
 	inline void ResetPathTries() { pathTries = 0; }
@@ -0,0 +1,195 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "Region.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * Buckets objects into square cells by position, so area queries only need
+ * to look at the objects near the queried region instead of all of them.
+ * Queries return candidates (everything in the touched cells), the caller
+ * still has to do the exact range check. Candidates come back in insertion
+ * order, so callers iterating a parallel list keep their old semantics.
+ * Buckets are kept in that order too, so single cell queries need no sorting.
+ */
+template <typename T>
+class SpatialGrid {
+public:
+	explicit SpatialGrid(int cellSize = 128) : cellSize(cellSize) {}
+
+	void Insert(T* obj, const Point& pos)
+	{
+		if (entries.count(obj)) {
+			Move(obj, pos);
+			return;
+		}
+		Entry entry { CellKey(pos), nextSeq++ };
+		entries.emplace(obj, entry);
+		// the newest always goes last
+		cells[entry.cell].push_back(Slot { entry.seq, obj });
+	}
+
+	/** Cheap if the object stays in its cell; ignores unknown objects */
+	void Move(const T* obj, const Point& pos)
+	{
+		auto it = entries.find(const_cast<T*>(obj));
+		if (it == entries.end()) return;
+		uint64_t cell = CellKey(pos);
+		if (cell == it->second.cell) return;
+		Unlink(it->first, it->second.cell);
+		it->second.cell = cell;
+		auto& bucket = cells[cell];
+		Slot slot { it->second.seq, it->first };
+		bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), slot, BySeq), slot);
+	}
+
+	void Remove(const T* obj)
+	{
+		auto it = entries.find(const_cast<T*>(obj));
+		if (it == entries.end()) return;
+		Unlink(it->first, it->second.cell);
+		entries.erase(it);
+	}
+
+	void Clear()
+	{
+		entries.clear();
+		cells.clear();
+	}
+
+	size_t Size() const { return entries.size(); }
+
+	/** All objects in cells overlapping rgn, in insertion order */
+	std::vector<T*> Query(const Region& rgn) const
+	{
+		// reused, so a query only allocates its result
+		static thread_local std::vector<Slot> found;
+		found.clear();
+		size_t touched = 0;
+		int minX = CellCoord(rgn.x);
+		int maxX = CellCoord(rgn.x + rgn.w);
+		int minY = CellCoord(rgn.y);
+		int maxY = CellCoord(rgn.y + rgn.h);
+		auto collect = [&](const std::vector<Slot>& bucket) {
+			found.insert(found.end(), bucket.begin(), bucket.end());
+			++touched;
+		};
+
+		int64_t span = int64_t(maxX - minX + 1) * (maxY - minY + 1);
+		if (span > int64_t(cells.size())) {
+			// huge region, walking the occupied cells is cheaper than probing empty ones
+			for (const auto& cell : cells) {
+				int cx = int32_t(cell.first >> 32);
+				int cy = int32_t(cell.first & 0xffffffff);
+				if (cx < minX || cx > maxX || cy < minY || cy > maxY) continue;
+				collect(cell.second);
+			}
+		} else {
+			for (int cy = minY; cy <= maxY; ++cy) {
+				for (int cx = minX; cx <= maxX; ++cx) {
+					auto cell = cells.find(MakeKey(cx, cy));
+					if (cell == cells.end()) continue;
+					collect(cell->second);
+				}
+			}
+		}
+		if (touched > 1) {
+			std::sort(found.begin(), found.end(), BySeq);
+		}
+
+		std::vector<T*> result;
+		result.reserve(found.size());
+		for (const auto& slot : found) {
+			result.push_back(slot.obj);
+		}
+		return result;
+	}
+
+	/** Candidates within radius pixels of p (a square, so still a superset) */
+	std::vector<T*> Query(const Point& p, unsigned int radius) const
+	{
+		// keep the region representable, anything this big covers whole maps anyway
+		int r = static_cast<int>(std::min<unsigned int>(radius, 1 << 24));
+		return Query(Region(p.x - r, p.y - r, r * 2, r * 2));
+	}
+
+private:
+	struct Entry {
+		uint64_t cell;
+		uint64_t seq;
+	};
+
+	// the sequence number travels along, so queries don't have to look it up
+	struct Slot {
+		uint64_t seq;
+		T* obj;
+	};
+
+	static bool BySeq(const Slot& a, const Slot& b) { return a.seq < b.seq; }
+
+	int cellSize;
+	uint64_t nextSeq = 0;
+	std::unordered_map<T*, Entry> entries;
+	std::unordered_map<uint64_t, std::vector<Slot>> cells;
+
+	int CellCoord(int v) const
+	{
+		// round towards negative infinity, positions can be slightly off map
+		return v >= 0 ? v / cellSize : (v - cellSize + 1) / cellSize;
+	}
+
+	static uint64_t MakeKey(int cx, int cy)
+	{
+		return (uint64_t(uint32_t(cx)) << 32) | uint32_t(cy);
+	}
+
+	uint64_t CellKey(const Point& pos) const
+	{
+		return MakeKey(CellCoord(pos.x), CellCoord(pos.y));
+	}
+
+	void Unlink(T* obj, uint64_t cellKey)
+	{
+		auto cell = cells.find(cellKey);
+		if (cell == cells.end()) return;
+		auto& bucket = cell->second;
+		auto it = std::find_if(bucket.begin(), bucket.end(), [obj](const Slot& slot) { return slot.obj == obj; });
+		if (it != bucket.end()) {
+			// keep the order
+			bucket.erase(it);
+		}
+		if (bucket.empty()) {
+			cells.erase(cell);
+		}
+	}
+};
+
+}
+
+#endif
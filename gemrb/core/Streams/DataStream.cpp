@@ -136,6 +136,30 @@ strret_t DataStream::ReadLine(std::string& buf, strpos_t maxlen)
 	buf.reserve(maxlen);
 	strpos_t i = 0;
 
+	// scan memory streams in place rather than one virtual call per character
+	const char* raw = RawData();
+	if (raw) {
+		strpos_t end = Pos;
+		while (end < size && i < (maxlen - 1)) {
+			char ch = raw[end++];
+			++i;
+
+			if (ch == '\r') {
+				if (end < size && raw[end] == '\n') {
+					++end;
+					++i;
+				}
+				break;
+			} else if (ch == '\n') {
+				break;
+			}
+
+			buf.push_back(ch == '\t' ? ' ' : ch);
+		}
+		Seek(end, GEM_STREAM_START);
+		return i;
+	}
+
 	while (Pos < size && i < (maxlen - 1)) {
 		char ch;
 		i += Read(&ch, 1);
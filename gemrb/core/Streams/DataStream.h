@@ -192,6 +192,8 @@ public:
 	 *  Returns NULL on failure.
 	 **/
 	virtual DataStream* Clone() const noexcept;
+	/** Returns the whole stream if it is in memory and needs no decrypting, else nullptr */
+	virtual const char* RawData() const noexcept { return nullptr; }
 
 	void SetBigEndianness(bool) noexcept;
 protected:
@@ -203,6 +205,8 @@ protected:
 	void ReadDecrypted(void* buf, strpos_t encSize) const;
 private:
 	bool NeedEndianSwap() const noexcept;
+
+	friend class SpanReader;
 };
 
 }
@@ -27,9 +27,97 @@
 #include "Streams/MappedFileMemoryStream.h"
 #endif
 #include "System/VFS.h"
+#include "ThreadPool.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace GemRB {
 
+// jobs producing cache files, by file name; the once flag makes sure
+// only one of the worker and a waiting thread runs the work
+struct CacheJob {
+	std::once_flag once;
+	std::function<void()> work;
+};
+
+static std::mutex cacheJobsLock;
+static std::unordered_map<path_t, std::shared_ptr<CacheJob>> cacheJobs;
+
+static void RunCacheJob(const path_t& fname, const std::shared_ptr<CacheJob>& job)
+{
+	std::call_once(job->once, job->work);
+
+	std::lock_guard<std::mutex> lk(cacheJobsLock);
+	const auto it = cacheJobs.find(fname);
+	if (it != cacheJobs.end() && it->second == job) {
+		cacheJobs.erase(it);
+	}
+}
+
+void CacheInBackground(const path_t& fname, std::function<void()> work)
+{
+	ThreadPool* pool = core->GetWorkerPool();
+	if (!pool) {
+		work();
+		return;
+	}
+
+	auto job = std::make_shared<CacheJob>();
+	job->work = std::move(work);
+	{
+		std::lock_guard<std::mutex> lk(cacheJobsLock);
+		if (!cacheJobs.emplace(fname, job).second) {
+			return;
+		}
+	}
+	pool->Submit([fname, job]() {
+		RunCacheJob(fname, job);
+	});
+}
+
+void WaitForCacheFile(const path_t& fname)
+{
+	std::shared_ptr<CacheJob> job;
+	{
+		std::lock_guard<std::mutex> lk(cacheJobsLock);
+		const auto it = cacheJobs.find(fname);
+		if (it == cacheJobs.end()) {
+			return;
+		}
+		job = it->second;
+	}
+	RunCacheJob(fname, job);
+}
+
+bool CacheJobsCancelled()
+{
+	const ThreadPool* pool = core->GetWorkerPool();
+	return pool && pool->Stopping();
+}
+
+path_t TempCachePath(const path_t& path)
+{
+	return path + ".part";
+}
+
+bool CommitCacheFile(const path_t& path)
+{
+	path_t tmpPath = TempCachePath(path);
+	// rename doesn't replace existing files everywhere
+	if (FileExists(path)) {
+		UnlinkFile(path);
+	}
+	if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+		Log(ERROR, "FileCache", "Cannot rename {} to {}.", tmpPath, path);
+		UnlinkFile(tmpPath);
+		return false;
+	}
+	return true;
+}
+
 DataStream* CacheCompressedStream(DataStream *stream, const path_t& filename, int length, bool overwrite)
 {
 	path_t fname = ExtractFileFromPath(filename);
@@ -37,14 +125,21 @@ DataStream* CacheCompressedStream(DataStream *stream, const path_t& filename, in
 
 	if (overwrite || !FileExists(path)) {
 		FileStream out;
-		if (!out.Create(path)) {
+		if (!out.Create(TempCachePath(path))) {
 			Log(ERROR, "FileCache", "Cannot write {}.", path);
 			return NULL;
 		}
 
 		PluginHolder<Compressor> comp = MakePluginHolder<Compressor>(PLUGIN_COMPRESSION_ZLIB);
-		if (comp->Decompress(&out, stream, length) != GEM_OK)
+		if (comp->Decompress(&out, stream, length) != GEM_OK) {
+			out.Close();
+			UnlinkFile(TempCachePath(path));
+			return NULL;
+		}
+		out.Close();
+		if (!CommitCacheFile(path)) {
 			return NULL;
+		}
 	} else {
 		stream->Seek(length, GEM_CURRENT_POS);
 	}
@@ -21,10 +21,26 @@
 
 #include "Streams/DataStream.h"
 
+#include <functional>
+
 namespace GemRB {
 
 GEM_EXPORT DataStream* CacheCompressedStream(DataStream *stream, const path_t& filename, int length = 0, bool overwrite = false);
 
+/** Cache files are written under this name first, so a partial file is never picked up */
+GEM_EXPORT path_t TempCachePath(const path_t& path);
+/** Publishes the file written to TempCachePath(path) as path */
+GEM_EXPORT bool CommitCacheFile(const path_t& path);
+
+/**
+ * Runs work on the worker pool, it is expected to produce the cache file fname.
+ * Until it is done, WaitForCacheFile blocks on it or runs it itself if it didn't start yet.
+ */
+GEM_EXPORT void CacheInBackground(const path_t& fname, std::function<void()> work);
+GEM_EXPORT void WaitForCacheFile(const path_t& fname);
+/** Long running background cache jobs should poll this and give up when set */
+GEM_EXPORT bool CacheJobsCancelled();
+
 }
 
 #endif
@@ -62,6 +62,11 @@ strret_t MemoryStream::Read(void* dest, strpos_t length)
 	return length;
 }
 
+const char* MemoryStream::RawData() const noexcept
+{
+	return Encrypted ? nullptr : data;
+}
+
 strret_t MemoryStream::Write(const void* src, strpos_t length)
 {
 	if (Pos+length>size ) {
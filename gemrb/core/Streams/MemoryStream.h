@@ -39,6 +39,7 @@ public:
 	strret_t Read(void* dest, strpos_t length) override;
 	strret_t Write(const void* src, strpos_t length) override;
 	strret_t Seek(stroff_t pos, strpos_t startpos) override;
+	const char* RawData() const noexcept override;
 };
 
 }
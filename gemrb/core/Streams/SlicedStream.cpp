@@ -69,6 +69,12 @@ strret_t SlicedStream::Read(void* dest, strpos_t length)
 	return c;
 }
 
+const char* SlicedStream::RawData() const noexcept
+{
+	const char* raw = Encrypted ? nullptr : str->RawData();
+	return raw ? raw + startpos : nullptr;
+}
+
 strret_t SlicedStream::Write(const void* /*src*/, strpos_t /*length*/)
 {
 	error("SlicedStream", "Attempted to use unimplemented SlicedStream::Write method!");
@@ -41,6 +41,7 @@ public:
 	strret_t Read(void* dest, strpos_t length) override;
 	strret_t Write(const void* src, strpos_t length) override;
 	stroff_t Seek(stroff_t pos, strpos_t startpos) override;
+	const char* RawData() const noexcept override;
 };
 
 GEM_EXPORT DataStream* SliceStream(DataStream* str, strpos_t startpos, strpos_t size, bool preservepos = false);
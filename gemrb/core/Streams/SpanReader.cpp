@@ -0,0 +1,91 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "SpanReader.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+SpanReader::SpanReader(DataStream* stream, strpos_t length)
+{
+	length = std::min(length, stream->Remains());
+	swap = stream->NeedEndianSwap();
+
+	const char* raw = stream->RawData();
+	if (raw) {
+		data = raw + stream->GetPos();
+		stream->Seek(length, GEM_CURRENT_POS);
+	} else {
+		buffer.resize(length);
+		if (stream->Read(buffer.data(), length) == DataStream::Error) {
+			length = 0;
+		}
+		data = buffer.data();
+	}
+	size = length;
+}
+
+stroff_t SpanReader::Seek(stroff_t offset, strpos_t startpos)
+{
+	strpos_t newPos;
+	switch (startpos) {
+		case GEM_CURRENT_POS:
+			newPos = pos + offset;
+			break;
+		case GEM_STREAM_START:
+			newPos = offset;
+			break;
+		default:
+			return DataStream::Error;
+	}
+	if (newPos > size) {
+		return DataStream::Error;
+	}
+	pos = newPos;
+	return 0;
+}
+
+strret_t SpanReader::ReadPoint(Point& p)
+{
+	// in the data files Points are 16bit per coord as opposed to our 32ish
+	strret_t ret = ReadScalar<int, ieWordSigned>(p.x);
+	ret += ReadScalar<int, ieWordSigned>(p.y);
+	return ret;
+}
+
+strret_t SpanReader::ReadSize(class Size& s)
+{
+	strret_t ret = ReadScalar<int, ieWord>(s.w);
+	ret += ReadScalar<int, ieWord>(s.h);
+	return ret;
+}
+
+strret_t SpanReader::ReadRegion(Region& r, bool asPoints)
+{
+	strret_t ret = ReadPoint(r.origin);
+	ret += ReadSize(r.size);
+	if (asPoints) { // size is really the "max" coord
+		r.w -= r.x;
+		r.h -= r.y;
+	}
+	return ret;
+}
+
+}
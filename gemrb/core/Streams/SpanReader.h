@@ -0,0 +1,138 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SPANREADER_H
+#define SPANREADER_H
+
+#include "DataStream.h"
+
+#include "exports.h"
+
+#include <cstring>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * @class SpanReader
+ * Non-virtual cursor over the next bytes of a stream, for parsing fixed
+ * layout headers and entry tables in one pass. The bytes of memory backed
+ * streams are used in place, other streams are read into a buffer with a
+ * single call. Either way the stream is advanced past the span right away
+ * and the reader must not outlive it.
+ *
+ * The reading methods mirror DataStream, so the same macros (ReadWord,
+ * ReadResRef ...) work on both. Reads past the end of the span fail and
+ * leave their destination untouched.
+ */
+class GEM_EXPORT SpanReader {
+public:
+	/** Spans the next length bytes, or less if the stream ends sooner */
+	SpanReader(DataStream* stream, strpos_t length);
+	SpanReader(const SpanReader&) = delete;
+	SpanReader& operator=(const SpanReader&) = delete;
+
+	strpos_t Size() const { return size; }
+	strpos_t GetPos() const { return pos; }
+	strpos_t Remains() const { return size - pos; }
+	/** Only GEM_CURRENT_POS and GEM_STREAM_START, relative to the span */
+	stroff_t Seek(stroff_t offset, strpos_t startpos);
+
+	strret_t Read(void* dest, strpos_t len)
+	{
+		if (len > size - pos) {
+			return DataStream::Error;
+		}
+		memcpy(dest, data + pos, len);
+		pos += len;
+		return len;
+	}
+
+	template <typename T>
+	strret_t ReadScalar(T& dest)
+	{
+		strret_t len = Read(&dest, sizeof(T));
+		if (swap && len != DataStream::Error) {
+			swabs(&dest, sizeof(T));
+		}
+		return len;
+	}
+
+	template <typename DST, typename SRC>
+	strret_t ReadScalar(DST& dest)
+	{
+		static_assert(sizeof(DST) >= sizeof(SRC), "This flavor of ReadScalar requires DST to be >= SRC.");
+		SRC src;
+		strret_t len = ReadScalar(src);
+		if (len != DataStream::Error) {
+			dest = src; // preserve sign extension
+		}
+		return len;
+	}
+
+	template <typename ENUM>
+	std::enable_if_t<std::is_enum<ENUM>::value, strret_t>
+	ReadEnum(ENUM& dest)
+	{
+		std::underlying_type_t<ENUM> scalar;
+		strret_t ret = ReadScalar(scalar);
+		if (ret != DataStream::Error) {
+			dest = static_cast<ENUM>(scalar);
+		}
+		return ret;
+	}
+
+	/** Reads count scalars after checking the bounds once */
+	template <typename T>
+	strret_t ReadArray(T* dest, size_t count)
+	{
+		strret_t len = Read(dest, sizeof(T) * count);
+		if (swap && len != DataStream::Error) {
+			for (size_t i = 0; i < count; ++i) {
+				swabs(&dest[i], sizeof(T));
+			}
+		}
+		return len;
+	}
+
+	template <typename STR>
+	strret_t ReadRTrimString(STR& dest, size_t len)
+	{
+		strret_t read = Read(dest.begin(), len);
+		if (read != DataStream::Error) {
+			RTrim(dest);
+		}
+		return read;
+	}
+
+	strret_t ReadPoint(Point&);
+	strret_t ReadSize(class Size&);
+	strret_t ReadRegion(Region&, bool asPoints = false);
+
+private:
+	std::vector<char> buffer;
+	const char* data = nullptr;
+	strpos_t size = 0;
+	strpos_t pos = 0;
+	bool swap = false;
+};
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 #ifndef TABLEMGR_H
 #define TABLEMGR_H
 
+#include <limits>
 #include <memory>
 
 #include "globals.h"
@@ -68,14 +69,51 @@ public:
 		return QueryField(GetRowIndex(row), GetColumnIndex(column));
 	}
 	
+	/** Returns the field parsed like strtol, importers may keep the parsed columns around */
+	virtual long QueryFieldLong(index_t row, index_t column) const
+	{
+		return strtol(QueryField(row, column).c_str(), nullptr, 0);
+	}
+
+	long QueryFieldLong(const key_t& row, const key_t& column) const
+	{
+		return QueryFieldLong(GetRowIndex(row), GetColumnIndex(column));
+	}
+
+	/** Returns the field parsed like strtoul */
+	virtual unsigned long QueryFieldULong(index_t row, index_t column) const
+	{
+		return strtoul(QueryField(row, column).c_str(), nullptr, 0);
+	}
+
+	unsigned long QueryFieldULong(const key_t& row, const key_t& column) const
+	{
+		return QueryFieldULong(GetRowIndex(row), GetColumnIndex(column));
+	}
+
+	// same clamping as strtounsigned
 	template <typename RET_T, typename ROW_T, typename COL_T>
 	RET_T QueryFieldUnsigned(const ROW_T& row, const COL_T& column) const {
-		return strtounsigned<RET_T>(QueryField(row, column).c_str());
+		static_assert(std::is_unsigned<RET_T>::value, "Type must be unsigned");
+		unsigned long value = QueryFieldULong(row, column);
+		if (value > std::numeric_limits<RET_T>::max()) {
+			return std::numeric_limits<RET_T>::max();
+		}
+		return static_cast<RET_T>(value);
 	}
-	
+
+	// same clamping as strtosigned
 	template <typename RET_T, typename ROW_T, typename COL_T>
 	RET_T QueryFieldSigned(const ROW_T& row, const COL_T& column) const {
-		return strtosigned<RET_T>(QueryField(row, column).c_str());
+		static_assert(std::is_signed<RET_T>::value, "Type must be signed");
+		long value = QueryFieldLong(row, column);
+		if (value > std::numeric_limits<RET_T>::max()) {
+			return std::numeric_limits<RET_T>::max();
+		}
+		if (value < std::numeric_limits<RET_T>::min()) {
+			return std::numeric_limits<RET_T>::min();
+		}
+		return static_cast<RET_T>(value);
 	}
 	
 	template <typename ROW_T, typename COL_T>
@@ -0,0 +1,102 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	if (threadCount == 0) {
+		// keep a core for the main thread
+		threadCount = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+	}
+
+	workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; ++i) {
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	Stop();
+}
+
+std::future<void> ThreadPool::Submit(Task task)
+{
+	std::packaged_task<void()> job(std::move(task));
+	std::future<void> result = job.get_future();
+
+	// Stop clears the queue under the lock, so check there too
+	std::lock_guard<std::mutex> lk(queueLock);
+	if (stopping) {
+		// dropping the job breaks the promise
+		return result;
+	}
+	queue.push_back(std::move(job));
+	cv.notify_one();
+	return result;
+}
+
+void ThreadPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lk(queueLock);
+		stopping = true;
+		queue.clear();
+	}
+	cv.notify_all();
+
+	for (auto& worker : workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+bool ThreadPool::IsWorkerThread() const
+{
+	std::thread::id self = std::this_thread::get_id();
+	return std::any_of(workers.cbegin(), workers.cend(), [self](const std::thread& worker) {
+		return worker.get_id() == self;
+	});
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true) {
+		std::unique_lock<std::mutex> lk(queueLock);
+		cv.wait(lk, [this]() { return !queue.empty() || stopping; });
+		if (stopping) {
+			return;
+		}
+
+		std::packaged_task<void()> job = std::move(queue.front());
+		queue.pop_front();
+		lk.unlock();
+
+		job();
+	}
+}
+
+}
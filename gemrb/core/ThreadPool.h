@@ -0,0 +1,77 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "exports.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * A fixed set of worker threads processing queued tasks in order.
+ * Tasks must not wait on other tasks of the same pool, since they could
+ * be queued behind the waiting one.
+ */
+class GEM_EXPORT ThreadPool {
+public:
+	using Task = std::function<void()>;
+
+	/** A threadCount of 0 picks one less than the number of cores (at least 1) */
+	explicit ThreadPool(unsigned int threadCount = 0);
+	ThreadPool(const ThreadPool&) = delete;
+	~ThreadPool();
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * Queues the task, the future becomes ready once it ran.
+	 * If the pool is stopped before the task ran, the future reports a broken promise.
+	 */
+	std::future<void> Submit(Task task);
+	/** Drops all queued tasks and waits for the running ones to finish */
+	void Stop();
+	/** Running tasks should poll this and return early once set */
+	bool Stopping() const { return stopping; }
+	/** Whether the calling thread is one of our workers */
+	bool IsWorkerThread() const;
+	size_t ThreadCount() const { return workers.size(); }
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::packaged_task<void()>> queue;
+	std::mutex queueLock;
+	std::condition_variable cv;
+	std::atomic_bool stopping {false};
+
+	void WorkerLoop();
+};
+
+}
+
+#endif
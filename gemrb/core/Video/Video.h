@@ -202,6 +202,14 @@ public:
 		const std::vector<Color>& /*colors*/,
 		BlitFlags /*blitFlags*/
 	) {};
+
+	struct FrameStats {
+		size_t drawCalls = 0; // batches handed to the renderer, copies merge until the state changes
+		size_t copies = 0;
+		size_t textureBinds = 0; // copies using a different texture than the one before
+	};
+	/** Counters of the last presented frame, drivers not keeping them report zeros */
+	virtual FrameStats GetFrameStats() const { return {}; }
 	/** Sets Event Manager */
 	void SetEventMgr(EventMgr* evnt);
 
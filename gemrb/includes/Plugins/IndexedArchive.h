@@ -32,6 +32,8 @@ class GEM_PLUGIN_EXPORT IndexedArchive : public Plugin {
 public:
 	virtual int OpenArchive(const path_t& filename) = 0;
 	virtual DataStream* GetStream(unsigned long Resource, unsigned long Type) = 0;
+	/** Makes sure a compressed archive is unpacked into the cache, without opening it */
+	virtual bool CacheArchive(const path_t& filename) = 0;
 };
 
 }
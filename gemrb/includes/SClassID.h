@@ -100,7 +100,9 @@ enum {
 	PLUGIN_RESOURCE_CACHEDDIRECTORY,
 	PLUGIN_RESOURCE_NULL,
 	PLUGIN_IMAGE_WRITER_BMP,
-	PLUGIN_COMPRESSION_ZLIB
+	PLUGIN_COMPRESSION_ZLIB,
+	PLUGIN_RESOURCE_PACK,
+	PLUGIN_RESOURCE_INDEXEDDIRECTORY
 };
 
 }
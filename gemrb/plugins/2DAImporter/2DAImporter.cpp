@@ -91,6 +91,27 @@ bool p2DAImporter::Open(std::unique_ptr<DataStream> str)
 	}
 
 	assert(rows.size() < std::numeric_limits<index_t>::max());
+
+	for (index_t index = 0; index < colNames.size(); index++) {
+		if (!colIndex.Contains(colNames[index])) {
+			colIndex.Set(colNames[index], index);
+		}
+	}
+	for (index_t index = 0; index < rowNames.size(); index++) {
+		if (!rowIndex.Contains(rowNames[index])) {
+			rowIndex.Set(rowNames[index], index);
+		}
+	}
+
+	// rows may be wider than the header
+	size_t width = colNames.size();
+	for (const auto& row : rows) {
+		width = std::max(width, row.size());
+	}
+	typedColumnCount = static_cast<index_t>(width);
+	typedColumns = std::make_unique<TypedColumn[]>(width);
+	defSigned = strtol(defVal.c_str(), nullptr, 0);
+	defUnsigned = strtoul(defVal.c_str(), nullptr, 0);
 	return true;
 }
 
@@ -134,24 +155,52 @@ const std::string& p2DAImporter::QueryDefault() const
 	return defVal;
 }
 
-p2DAImporter::index_t p2DAImporter::GetRowIndex(const key_t& key) const
+const p2DAImporter::TypedColumn* p2DAImporter::GetTypedColumn(index_t column) const
 {
-	for (index_t index = 0; index < rowNames.size(); index++) {
-		if (StringCompKey(rowNames[index], key)) {
-			return index;
+	if (column >= typedColumnCount) {
+		return nullptr;
+	}
+
+	// tables are shared, so this may run on several threads at once
+	TypedColumn& typed = typedColumns[column];
+	std::call_once(typed.parsed, [this, column, &typed]() {
+		typed.signedValues.reserve(rows.size());
+		typed.unsignedValues.reserve(rows.size());
+		for (index_t row = 0; row < rows.size(); row++) {
+			const std::string& field = QueryField(row, column);
+			typed.signedValues.push_back(strtol(field.c_str(), nullptr, 0));
+			typed.unsignedValues.push_back(strtoul(field.c_str(), nullptr, 0));
 		}
+	});
+	return &typed;
+}
+
+long p2DAImporter::QueryFieldLong(index_t row, index_t column) const
+{
+	const TypedColumn* typed = GetTypedColumn(column);
+	if (!typed || row >= rows.size()) {
+		return defSigned;
 	}
-	return npos;
+	return typed->signedValues[row];
 }
 
-p2DAImporter::index_t p2DAImporter::GetColumnIndex(const key_t& key) const
+unsigned long p2DAImporter::QueryFieldULong(index_t row, index_t column) const
 {
-	for (index_t index = 0; index < colNames.size(); index++) {
-		if (StringCompKey(colNames[index], key)) {
-			return index;
-		}
+	const TypedColumn* typed = GetTypedColumn(column);
+	if (!typed || row >= rows.size()) {
+		return defUnsigned;
 	}
-	return npos;
+	return typed->unsignedValues[row];
+}
+
+p2DAImporter::index_t p2DAImporter::GetRowIndex(const key_t& key) const
+{
+	return rowIndex.Get(key, npos);
+}
+
+p2DAImporter::index_t p2DAImporter::GetColumnIndex(const key_t& key) const
+{
+	return colIndex.Get(key, npos);
 }
 
 const static std::string blank;
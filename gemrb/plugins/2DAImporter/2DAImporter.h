@@ -25,7 +25,11 @@
 
 #include "globals.h"
 
+#include "Strings/StringMap.h"
+
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace GemRB {
@@ -39,6 +43,23 @@ private:
 	std::vector<cell_t> rowNames;
 	std::vector<row_t> rows;
 	std::string defVal;
+
+	// first occurrence of each (case insensitive) name
+	StringMap<index_t> colIndex;
+	StringMap<index_t> rowIndex;
+
+	// integer columns, parsed on first use
+	struct TypedColumn {
+		std::once_flag parsed;
+		std::vector<long> signedValues;
+		std::vector<unsigned long> unsignedValues;
+	};
+	index_t typedColumnCount = 0;
+	std::unique_ptr<TypedColumn[]> typedColumns;
+	long defSigned = 0;
+	unsigned long defUnsigned = 0;
+
+	const TypedColumn* GetTypedColumn(index_t column) const;
 public:
 	static index_t npos;
 
@@ -55,6 +76,8 @@ public:
 		if it cannot return a value, it returns the default */
 	const std::string& QueryField(index_t row, index_t column) const override;
 	const std::string& QueryDefault() const override;
+	long QueryFieldLong(index_t row, index_t column) const override;
+	unsigned long QueryFieldULong(index_t row, index_t column) const override;
 
 	index_t GetRowIndex(const key_t& string) const override;
 	index_t GetColumnIndex(const key_t& string) const override;
@@ -27,12 +27,21 @@
 #include "Streams/SlicedStream.h"
 #include "Streams/FileCache.h"
 #include "Streams/FileStream.h"
+#include "Streams/MemoryStream.h"
+#include "ThreadPool.h"
 #if defined(SUPPORTS_MEMSTREAM)
 #include "Streams/MappedFileMemoryStream.h"
 #endif
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 using namespace GemRB;
 
+static const ieDword NoEntry = 0xffffffff;
+
 BIFImporter::~BIFImporter(void)
 {
 	delete stream;
@@ -44,35 +53,105 @@ BIFImporter::~BIFImporter(void)
 	}
 }
 
+// exposes the buffer, so inflated blocks can be written out without another copy
+class BIFCBlock : public MemoryStream {
+public:
+	bool inflated = false;
+
+	explicit BIFCBlock(ieDword declen) : MemoryStream("", malloc(declen), declen) {}
+	const char* Data() const { return data; }
+};
+
+static void InflateBlocks(const Compressor* comp, std::vector<DataStream*>& sources, std::vector<BIFCBlock*>& blocks, size_t first, size_t last)
+{
+	for (size_t i = first; i < last; ++i) {
+		blocks[i]->inflated = comp->Decompress(blocks[i], sources[i], sources[i]->Size()) == GEM_OK;
+	}
+}
+
 DataStream* BIFImporter::DecompressBIFC(DataStream* compressed, const path_t& path)
 {
 	Log(MESSAGE, "BIFImporter", "Decompressing {} ...", compressed->filename);
 	PluginHolder<Compressor> comp = MakePluginHolder<Compressor>(PLUGIN_COMPRESSION_ZLIB);
 	ieDword unCompBifSize;
 	compressed->ReadDword(unCompBifSize);
-#if !defined(SUPPORTS_MEMSTREAM)
-	fflush(stdout);
-#endif
 	FileStream out;
-	if (!out.Create(path)) {
+	if (!out.Create(TempCachePath(path))) {
 		Log(ERROR, "BIFImporter", "Cannot write {}.", path);
 		return NULL;
 	}
+
+	// the blocks are compressed independently, so batches of them can be inflated
+	// concurrently; unless we are a pool worker already, since we would wait on our peers
+	ThreadPool* pool = core->GetWorkerPool();
+	size_t sliceCount = 1;
+	if (pool && !pool->IsWorkerThread()) {
+		sliceCount = pool->ThreadCount() + 1;
+	}
+	const size_t batchSize = sliceCount * 16;
+
 	size_t finalsize = 0;
-	int laststep = 0;
-	while (finalsize < unCompBifSize) {
-		ieDword complen, declen;
-		compressed->ReadDword(declen);
-		compressed->ReadDword(complen);
-		if (comp->Decompress( &out, compressed, complen ) != GEM_OK) {
-			return NULL;
+	bool failed = false;
+	while (!failed && finalsize < unCompBifSize) {
+		std::vector<DataStream*> sources;
+		std::vector<BIFCBlock*> blocks;
+		size_t batchEnd = finalsize;
+		while (blocks.size() < batchSize && batchEnd < unCompBifSize) {
+			ieDword complen, declen;
+			compressed->ReadDword(declen);
+			compressed->ReadDword(complen);
+			if (declen == 0 || compressed->Remains() < complen) {
+				failed = true;
+				break;
+			}
+			void* data = malloc(complen);
+			compressed->Read(data, complen);
+			sources.push_back(new MemoryStream("", data, complen));
+			blocks.push_back(new BIFCBlock(declen));
+			batchEnd += declen;
+		}
+
+		size_t sliceSize = (blocks.size() + sliceCount - 1) / sliceCount;
+		size_t slices = blocks.size() ? (blocks.size() + sliceSize - 1) / sliceSize : 0;
+		// whoever gets to a slice first inflates it, so we don't stall behind
+		// queued prewarm jobs; a worker getting to it late finds it done
+		auto claims = std::make_shared<std::vector<std::once_flag>>(slices);
+		auto inflate = [&comp, &sources, &blocks, sliceSize](size_t slice) {
+			size_t first = slice * sliceSize;
+			InflateBlocks(comp.get(), sources, blocks, first, std::min(first + sliceSize, blocks.size()));
+		};
+		for (size_t slice = 1; slice < slices; ++slice) {
+			pool->Submit([claims, inflate, slice]() {
+				std::call_once((*claims)[slice], inflate, slice);
+			});
 		}
-		finalsize = out.GetPos();
-		if (( int ) ( finalsize * ( 10.0 / unCompBifSize ) ) != laststep) {
-			laststep++;
+		// also waits for the slices the workers are busy with
+		for (size_t slice = 0; slice < slices; ++slice) {
+			std::call_once((*claims)[slice], inflate, slice);
 		}
+
+		for (size_t i = 0; i < blocks.size(); ++i) {
+			// a failed block is retried, unless we are shutting down
+			if (!blocks[i]->inflated && !failed && !CacheJobsCancelled()) {
+				InflateBlocks(comp.get(), sources, blocks, i, i + 1);
+			}
+			if (!blocks[i]->inflated || out.Write(blocks[i]->Data(), blocks[i]->GetPos()) == GEM_ERROR) {
+				failed = true;
+			}
+			delete sources[i];
+			delete blocks[i];
+		}
+		finalsize = batchEnd;
+		failed = failed || CacheJobsCancelled();
 	}
 	out.Close(); // This is necessary, since windows won't open the file otherwise.
+	if (failed) {
+		UnlinkFile(TempCachePath(path));
+		return NULL;
+	}
+	if (!CommitCacheFile(path)) {
+		return NULL;
+	}
 #if defined(SUPPORTS_MEMSTREAM)
 	return new MappedFileMemoryStream{path};
 #else
@@ -91,12 +170,10 @@ DataStream* BIFImporter::DecompressBIF(DataStream* compressed, const path_t& /*p
 	return CacheCompressedStream(compressed, std::string(compressed->filename), complen);
 }
 
-int BIFImporter::OpenArchive(const path_t& path)
+DataStream* BIFImporter::OpenUncompressed(const path_t& path)
 {
-	delete stream;
-	stream = nullptr;
-
 	path_t cachePath = PathJoin(core->config.CachePath, ExtractFileFromPath(path));
+	DataStream* bifStream = nullptr;
 	char Signature[8];
 #if defined(SUPPORTS_MEMSTREAM)
 	auto cacheStream = new MappedFileMemoryStream{cachePath.c_str()};
@@ -108,46 +185,69 @@ int BIFImporter::OpenArchive(const path_t& path)
 		if (!file->isOk()) {
 			delete file;
 #else
-	stream = FileStream::OpenFile(cachePath);
+	bifStream = FileStream::OpenFile(cachePath);
 
-	if (!stream) {
+	if (!bifStream) {
 		FileStream *file = FileStream::OpenFile(path);
 	if (!file) {
 #endif
-			return GEM_ERROR;
+			return nullptr;
 		}
 		if (file->Read(Signature, 8) == GEM_ERROR) {
 			delete file;
-			return GEM_ERROR;
+			return nullptr;
 		}
 
 		if (strncmp(Signature, "BIF V1.0", 8) == 0) {
-			stream = DecompressBIF(file, cachePath.c_str());
+			bifStream = DecompressBIF(file, cachePath.c_str());
 			delete file;
 		} else if (strncmp(Signature, "BIFCV1.0", 8) == 0) {
-			stream = DecompressBIFC(file, cachePath.c_str());
+			bifStream = DecompressBIFC(file, cachePath.c_str());
 			delete file;
 		} else if (strncmp( Signature, "BIFFV1  ", 8 ) == 0) {
 			file->Seek(0, GEM_STREAM_START);
-			stream = file;
+			bifStream = file;
 		} else {
 			delete file;
-			return GEM_ERROR;
+			return nullptr;
 		}
 #if defined(SUPPORTS_MEMSTREAM)
 	} else {
-		stream = cacheStream;
+		bifStream = cacheStream;
 #endif
 	}
 
+	return bifStream;
+}
+
+int BIFImporter::OpenArchive(const path_t& path)
+{
+	delete stream;
+	stream = nullptr;
+
+	// it may be getting decompressed in the background
+	WaitForCacheFile(ExtractFileFromPath(path));
+	stream = OpenUncompressed(path);
 	if (!stream)
 		return GEM_ERROR;
 
-	stream->Read( Signature, 8 );
+	return ReadBIF();
+}
 
-	if (strncmp( Signature, "BIFFV1  ", 8 ) != 0) {
+bool BIFImporter::CacheArchive(const path_t& path)
+{
+	DataStream* bifStream = OpenUncompressed(path);
+	bool ok = bifStream != nullptr;
+	delete bifStream;
+	return ok;
+}
+
+int BIFImporter::OpenArchive(DataStream* bifStream)
+{
+	delete stream;
+	stream = bifStream;
+	if (!stream)
 		return GEM_ERROR;
-	}
 
 	return ReadBIF();
 }
@@ -155,32 +255,63 @@ int BIFImporter::OpenArchive(const path_t& path)
 DataStream* BIFImporter::GetStream(unsigned long Resource, unsigned long Type)
 {
 	if (Type == IE_TIS_CLASS_ID) {
-		unsigned int srcResLoc = Resource & 0xFC000;
-		for (unsigned int i = 0; i < tentcount; i++) {
-			if (( tentries[i].resLocator & 0xFC000 ) == srcResLoc) {
-				return SliceStream( stream, tentries[i].dataOffset,
-							tentries[i].tileSize * tentries[i].tilesCount );
-			}
+		size_t idx = (Resource & 0xFC000) >> 14;
+		if (idx < tileIndex.size() && tileIndex[idx] != NoEntry) {
+			const TileEntry& entry = tentries[tileIndex[idx]];
+			return SliceStream(stream, entry.dataOffset, entry.tileSize * entry.tilesCount);
 		}
 	} else {
-		ieDword srcResLoc = Resource & 0x3FFF;
-		for (ieDword i = 0; i < fentcount; i++) {
-			if (( fentries[i].resLocator & 0x3FFF ) == srcResLoc) {
-				return SliceStream( stream, fentries[i].dataOffset,
-							fentries[i].fileSize );
-			}
+		size_t idx = Resource & 0x3FFF;
+		if (idx < fileIndex.size() && fileIndex[idx] != NoEntry) {
+			const FileEntry& entry = fentries[fileIndex[idx]];
+			return SliceStream(stream, entry.dataOffset, entry.fileSize);
 		}
 	}
 	return NULL;
 }
 
+void BIFImporter::IndexEntries()
+{
+	// the locator fields are at most 14 (files) and 6 (tilesets) bits wide,
+	// so a directly indexed table stays small; size it to what is used
+	ieDword maxFile = 0;
+	for (ieDword i = 0; i < fentcount; i++) {
+		maxFile = std::max<ieDword>(maxFile, (fentries[i].resLocator & 0x3FFF) + 1);
+	}
+	fileIndex.assign(maxFile, NoEntry);
+	for (ieDword i = 0; i < fentcount; i++) {
+		ieDword& slot = fileIndex[fentries[i].resLocator & 0x3FFF];
+		// the first entry wins on duplicates, like the old linear scan
+		if (slot == NoEntry) slot = i;
+	}
+
+	ieDword maxTile = 0;
+	for (ieDword i = 0; i < tentcount; i++) {
+		maxTile = std::max<ieDword>(maxTile, ((tentries[i].resLocator & 0xFC000) >> 14) + 1);
+	}
+	tileIndex.assign(maxTile, NoEntry);
+	for (ieDword i = 0; i < tentcount; i++) {
+		ieDword& slot = tileIndex[(tentries[i].resLocator & 0xFC000) >> 14];
+		if (slot == NoEntry) slot = i;
+	}
+}
+
 int BIFImporter::ReadBIF()
 {
+	char Signature[8];
+	stream->Read( Signature, 8 );
+
+	if (strncmp( Signature, "BIFFV1  ", 8 ) != 0) {
+		return GEM_ERROR;
+	}
+
 	ieDword foffset;
 	stream->ReadDword(fentcount);
 	stream->ReadDword(tentcount);
 	stream->ReadDword(foffset);
 	stream->Seek( foffset, GEM_STREAM_START );
+	delete[] fentries;
+	delete[] tentries;
 	fentries = new FileEntry[fentcount];
 	tentries = new TileEntry[tentcount];
 	if (!fentries || !tentries) {
@@ -204,6 +335,7 @@ int BIFImporter::ReadBIF()
 		stream->ReadWord(tentries[i].type);
 		stream->ReadWord(tentries[i].u1);
 	}
+	IndexEntries();
 	return GEM_OK;
 }
 
@@ -27,6 +27,8 @@
 
 #include "Streams/DataStream.h"
 
+#include <vector>
+
 namespace GemRB {
 
 struct FileEntry {
@@ -53,17 +55,25 @@ private:
 	ieDword fentcount = 0;
 	ieDword tentcount = 0;
 	DataStream* stream = nullptr;
+	// locator index -> entry index, so lookups don't have to walk the entry tables
+	std::vector<ieDword> fileIndex;
+	std::vector<ieDword> tileIndex;
 public:
 	BIFImporter() noexcept = default;
 	BIFImporter(const BIFImporter&) = delete;
 	~BIFImporter() override;
 	BIFImporter& operator=(const BIFImporter&) = delete;
 	int OpenArchive(const path_t& filename) override;
+	/** Reads an uncompressed BIFF archive, taking ownership of the stream */
+	int OpenArchive(DataStream* bifStream);
+	bool CacheArchive(const path_t& filename) override;
 	DataStream* GetStream(unsigned long Resource, unsigned long Type) override;
 private:
 	static DataStream* DecompressBIF(DataStream* compressed, const path_t& path);
 	static DataStream* DecompressBIFC(DataStream* compressed, const path_t& path);
+	static DataStream* OpenUncompressed(const path_t& path);
 	int ReadBIF();
+	void IndexEntries();
 };
 
 }
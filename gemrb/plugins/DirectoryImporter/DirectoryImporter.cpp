@@ -20,12 +20,31 @@
 
 #include "globals.h"
 
+#include "Interface.h"
 #include "Logging/Logging.h"
 #include "ResourceDesc.h"
 #include "Streams/FileStream.h"
 
+#ifdef HAVE_SYS_INOTIFY_H
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 using namespace GemRB;
 
+DirectoryImporter::~DirectoryImporter()
+{
+#ifdef HAVE_SYS_INOTIFY_H
+	if (watch >= 0) {
+		close(watch);
+	}
+#endif
+	if (probes) {
+		Log(DEBUG, "DirectoryImporter", "{}: {} probes, {} of them on disk.", description, probes.load(), diskProbes.load());
+	}
+}
+
 bool DirectoryImporter::Open(const path_t& dir, std::string desc)
 {
 	path_t p = dir;
@@ -38,47 +57,35 @@ bool DirectoryImporter::Open(const path_t& dir, std::string desc)
 	return true;
 }
 
-static bool FindIn(const path_t& path, StringView resRef, const path_t& type)
-{
-	return FileExists(PathJoinExt(path, resRef, type));
-}
-
-static FileStream *SearchIn(const path_t& path, StringView resRef, const path_t& type)
-{
-	return FileStream::OpenFile(PathJoinExt(path, resRef, type));
-}
-
-bool DirectoryImporter::HasResource(StringView resname, SClass_ID type)
+bool DirectoryImporter::BuildIndex(bool follow)
 {
-	return FindIn( path, resname, TypeExt(type) );
-}
-
-bool DirectoryImporter::HasResource(StringView resname, const ResourceDesc &type)
-{
-	return FindIn( path, resname, type.GetExt() );
-}
-
-DataStream* DirectoryImporter::GetResource(StringView resname, SClass_ID type)
-{
-	return SearchIn( path, resname, TypeExt(type) );
-}
-
-DataStream* DirectoryImporter::GetResource(StringView resname, const ResourceDesc &type)
-{
-	return SearchIn( path, resname, type.GetExt() );
-}
-
-bool CachedDirectoryImporter::Open(const path_t& dir, std::string desc)
-{
-	if (!DirectoryImporter::Open(dir, std::move(desc)))
-		return false;
-
-	Refresh();
+#ifdef HAVE_SYS_INOTIFY_H
+	if (follow) {
+		watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+		if (watch >= 0 && inotify_add_watch(watch, path.c_str(), mask | IN_ONLYDIR) < 0) {
+			close(watch);
+			watch = -1;
+		}
+		if (watch < 0) {
+			Log(WARNING, "DirectoryImporter", "Cannot watch '{}', it won't be indexed.", path);
+			return false;
+		}
+		watched = true;
+	}
+#else
+	// nothing would tell us about changes
+	if (follow) return false;
+#endif
 
+	tick_t startTime = GetMilliseconds();
+	Scan();
+	indexed = true;
+	Log(DEBUG, "DirectoryImporter", "Indexed {} files of '{}' in {} ms.", cache.size(), path, GetMilliseconds() - startTime);
 	return true;
 }
 
-void CachedDirectoryImporter::Refresh()
+void DirectoryImporter::Scan()
 {
 	cache.clear();
 
@@ -91,11 +98,57 @@ void CachedDirectoryImporter::Refresh()
 		const path_t name = it.GetName();
 		auto emplaceResult = cache.emplace(name);
 		if (!emplaceResult.second) {
-			Log(ERROR, "CachedDirectoryImporter", "Duplicate '{}' files in '{}' directory", name, path);
+			Log(ERROR, "DirectoryImporter", "Duplicate '{}' files in '{}' directory", name, path);
 		}
 	} while (++it);
 }
 
+// applies the changes since the last probe, called with the index locked
+void DirectoryImporter::Sync()
+{
+#ifdef HAVE_SYS_INOTIFY_H
+	if (watch < 0) return;
+
+	// asking is cheaper than draining, and there's usually nothing new
+	pollfd pending { watch, POLLIN, 0 };
+	if (poll(&pending, 1, 0) <= 0 || !(pending.revents & POLLIN)) return;
+
+	bool rescan = false;
+	bool lost = false;
+	alignas(inotify_event) char buffer[4096];
+	ssize_t len;
+	while ((len = read(watch, buffer, sizeof(buffer))) > 0) {
+		for (const char* ptr = buffer; ptr < buffer + len;) {
+			const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+			ptr += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				rescan = true;
+			} else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+				lost = true;
+			} else if (event->len == 0 || event->mask & IN_ISDIR) {
+				continue;
+			} else if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+				cache.emplace(event->name);
+			} else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+				cache.erase(event->name);
+			}
+		}
+	}
+
+	if (lost) {
+		// the directory itself is gone or moved, go back to asking the disk
+		Log(WARNING, "DirectoryImporter", "Lost the watch on '{}', no longer indexing it.", path);
+		close(watch);
+		watch = -1;
+		indexed = false;
+		cache.clear();
+	} else if (rescan) {
+		Scan();
+	}
+#endif
+}
+
 static path_t ConstructFilename(StringView resname, const path_t& ext)
 {
 	path_t buf(resname.c_str(), resname.length());
@@ -104,42 +157,102 @@ static path_t ConstructFilename(StringView resname, const path_t& ext)
 	return buf;
 }
 
-bool CachedDirectoryImporter::HasResource(StringView resname, SClass_ID type)
+// answers from the index, when there is one
+DirectoryImporter::Probe DirectoryImporter::Lookup(StringView resname, const path_t& ext, path_t* file)
 {
-	const path_t& filename = ConstructFilename(resname, TypeExt(type));
-	return cache.find(filename) != cache.cend();
+	if (!indexed) {
+		// only worth counting when we lost the index
+		if (watched) {
+			++probes;
+			++diskProbes;
+		}
+		return Probe::Unknown;
+	}
+	++probes;
+
+	// the listing of unwatched directories never changes after Open
+	std::unique_lock<std::mutex> lock(indexLock, std::defer_lock);
+	if (watched) {
+		lock.lock();
+		Sync();
+		if (!indexed) {
+			++diskProbes;
+			return Probe::Unknown;
+		}
+	}
+
+	const auto entry = cache.find(ConstructFilename(resname, ext));
+	if (entry == cache.cend()) {
+		return Probe::Missing;
+	}
+	if (file) {
+		*file = PathJoin(path, *entry);
+	}
+	return Probe::Found;
 }
 
-bool CachedDirectoryImporter::HasResource(StringView resname, const ResourceDesc &type)
+bool DirectoryImporter::Find(StringView resname, const path_t& ext)
 {
-	const path_t& filename = ConstructFilename(resname, type.GetExt());
-	return cache.find(filename) != cache.cend();
+	Probe probe = Lookup(resname, ext, nullptr);
+	if (probe == Probe::Unknown) {
+		return FileExists(PathJoinExt(path, resname, ext));
+	}
+	return probe == Probe::Found;
 }
 
-DataStream* CachedDirectoryImporter::GetResource(StringView resname, SClass_ID type)
+DataStream* DirectoryImporter::Search(StringView resname, const path_t& ext)
+{
+	path_t file;
+	switch (Lookup(resname, ext, &file)) {
+		case Probe::Found:
+			return FileStream::OpenFile(file);
+		case Probe::Missing:
+			return nullptr;
+		default:
+			return FileStream::OpenFile(PathJoinExt(path, resname, ext));
+	}
+}
+
+bool DirectoryImporter::HasResource(StringView resname, SClass_ID type)
+{
+	return Find(resname, TypeExt(type));
+}
+
+bool DirectoryImporter::HasResource(StringView resname, const ResourceDesc &type)
 {
-	const path_t& filename = ConstructFilename(resname, TypeExt(type));
-	const auto lookup = cache.find(filename);
+	return Find(resname, type.GetExt());
+}
 
-	if (lookup == cache.cend())
-		return nullptr;
+DataStream* DirectoryImporter::GetResource(StringView resname, SClass_ID type)
+{
+	return Search(resname, TypeExt(type));
+}
 
-	path_t buf = path;
-	PathAppend(buf, *lookup);
-	return FileStream::OpenFile(buf);
+DataStream* DirectoryImporter::GetResource(StringView resname, const ResourceDesc &type)
+{
+	return Search(resname, type.GetExt());
 }
 
-DataStream* CachedDirectoryImporter::GetResource(StringView resname, const ResourceDesc &type)
+bool CachedDirectoryImporter::Open(const path_t& dir, std::string desc)
 {
-	const path_t& filename = ConstructFilename(resname, type.GetExt());
-	const auto lookup = cache.find(filename);
+	if (!DirectoryImporter::Open(dir, std::move(desc)))
+		return false;
 
-	if (lookup == cache.cend())
-		return nullptr;
+	// the listing is read once, nobody should be changing these directories
+	BuildIndex(false);
 
-	path_t buf = path;
-	PathAppend(buf, *lookup);
-	return FileStream::OpenFile(buf);
+	return true;
+}
+
+bool IndexedDirectoryImporter::Open(const path_t& dir, std::string desc)
+{
+	if (!DirectoryImporter::Open(dir, std::move(desc)))
+		return false;
+
+	if (core->config.IndexDirectories) {
+		BuildIndex(true);
+	}
+	return true;
 }
 
 #include "plugindef.h"
@@ -147,4 +260,5 @@ DataStream* CachedDirectoryImporter::GetResource(StringView resname, const Resou
 GEMRB_PLUGIN(0xAB4534, "Directory Importer")
 PLUGIN_CLASS(PLUGIN_RESOURCE_DIRECTORY, DirectoryImporter)
 PLUGIN_CLASS(PLUGIN_RESOURCE_CACHEDDIRECTORY, CachedDirectoryImporter)
+PLUGIN_CLASS(PLUGIN_RESOURCE_INDEXEDDIRECTORY, IndexedDirectoryImporter)
 END_PLUGIN()
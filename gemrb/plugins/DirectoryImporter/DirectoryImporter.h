@@ -19,6 +19,8 @@
 #ifndef DIRIMP_H
 #define DIRIMP_H
 
+#include <atomic>
+#include <mutex>
 #include <set>
 
 #include "ResourceSource.h"
@@ -29,12 +31,27 @@ namespace GemRB {
 
 class ResourceDesc;
 
+/**
+ * Plain directory source, which asks the disk on every probe.
+ */
 class DirectoryImporter : public ResourceSource {
 protected:
 	path_t path;
+	// the case is case insensitive, but we will only store valid names
+	std::set<path_t, CstrLessCI> cache;
+	std::atomic_bool indexed {false};
+	bool watched = false; // the index follows changes, so lookups need the lock
+	std::mutex indexLock;
+	int watch = -1; // inotify descriptor
+	std::atomic<size_t> probes {0};
+	std::atomic<size_t> diskProbes {0};
 
 public:
 	DirectoryImporter() noexcept = default;
+	DirectoryImporter(const DirectoryImporter&) = delete;
+	~DirectoryImporter() override;
+	DirectoryImporter& operator=(const DirectoryImporter&) = delete;
+
 	bool Open(const path_t& dir, std::string desc) override;
 	/** predicts the availability of a resource */
 	bool HasResource(StringView resname, SClass_ID type) override;
@@ -42,23 +59,39 @@ public:
 	/** returns resource */
 	DataStream* GetResource(StringView resname, SClass_ID type) override;
 	DataStream* GetResource(StringView resname, const ResourceDesc &type) override;
-};
 
-class CachedDirectoryImporter : public DirectoryImporter {
 protected:
-	// the case is case insensitive, but we will only store valid names
-	std::set<path_t, CstrLessCI> cache;
+	bool BuildIndex(bool follow);
+
+private:
+	enum class Probe { Missing, Found, Unknown };
 
+	void Scan();
+	void Sync();
+	Probe Lookup(StringView resname, const path_t& ext, path_t* file);
+	bool Find(StringView resname, const path_t& ext);
+	DataStream* Search(StringView resname, const path_t& ext);
+};
+
+/**
+ * Directory source for the long-lived volatile directories (cache, sounds,
+ * movies, music). With IndexDirectories the listing is kept in memory, so
+ * probes never touch the disk. Since the directory can change behind our back,
+ * the index is kept in sync through inotify and is only built where that is
+ * available.
+ */
+class IndexedDirectoryImporter : public DirectoryImporter {
+public:
+	IndexedDirectoryImporter() noexcept = default;
+	bool Open(const path_t& dir, std::string desc) override;
+};
+
+class CachedDirectoryImporter : public DirectoryImporter {
 public:
 	CachedDirectoryImporter() noexcept = default;
 	bool Open(const path_t& dir, std::string desc) override;
-	void Refresh();
-	/** predicts the availability of a resource */
-	bool HasResource(StringView resname, SClass_ID type) override;
-	bool HasResource(StringView resname, const ResourceDesc &type) override;
-	/** returns resource */
-	DataStream* GetResource(StringView resname, SClass_ID type) override;
-	DataStream* GetResource(StringView resname, const ResourceDesc &type) override;
+	/** the listing is only read on Open */
+	bool IsVolatile() const override { return false; }
 };
 
 
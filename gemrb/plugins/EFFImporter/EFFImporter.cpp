@@ -20,6 +20,8 @@
 
 #include "EFFImporter.h"
 
+#include "Streams/SpanReader.h"
+
 using namespace GemRB;
 
 EFFImporter::~EFFImporter(void)
@@ -81,31 +83,32 @@ Effect* EFFImporter::GetEffectV1()
 	ieWord tmpWord;
 
 	Effect* fx = new Effect;
+	SpanReader fields(str, 48);
 
-	str->ReadWord(tmpWord);
+	fields.ReadWord(tmpWord);
 	fx->Opcode = tmpWord;
-	str->Read( &tmpByte, 1 );
+	fields.Read( &tmpByte, 1 );
 	fx->Target = tmpByte;
-	str->Read( &tmpByte, 1 );
+	fields.Read( &tmpByte, 1 );
 	fx->Power = tmpByte;
-	str->ReadDword(fx->Parameter1);
-	str->ReadDword(fx->Parameter2);
-	str->Read( &tmpByte, 1 );
+	fields.ReadDword(fx->Parameter1);
+	fields.ReadDword(fx->Parameter2);
+	fields.Read( &tmpByte, 1 );
 	fx->TimingMode = tmpByte;
-	str->Read( &tmpByte, 1 );
+	fields.Read( &tmpByte, 1 );
 	fx->Resistance = tmpByte;
-	str->ReadDword(fx->Duration);
-	str->Read( &tmpByte, 1 );
+	fields.ReadDword(fx->Duration);
+	fields.Read( &tmpByte, 1 );
 	fx->ProbabilityRangeMax = tmpByte;
-	str->Read( &tmpByte, 1 );
+	fields.Read( &tmpByte, 1 );
 	fx->ProbabilityRangeMin = tmpByte;
-	str->ReadResRef( fx->Resource );
-	str->ReadDword(fx->DiceThrown);
-	str->ReadDword(fx->DiceSides);
-	str->ReadDword(fx->SavingThrowType);
-	str->ReadDword(fx->SavingThrowBonus);
-	str->ReadWord(fx->IsVariable);
-	str->ReadWord(fx->IsSaveForHalfDamage);
+	fields.ReadResRef( fx->Resource );
+	fields.ReadDword(fx->DiceThrown);
+	fields.ReadDword(fx->DiceSides);
+	fields.ReadDword(fx->SavingThrowType);
+	fields.ReadDword(fx->SavingThrowBonus);
+	fields.ReadWord(fx->IsVariable);
+	fields.ReadWord(fx->IsSaveForHalfDamage);
 	fixAffectedLevels( fx );
 
 	fx->Pos.Invalidate();
@@ -117,61 +120,62 @@ Effect* EFFImporter::GetEffectV20()
 {
 	ieDword tmp;
 	Effect* fx = new Effect;
-
-	str->Seek(8, GEM_CURRENT_POS);
-	str->ReadDword(fx->Opcode);
-	str->ReadDword(fx->Target);
-	str->ReadDword(fx->Power);
-	str->ReadDword(fx->Parameter1);
-	str->ReadDword(fx->Parameter2);
-	str->ReadWord(fx->TimingMode);
-	str->ReadWord(fx->unknown2); // part of a dword TimingMode (but only true for v2 effects)
-	str->ReadDword(fx->Duration);
-	str->ReadWord(fx->ProbabilityRangeMax);
-	str->ReadWord(fx->ProbabilityRangeMin);
-	str->ReadResRef( fx->Resource );
-	str->ReadDword(fx->DiceThrown);
-	str->ReadDword(fx->DiceSides);
-	str->ReadDword(fx->SavingThrowType);
-	str->ReadDword(fx->SavingThrowBonus);
-	str->ReadWord(fx->IsVariable); //if this field was set to 1, this is a variable
-	str->ReadWord(fx->IsSaveForHalfDamage); //if this field was set to 1, save for half damage; part of Special dword with the preceding field
-	str->ReadDword(fx->PrimaryType);
-	str->Seek(4, GEM_CURRENT_POS); // JeremyIsAnIdiot in the original :D
-	str->ReadDword(fx->MinAffectedLevel);
-	str->ReadDword(fx->MaxAffectedLevel);
-	str->ReadDword(fx->Resistance);
-	str->ReadDword(fx->Parameter3);
-	str->ReadDword(fx->Parameter4);
-	str->ReadDword(fx->Parameter5);
-	str->ReadDword(fx->Parameter6);
-	str->ReadResRef( fx->Resource2 );
-	str->ReadResRef( fx->Resource3 );
-	str->ReadDword(tmp);
+	SpanReader fields(str, 264);
+
+	fields.Seek(8, GEM_CURRENT_POS);
+	fields.ReadDword(fx->Opcode);
+	fields.ReadDword(fx->Target);
+	fields.ReadDword(fx->Power);
+	fields.ReadDword(fx->Parameter1);
+	fields.ReadDword(fx->Parameter2);
+	fields.ReadWord(fx->TimingMode);
+	fields.ReadWord(fx->unknown2); // part of a dword TimingMode (but only true for v2 effects)
+	fields.ReadDword(fx->Duration);
+	fields.ReadWord(fx->ProbabilityRangeMax);
+	fields.ReadWord(fx->ProbabilityRangeMin);
+	fields.ReadResRef( fx->Resource );
+	fields.ReadDword(fx->DiceThrown);
+	fields.ReadDword(fx->DiceSides);
+	fields.ReadDword(fx->SavingThrowType);
+	fields.ReadDword(fx->SavingThrowBonus);
+	fields.ReadWord(fx->IsVariable); //if this field was set to 1, this is a variable
+	fields.ReadWord(fx->IsSaveForHalfDamage); //if this field was set to 1, save for half damage; part of Special dword with the preceding field
+	fields.ReadDword(fx->PrimaryType);
+	fields.Seek(4, GEM_CURRENT_POS); // JeremyIsAnIdiot in the original :D
+	fields.ReadDword(fx->MinAffectedLevel);
+	fields.ReadDword(fx->MaxAffectedLevel);
+	fields.ReadDword(fx->Resistance);
+	fields.ReadDword(fx->Parameter3);
+	fields.ReadDword(fx->Parameter4);
+	fields.ReadDword(fx->Parameter5);
+	fields.ReadDword(fx->Parameter6);
+	fields.ReadResRef( fx->Resource2 );
+	fields.ReadResRef( fx->Resource3 );
+	fields.ReadDword(tmp);
 	fx->Source.x = tmp;
-	str->ReadDword(tmp);
+	fields.ReadDword(tmp);
 	fx->Source.y = tmp;
-	str->ReadDword(tmp);
+	fields.ReadDword(tmp);
 	fx->Pos.x = tmp;
-	str->ReadDword(tmp);
+	fields.ReadDword(tmp);
 	fx->Pos.y = tmp;
-	str->ReadDword(fx->SourceType);
-	str->ReadResRef(fx->SourceRef);
-	str->ReadDword(fx->SourceFlags);
-	str->ReadDword(fx->Projectile);
-	str->ReadDword(tmp);
+	fields.ReadDword(fx->SourceType);
+	fields.ReadResRef(fx->SourceRef);
+	fields.ReadDword(fx->SourceFlags);
+	fields.ReadDword(fx->Projectile);
+	fields.ReadDword(tmp);
 	fx->InventorySlot=(ieDwordSigned) (tmp);
 	//Variable simply overwrites the resource fields (Keep them grouped)
 	//They have to be continuous
 	if (fx->IsVariable) {
-		str->ReadVariable(fx->VariableName);
+		fields.ReadVariable(fx->VariableName);
 	} else {
-		str->Seek( 32, GEM_CURRENT_POS);
+		fields.Seek( 32, GEM_CURRENT_POS);
 	}
-	str->ReadDword(fx->CasterLevel);
-	str->Seek(4, GEM_CURRENT_POS); // FirstApply
-	str->ReadDword(fx->SecondaryType);
-	str->Seek(60, GEM_CURRENT_POS); // padding
+	fields.ReadDword(fx->CasterLevel);
+	fields.Seek(4, GEM_CURRENT_POS); // FirstApply
+	fields.ReadDword(fx->SecondaryType);
+	fields.Seek(60, GEM_CURRENT_POS); // padding
 
 	return fx;
 }
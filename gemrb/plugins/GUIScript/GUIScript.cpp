@@ -33,6 +33,7 @@
 #include "Game.h"
 #include "GameData.h"
 #include "ImageFactory.h"
+#include "ImageWriter.h"
 #include "Interface.h"
 #include "Item.h"
 #include "KeyMap.h"
@@ -40,6 +41,7 @@
 #include "MusicMgr.h"
 #include "Palette.h"
 #include "PalettedImageMgr.h"
+#include "PluginMgr.h"
 #include "ResourceDesc.h"
 #include "RNG.h"
 #include "SaveGameIterator.h"
@@ -48,6 +50,7 @@
 #include "Video/Video.h"
 #include "WorldMap.h"
 #include "GameScript/GSUtils.h" //checkvariable
+#include "GameScript/ScriptProfiler.h"
 #include "GUI/Button.h"
 #include "GUI/Console.h"
 #include "GUI/EventMgr.h"
@@ -4314,6 +4317,34 @@ static PyObject* GemRB_DumpActor(PyObject * /*self*/, PyObject * args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_DumpScriptProfile__doc,
+"===== DumpScriptProfile =====\n\
+\n\
+**Prototype:** GemRB.DumpScriptProfile ([filename, reset])\n\
+\n\
+**Description:** Writes the collected script profile: call counts and time \n\
+spent per script, response block, trigger and action. Profiling is only done \n\
+while debug mode 1024 is set (see the DebugMode config option).\n\
+\n\
+**Parameters:**\n\
+  * filename - where to write the report, if omitted it is logged instead\n\
+  * reset - if nonzero, start collecting anew afterwards\n\
+\n\
+**Return value:** bool, false if the file could not be written"
+);
+static PyObject* GemRB_DumpScriptProfile(PyObject * /*self*/, PyObject * args)
+{
+	char* path = nullptr;
+	int reset = 0;
+	PARSE_ARGS(args, "|zi", &path, &reset);
+
+	bool written = ScriptProfiler::Dump(path ? path : "");
+	if (reset) {
+		ScriptProfiler::Reset();
+	}
+	return PyBool_FromLong(written);
+}
+
 PyDoc_STRVAR( GemRB_SaveCharacter__doc,
 "===== SaveCharacter =====\n\
 \n\
@@ -4368,6 +4399,38 @@ static PyObject* GemRB_SaveConfig(PyObject * /*self*/, PyObject * /*args*/)
 	return PyBool_FromLong(core->SaveConfig());
 }
 
+PyDoc_STRVAR( GemRB_SaveScreenshot__doc,
+"===== SaveScreenshot =====\n\
+\n\
+**Prototype:** GemRB.SaveScreenshot (filename)\n\
+\n\
+**Description:** Redraws the windows and writes the screen to a BMP file. \n\
+With the headless video driver the image stays black unless \n\
+HeadlessFramebuffer is set.\n\
+\n\
+**Parameters:**\n\
+  * filename - path of the image to write\n\
+\n\
+**Return value:** bool, false if the image could not be written"
+);
+
+static PyObject* GemRB_SaveScreenshot(PyObject * /*self*/, PyObject* args)
+{
+	char* path = nullptr;
+	PARSE_ARGS(args, "s", &path);
+
+	PluginHolder<ImageWriter> im = MakePluginHolder<ImageWriter>(PLUGIN_IMAGE_WRITER_BMP);
+	if (!im) {
+		return PyBool_FromLong(false);
+	}
+	FileStream outfile;
+	if (!outfile.Create(path)) {
+		return PyBool_FromLong(false);
+	}
+	im->PutImage(&outfile, core->GetWindowManager()->GetScreenshot(nullptr));
+	return PyBool_FromLong(true);
+}
+
 PyDoc_STRVAR( GemRB_SaveGame__doc,
 "===== SaveGame =====\n\
 \n\
@@ -4423,6 +4486,34 @@ static PyObject* GemRB_SaveGame(PyObject * /*self*/, PyObject * args)
 	}
 }
 
+PyDoc_STRVAR( GemRB_GetSaveProgress__doc,
+"===== GetSaveProgress =====\n\
+\n\
+**Prototype:** GemRB.GetSaveProgress ()\n\
+\n\
+**Description:** Returns how far the last save got. With the BackgroundSaving \n\
+config option the game goes on while a save is written, it is only listed by \n\
+GetSaveGames once complete.\n\
+\n\
+**Return value:** dict with the following keys:\n\
+  * Pending - whether a save is still being written or not yet reported\n\
+  * Done - files written so far\n\
+  * Total - files in the save\n\
+\n\
+**See also:** [GetSaveGames](GetSaveGames.md)"
+);
+
+static PyObject* GemRB_GetSaveProgress(PyObject * /*self*/, PyObject* /*args*/)
+{
+	SaveGameWriter::Progress progress = core->GetSaveGameIterator()->GetSaveProgress();
+
+	PyObject* dict = PyDict_New();
+	PyDict_SetItemString(dict, "Pending", DecRef(PyBool_FromLong, progress.pending));
+	PyDict_SetItemString(dict, "Done", DecRef(PyLong_FromSize_t, progress.done));
+	PyDict_SetItemString(dict, "Total", DecRef(PyLong_FromSize_t, progress.total));
+	return dict;
+}
+
 PyDoc_STRVAR( GemRB_GetSaveGames__doc,
 "===== GetSaveGames =====\n\
 \n\
@@ -4949,6 +5040,7 @@ static PyObject* GemRB_GameSetPartyGold(PyObject * /*self*/, PyObject* args)
 		game->AddGold(Gold);
 	} else {
 		game->PartyGold=Gold;
+		game->StateChanged();
 	}
 
 	Py_RETURN_NONE;
@@ -7913,6 +8005,100 @@ static PyObject* GemRB_ConsoleWindowLog(PyObject * /*self*/, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_GetResourceCacheStats__doc,
+"===== GetResourceCacheStats =====\n\
+\n\
+**Prototype:** GemRB.GetResourceCacheStats ()\n\
+\n\
+**Description:** Returns the statistics of the resource lookup cache, which \n\
+remembers where (and whether) resources were found in the search path. Mostly \n\
+useful from the debug console.\n\
+\n\
+**Return value:** dict with the following keys:\n\
+  * Hits - lookups answered from the cache\n\
+  * Misses - lookups that had to search the sources\n\
+  * Entries - number of cached lookups\n\
+\n\
+**Examples:**\n\
+\n\
+    print(GemRB.GetResourceCacheStats())\n\
+"
+);
+
+static PyObject* GemRB_GetResourceCacheStats(PyObject * /*self*/, PyObject* /*args*/)
+{
+	ResourceManager::LookupCacheStats stats = gamedata->GetLookupCacheStats();
+
+	PyObject* dict = PyDict_New();
+	PyDict_SetItemString(dict, "Hits", DecRef(PyLong_FromSize_t, stats.hits));
+	PyDict_SetItemString(dict, "Misses", DecRef(PyLong_FromSize_t, stats.misses));
+	PyDict_SetItemString(dict, "Entries", DecRef(PyLong_FromSize_t, stats.entries));
+	return dict;
+}
+
+PyDoc_STRVAR( GemRB_GetTriggerMemoStats__doc,
+"===== GetTriggerMemoStats =====\n\
+\n\
+**Prototype:** GemRB.GetTriggerMemoStats ()\n\
+\n\
+**Description:** Returns the statistics of the trigger memo, which shares the \n\
+results of triggers that only depend on the game state (like Global or \n\
+TimeOfDay) between the scriptables running the same script. Mostly useful \n\
+from the debug console.\n\
+\n\
+**Return value:** dict with the following keys:\n\
+  * Hits - evaluations answered from the memo\n\
+  * Misses - evaluations that had to run the trigger\n\
+  * Entries - number of currently remembered results\n\
+\n\
+**Examples:**\n\
+\n\
+    print(GemRB.GetTriggerMemoStats())\n\
+"
+);
+
+static PyObject* GemRB_GetTriggerMemoStats(PyObject * /*self*/, PyObject* /*args*/)
+{
+	TriggerMemo::Stats stats = TriggerMemo::GetStats();
+
+	PyObject* dict = PyDict_New();
+	PyDict_SetItemString(dict, "Hits", DecRef(PyLong_FromSize_t, stats.hits));
+	PyDict_SetItemString(dict, "Misses", DecRef(PyLong_FromSize_t, stats.misses));
+	PyDict_SetItemString(dict, "Entries", DecRef(PyLong_FromSize_t, stats.entries));
+	return dict;
+}
+
+PyDoc_STRVAR( GemRB_GetVideoStats__doc,
+"===== GetVideoStats =====\n\
+\n\
+**Prototype:** GemRB.GetVideoStats ()\n\
+\n\
+**Description:** Returns the render counters of the last presented frame, if \n\
+the video driver keeps them (SDL2 does). Mostly useful from the debug console.\n\
+\n\
+**Return value:** dict with the following keys:\n\
+  * DrawCalls - number of batches handed to the renderer; consecutive copies\n\
+    share one until the texture, blending, target or shader state changes\n\
+  * Copies - number of texture copies\n\
+  * TextureBinds - copies using a different texture than the previous one\n\
+\n\
+**Examples:**\n\
+\n\
+    print(GemRB.GetVideoStats())\n\
+"
+);
+
+static PyObject* GemRB_GetVideoStats(PyObject * /*self*/, PyObject* /*args*/)
+{
+	Video::FrameStats stats = VideoDriver->GetFrameStats();
+
+	PyObject* dict = PyDict_New();
+	PyDict_SetItemString(dict, "DrawCalls", DecRef(PyLong_FromSize_t, stats.drawCalls));
+	PyDict_SetItemString(dict, "Copies", DecRef(PyLong_FromSize_t, stats.copies));
+	PyDict_SetItemString(dict, "TextureBinds", DecRef(PyLong_FromSize_t, stats.textureBinds));
+	return dict;
+}
+
 PyDoc_STRVAR( GemRB_GetCurrentArea__doc,
 "===== GetCurrentArea =====\n\
 \n\
@@ -11651,6 +11837,37 @@ static PyObject* GemRB_SetGamma(PyObject * /*self*/, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_SetHierarchicalPathfinding__doc,
+"===== SetHierarchicalPathfinding =====\n\
+\n\
+**Prototype:** GemRB.SetHierarchicalPathfinding (enable)\n\
+\n\
+**Description:** Switches between planning long walks on the area's cluster graph \
+and searching the whole searchmap, so both can be compared. With the pathfinder \
+debug mode on, every search logs which method was used and how long it took.\n\
+\n\
+**Parameters:**\n\
+  * enable - 1 for hierarchical pathfinding, 0 for the plain search\n\
+\n\
+**Return value:** N/A"
+);
+
+static PyObject* GemRB_SetHierarchicalPathfinding(PyObject * /*self*/, PyObject* args)
+{
+	int enable;
+	PARSE_ARGS(args, "i", &enable);
+
+	core->config.HierarchicalPathfinding = enable != 0;
+	// areas loaded while it was off have no cluster graph yet
+	const Game* game = core->GetGame();
+	if (enable && game) {
+		for (size_t i = 0; i < game->GetLoadedMapCount(); ++i) {
+			game->GetMap(static_cast<unsigned int>(i))->BuildPathClusters();
+		}
+	}
+	Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR( GemRB_SetMouseScrollSpeed__doc,
 "===== SetMouseScrollSpeed =====\n\
 \n\
@@ -12982,6 +13199,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(DragItem, METH_VARARGS),
 	METHOD(DropDraggedItem, METH_VARARGS),
 	METHOD(DumpActor, METH_VARARGS),
+	METHOD(DumpScriptProfile, METH_VARARGS),
 	METHOD(EnableCheatKeys, METH_VARARGS),
 	METHOD(EndCutSceneMode, METH_NOARGS),
 	METHOD(EnterGame, METH_NOARGS),
@@ -13058,8 +13276,10 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(GetPlayerScript, METH_VARARGS),
 	METHOD(GetPlayerSound, METH_VARARGS),
 	METHOD(GetPlayerString, METH_VARARGS),
+	METHOD(GetResourceCacheStats, METH_NOARGS),
 	METHOD(GetRumour, METH_VARARGS),
 	METHOD(GetSaveGames, METH_VARARGS),
+	METHOD(GetSaveProgress, METH_NOARGS),
 	METHOD(GetSelectedSize, METH_NOARGS),
 	METHOD(GetSelectedActors, METH_NOARGS),
 	METHOD(GetString, METH_VARARGS),
@@ -13077,7 +13297,9 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(GetSlots, METH_VARARGS),
 	METHOD(GetSystemVariable, METH_VARARGS),
 	METHOD(GetToken, METH_VARARGS),
+	METHOD(GetTriggerMemoStats, METH_NOARGS),
 	METHOD(GetVar, METH_VARARGS),
+	METHOD(GetVideoStats, METH_NOARGS),
 	METHOD(GetView, METH_VARARGS),
 	METHOD(HardEndPL, METH_NOARGS),
 	METHOD(HasFeat, METH_VARARGS),
@@ -13117,6 +13339,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(SaveCharacter, METH_VARARGS),
 	METHOD(SaveGame, METH_VARARGS),
 	METHOD(SaveConfig, METH_NOARGS),
+	METHOD(SaveScreenshot, METH_VARARGS),
 	METHOD(SetDefaultActions, METH_VARARGS),
 	METHOD(SetEquippedQuickSlot, METH_VARARGS),
 	METHOD(SetFeat, METH_VARARGS),
@@ -13124,6 +13347,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(SetFullScreen, METH_VARARGS),
 	METHOD(SetGamma, METH_VARARGS),
 	METHOD(SetGlobal, METH_VARARGS),
+	METHOD(SetHierarchicalPathfinding, METH_VARARGS),
 	METHOD(SetJournalEntry, METH_VARARGS),
 	METHOD(SetMapAnimation, METH_VARARGS),
 	METHOD(SetMapDoor, METH_VARARGS),
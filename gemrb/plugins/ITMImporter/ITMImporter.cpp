@@ -23,6 +23,7 @@
 #include "EffectMgr.h"
 #include "Interface.h"
 #include "PluginMgr.h"
+#include "Streams/SpanReader.h"
 #include "SymbolMgr.h"
 #include "TableMgr.h" //needed for autotable
 
@@ -142,76 +143,86 @@ Item* ITMImporter::GetItem(Item *s)
 	if( !s) {
 		return NULL;
 	}
-	str->ReadStrRef(s->ItemName);
-	str->ReadStrRef(s->ItemNameIdentified);
-	str->ReadResRef( s->ReplacementItem );
-	str->ReadDword(s->Flags);
-	str->ReadWord(s->ItemType);
-	str->ReadDword(s->UsabilityBitmask);
-	str->ReadRTrimString(s->AnimationType, 2);
-	str->Read( &s->MinLevel, 1 );
-	str->Read( &s->unknown1, 1 );
-	str->Read( &s->MinStrength,1 );
-	str->Read( &s->unknown2, 1 );
-	str->Read( &s->MinStrengthBonus, 1 );
-	str->Read( &k1,1 );
-	str->Read( &s->MinIntelligence, 1 );
-	str->Read( &k2,1 );
-	str->Read( &s->MinDexterity, 1 );
-	str->Read( &k3,1 );
-	str->Read( &s->MinWisdom, 1 );
-	str->Read( &k4,1 );
+
+	// the whole header in one go, the signature was already read
+	strpos_t headerSize = 0x72;
+	if (version == ITM_VER_IWD2) {
+		headerSize = 0x82;
+	} else if (version == ITM_VER_PST) {
+		headerSize = 0x9a;
+	}
+	SpanReader header(str, headerSize - 8);
+
+	header.ReadStrRef(s->ItemName);
+	header.ReadStrRef(s->ItemNameIdentified);
+	header.ReadResRef( s->ReplacementItem );
+	header.ReadDword(s->Flags);
+	header.ReadWord(s->ItemType);
+	header.ReadDword(s->UsabilityBitmask);
+	header.ReadRTrimString(s->AnimationType, 2);
+	header.Read( &s->MinLevel, 1 );
+	header.Read( &s->unknown1, 1 );
+	header.Read( &s->MinStrength,1 );
+	header.Read( &s->unknown2, 1 );
+	header.Read( &s->MinStrengthBonus, 1 );
+	header.Read( &k1,1 );
+	header.Read( &s->MinIntelligence, 1 );
+	header.Read( &k2,1 );
+	header.Read( &s->MinDexterity, 1 );
+	header.Read( &k3,1 );
+	header.Read( &s->MinWisdom, 1 );
+	header.Read( &k4,1 );
 	s->KitUsability=(k1<<24) | (k2<<16) | (k3<<8) | k4; //bg2/iwd2 specific
-	str->Read( &s->MinConstitution, 1 );
-	str->Read( &s->WeaProf, 1 ); //bg2 specific
+	header.Read( &s->MinConstitution, 1 );
+	header.Read( &s->WeaProf, 1 ); //bg2 specific
 
 	//hack for non bg2 weapon proficiencies
 	if (!s->WeaProf) {
 		s->WeaProf = GetProficiency(s->ItemType);
 	}
 
-	str->Read( &s->MinCharisma, 1 );
-	str->Read( &s->unknown3, 1 );
-	str->ReadDword(s->Price);
-	str->ReadWord(s->MaxStackAmount);
+	header.Read( &s->MinCharisma, 1 );
+	header.Read( &s->unknown3, 1 );
+	header.ReadDword(s->Price);
+	header.ReadWord(s->MaxStackAmount);
 
 	//hack for non stacked items, so MaxStackAmount could be used as a boolean
 	if (s->MaxStackAmount==1) {
 		s->MaxStackAmount = 0;
 	}
 
-	str->ReadResRef( s->ItemIcon );
-	str->ReadWord(s->LoreToID);
-	str->ReadResRef( s->GroundIcon );
-	str->ReadDword(s->Weight);
-	str->ReadStrRef(s->ItemDesc);
-	str->ReadStrRef(s->ItemDescIdentified);
-	str->ReadResRef( s->DescriptionIcon );
-	str->ReadDword(s->Enchantment);
-	str->ReadDword(s->ExtHeaderOffset);
+	header.ReadResRef( s->ItemIcon );
+	header.ReadWord(s->LoreToID);
+	header.ReadResRef( s->GroundIcon );
+	header.ReadDword(s->Weight);
+	header.ReadStrRef(s->ItemDesc);
+	header.ReadStrRef(s->ItemDescIdentified);
+	header.ReadResRef( s->DescriptionIcon );
+	header.ReadDword(s->Enchantment);
+	header.ReadDword(s->ExtHeaderOffset);
 	ieWord headerCount;
-	str->ReadWord(headerCount);
-	str->ReadDword(s->FeatureBlockOffset);
-	str->ReadWord(s->EquippingFeatureOffset);
-	str->ReadWord(s->EquippingFeatureCount);
+	header.ReadWord(headerCount);
+	header.ReadDword(s->FeatureBlockOffset);
+	header.ReadWord(s->EquippingFeatureOffset);
+	header.ReadWord(s->EquippingFeatureCount);
 
 	s->WieldColor = 0xffff;
 	memset( s->unknown, 0, 26 );
 
 	//skipping header data for iwd2
 	if (version == ITM_VER_IWD2) {
-		str->Read( s->unknown, 16 );
+		header.Read( s->unknown, 16 );
 	}
 	if (version == ITM_VER_PST) {
 		//pst data
-		str->ReadResRef( s->Dialog );
-		str->ReadStrRef(s->DialogName);
+		header.ReadResRef( s->Dialog );
+		header.ReadStrRef(s->DialogName);
 		ieWord WieldColor;
-		str->ReadWord(WieldColor);
+		header.ReadWord(WieldColor);
 		if (s->AnimationType[0]) {
 			s->WieldColor = WieldColor;
 		}
-		str->Read( s->unknown, 26 );
+		header.Read( s->unknown, 26 );
 	} else if (dialogTable) {
 		//all non pst
 		TableMgr::index_t row = dialogTable->GetRowIndex(s->Name);
@@ -276,39 +287,40 @@ void ITMImporter::GetExtHeader(const Item *s, ITMExtHeader* eh)
 {
 	ieByte tmpByte;
 	ieWord ProjectileType;
-
-	str->Read( &eh->AttackType,1 );
-	str->Read( &eh->IDReq,1 );
-	str->Read( &eh->Location,1 );
-	str->Read(&eh->AltDiceSides, 1);
-	str->ReadResRef( eh->UseIcon );
-	str->Read( &eh->Target,1 );
-	str->Read( &tmpByte,1 );
+	SpanReader header(str, 56);
+
+	header.Read( &eh->AttackType,1 );
+	header.Read( &eh->IDReq,1 );
+	header.Read( &eh->Location,1 );
+	header.Read(&eh->AltDiceSides, 1);
+	header.ReadResRef( eh->UseIcon );
+	header.Read( &eh->Target,1 );
+	header.Read( &tmpByte,1 );
 	if (!tmpByte) {
 		tmpByte = 1;
 	}
 	eh->TargetNumber = tmpByte;
-	str->ReadWord(eh->Range);
-	str->Read(&ProjectileType, 1);
-	str->Read(&eh->AltDiceThrown, 1);
-	str->Read(&eh->Speed, 1);
-	str->Read(&eh->AltDamageBonus, 1);
-	str->ReadWord(eh->THAC0Bonus);
-	str->ReadWord(eh->DiceSides);
-	str->ReadWord(eh->DiceThrown);
-	str->ReadScalar<ieWordSigned>(eh->DamageBonus);
-	str->ReadWord(eh->DamageType);
+	header.ReadWord(eh->Range);
+	header.Read(&ProjectileType, 1);
+	header.Read(&eh->AltDiceThrown, 1);
+	header.Read(&eh->Speed, 1);
+	header.Read(&eh->AltDamageBonus, 1);
+	header.ReadWord(eh->THAC0Bonus);
+	header.ReadWord(eh->DiceSides);
+	header.ReadWord(eh->DiceThrown);
+	header.ReadScalar<ieWordSigned>(eh->DamageBonus);
+	header.ReadWord(eh->DamageType);
 	ieWord featureCount;
-	str->ReadWord(featureCount);
-	str->ReadWord(eh->FeatureOffset);
-	str->ReadWord(eh->Charges);
-	str->ReadWord(eh->ChargeDepletion);
-	str->ReadDword(eh->RechargeFlags);
+	header.ReadWord(featureCount);
+	header.ReadWord(eh->FeatureOffset);
+	header.ReadWord(eh->Charges);
+	header.ReadWord(eh->ChargeDepletion);
+	header.ReadDword(eh->RechargeFlags);
 
 	//hack for default weapon finesse
 	if (s->ItemType==IT_DAGGER || s->ItemType==IT_SHORTSWORD) eh->RechargeFlags^=IE_ITEM_USEDEXTERITY;
 
-	str->ReadWord(eh->ProjectileAnimation);
+	header.ReadWord(eh->ProjectileAnimation);
 	//for some odd reasons 0 and 1 are the same
 	if (eh->ProjectileAnimation) {
 		eh->ProjectileAnimation--;
@@ -320,16 +332,16 @@ void ITMImporter::GetExtHeader(const Item *s, ITMExtHeader* eh)
 	}
 
 	for (unsigned short& i : eh->MeleeAnimation) {
-		str->ReadWord(i);
+		header.ReadWord(i);
 	}
 
 	ieWord tmp;
 	ieDword pq = 0;
-	str->ReadWord(tmp); //arrow
+	header.ReadWord(tmp); //arrow
 	if (tmp) pq |= PROJ_ARROW;
-	str->ReadWord(tmp); //xbow
+	header.ReadWord(tmp); //xbow
 	if (tmp) pq |= PROJ_BOLT;
-	str->ReadWord(tmp); //bullet
+	header.ReadWord(tmp); //bullet
 	if (tmp) pq |= PROJ_BULLET;
 	//this hack is required for Nordom's crossbow in PST
 	if (!pq && (eh->AttackType == ITEM_AT_BOW)) {
@@ -25,8 +25,11 @@
 #include "Interface.h"
 #include "Logging/Logging.h"
 #include "ResourceDesc.h"
+#include "Streams/FileCache.h"
 #include "Streams/FileStream.h"
 
+#include <algorithm>
+
 using namespace GemRB;
 
 static path_t AddCBF(path_t file)
@@ -159,6 +162,10 @@ bool KEYImporter::Open(const path_t& resfile, std::string desc)
 		FindBIF(&be);
 		biffiles.push_back( be );
 	}
+
+	if (core->config.PrewarmCache) {
+		PrewarmCache();
+	}
 	f->Seek( ResOffset, GEM_STREAM_START );
 
 	MapKey key;
@@ -176,11 +183,29 @@ bool KEYImporter::Open(const path_t& resfile, std::string desc)
 			resources.emplace(key, ResLocator);
 	}
 
+	maxOpenBIFs = std::max(0, core->config.MaxOpenBIFs);
+	openBIFIndex.reserve(maxOpenBIFs);
+
 	Log(MESSAGE, "KEYImporter", "Resources Loaded...");
 	delete f;
 	return true;
 }
 
+void KEYImporter::PrewarmCache() const
+{
+	for (const BIFEntry& entry : biffiles) {
+		if (!entry.found) continue;
+
+		// uncompressed archives are left alone by CacheArchive
+		path_t path = entry.path;
+		CacheInBackground(ExtractFileFromPath(path), [path]() {
+			if (CacheJobsCancelled()) return;
+			PluginHolder<IndexedArchive> ai = MakePluginHolder<IndexedArchive>(IE_BIF_CLASS_ID);
+			ai->CacheArchive(path);
+		});
+	}
+}
+
 bool KEYImporter::HasResource(StringView resname, SClass_ID type)
 {
 	return resources.find({ResRef(resname), type}) != resources.cend();
@@ -191,6 +216,36 @@ bool KEYImporter::HasResource(StringView resname, const ResourceDesc &type)
 	return HasResource(resname, type.GetKeyType());
 }
 
+IndexedArchive* KEYImporter::GetArchive(unsigned int bifnum, PluginHolder<IndexedArchive>& unpooled)
+{
+	const auto cached = openBIFIndex.find(bifnum);
+	if (cached != openBIFIndex.cend()) {
+		// mark as most recently used
+		openBIFs.splice(openBIFs.begin(), openBIFs, cached->second);
+		return cached->second->plugin.get();
+	}
+
+	PluginHolder<IndexedArchive> ai = MakePluginHolder<IndexedArchive>(IE_BIF_CLASS_ID);
+	if (ai->OpenArchive(biffiles[bifnum].path) == GEM_ERROR) {
+		Log(ERROR, "KEYImporter", "Cannot open archive {}", biffiles[bifnum].path);
+		return nullptr;
+	}
+
+	// pooling disabled, the caller owns the archive for the duration of the fetch
+	if (maxOpenBIFs == 0) {
+		unpooled = std::move(ai);
+		return unpooled.get();
+	}
+
+	if (openBIFs.size() >= maxOpenBIFs) {
+		openBIFIndex.erase(openBIFs.back().bifnum);
+		openBIFs.pop_back();
+	}
+	openBIFs.emplace_front(bifnum, std::move(ai));
+	openBIFIndex[bifnum] = openBIFs.begin();
+	return openBIFs.front().plugin.get();
+}
+
 DataStream* KEYImporter::GetStream(const ResRef& resname, ieWord type)
 {
 	if (type == 0)
@@ -214,9 +269,11 @@ DataStream* KEYImporter::GetStream(const ResRef& resname, ieWord type)
 		return NULL;
 	}
 
-	PluginHolder<IndexedArchive> ai = MakePluginHolder<IndexedArchive>(IE_BIF_CLASS_ID);
-	if (ai->OpenArchive(biffiles[bifnum].path) == GEM_ERROR) {
-		Log(ERROR, "KEYImporter", "Cannot open archive {}", biffiles[bifnum].path);
+	// the archive streams are shared by the pool, so serialize access to them
+	std::lock_guard<std::mutex> lock(bifMutex);
+	PluginHolder<IndexedArchive> unpooled;
+	IndexedArchive* ai = GetArchive(bifnum, unpooled);
+	if (!ai) {
 		return NULL;
 	}
 
@@ -28,6 +28,8 @@
 #include "Resource.h"
 #include "System/VFS.h"
 
+#include <list>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -72,7 +74,8 @@ struct MapKeyHash {
 };
 
 struct KEYCache {
-	KEYCache() { bifnum = 0xffffffff; }
+	KEYCache(unsigned int bifnum, PluginHolder<IndexedArchive> plugin)
+	: bifnum(bifnum), plugin(std::move(plugin)) {}
 
 	unsigned int bifnum;
 	PluginHolder<IndexedArchive> plugin;
@@ -83,6 +86,16 @@ private:
 	std::vector< BIFEntry> biffiles;
 	std::unordered_map<MapKey, ieDword, MapKeyHash> resources;
 
+	/* pool of already opened and parsed archives, the front is the most recently used */
+	std::list<KEYCache> openBIFs;
+	std::unordered_map<unsigned int, std::list<KEYCache>::iterator> openBIFIndex;
+	size_t maxOpenBIFs = 0;
+	std::mutex bifMutex;
+
+	/** Returns an opened archive for the bif, reusing a pooled one if possible */
+	IndexedArchive* GetArchive(unsigned int bifnum, PluginHolder<IndexedArchive>& unpooled);
+	/** Decompresses all compressed archives into the cache in the background */
+	void PrewarmCache() const;
 	/** Gets the stream associated to a RESKey */
 	DataStream *GetStream(const ResRef&, ieWord type);
 public:
@@ -93,6 +106,7 @@ public:
 	/* returns resource */
 	DataStream* GetResource(StringView resname, SClass_ID type) override;
 	DataStream* GetResource(StringView resname, const ResourceDesc &type) override;
+	bool IsVolatile() const override { return false; }
 };
 
 }
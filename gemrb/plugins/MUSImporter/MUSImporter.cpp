@@ -34,7 +34,7 @@ MUSImporter::MUSImporter()
 {
 	str = new FileStream();
 	path_t path = PathJoin(core->config.GamePath, musicsubfolder);
-	manager.AddSource(path, "Music", PLUGIN_RESOURCE_DIRECTORY);
+	manager.AddSource(path, "Music", PLUGIN_RESOURCE_INDEXEDDIRECTORY);
 }
 
 MUSImporter::~MUSImporter()
@@ -0,0 +1,364 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "NullVideo.h"
+
+#include "Interface.h"
+#include "Video/RLE.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+using namespace GemRB;
+
+static void BlendPixel(Color& dst, Color src, BlitFlags flags)
+{
+	if (flags & BlitFlags::ADD) {
+		dst.r = std::min(dst.r + src.r * src.a / 255, 255);
+		dst.g = std::min(dst.g + src.g * src.a / 255, 255);
+		dst.b = std::min(dst.b + src.b * src.a / 255, 255);
+	} else if ((flags & BlitFlags::BLENDED) && src.a < 255) {
+		int inv = 255 - src.a;
+		dst.r = (src.r * src.a + dst.r * inv) / 255;
+		dst.g = (src.g * src.a + dst.g * inv) / 255;
+		dst.b = (src.b * src.a + dst.b * inv) / 255;
+		dst.a = src.a + dst.a * inv / 255;
+	} else {
+		dst = src;
+	}
+}
+
+static void ApplyTint(Color& c, const Color& tint, BlitFlags flags)
+{
+	if (flags & BlitFlags::COLOR_MOD) {
+		c.r = c.r * tint.r / 255;
+		c.g = c.g * tint.g / 255;
+		c.b = c.b * tint.b / 255;
+	}
+	if (flags & BlitFlags::ALPHA_MOD) {
+		c.a = c.a * tint.a / 255;
+	}
+}
+
+NullVideoBuffer::NullVideoBuffer(const Region& r, bool software)
+: VideoBuffer(r)
+{
+	if (software) {
+		pixels.resize(r.w * r.h);
+	}
+}
+
+Color* NullVideoBuffer::PixelAt(const Point& p)
+{
+	if (pixels.empty() || p.x < 0 || p.y < 0 || p.x >= rect.w || p.y >= rect.h) {
+		return nullptr;
+	}
+	return &pixels[p.y * rect.w + p.x];
+}
+
+const Color* NullVideoBuffer::PixelAt(const Point& p) const
+{
+	return const_cast<NullVideoBuffer*>(this)->PixelAt(p);
+}
+
+void NullVideoBuffer::Clear(const Region& rgn)
+{
+	if (pixels.empty()) return;
+
+	Region r = rgn.Intersect(Region(Point(), rect.size));
+	for (int y = r.y; y < r.y + r.h; ++y) {
+		std::fill_n(pixels.begin() + y * rect.w + r.x, r.w, Color());
+	}
+}
+
+void NullVideoBuffer::CopyPixels(const Region&, const void*, const int*, ...)
+{
+	// only the movie players stream pixels in and there is nobody to watch them
+}
+
+bool NullVideoBuffer::RenderOnDisplay(void* display) const
+{
+	auto* screen = static_cast<NullVideoBuffer*>(display);
+	if (pixels.empty() || !screen) return true;
+
+	for (int y = 0; y < rect.h; ++y) {
+		for (int x = 0; x < rect.w; ++x) {
+			Color* dst = screen->PixelAt(rect.origin + Point(x, y));
+			if (!dst) continue;
+			BlendPixel(*dst, pixels[y * rect.w + x], BlitFlags::BLENDED);
+		}
+	}
+	return true;
+}
+
+int NullVideo::Init()
+{
+	return GEM_OK;
+}
+
+int NullVideo::CreateDriverDisplay(const char*, bool)
+{
+	software = core->config.HeadlessFramebuffer;
+	framebuffer = std::make_unique<NullVideoBuffer>(Region(Point(), screenSize), software);
+	Log(MESSAGE, "NullVideo", "Running headless, software rendering: {}", software);
+	return GEM_OK;
+}
+
+bool NullVideo::SetFullscreenMode(bool set)
+{
+	fullscreen = set;
+	return true;
+}
+
+VideoBuffer* NullVideo::NewVideoBuffer(const Region& r, BufferFormat)
+{
+	return new NullVideoBuffer(r, software);
+}
+
+void NullVideo::SwapBuffers(VideoBuffers& buffers)
+{
+	if (!software) return;
+
+	framebuffer->Clear();
+	for (const VideoBuffer* buffer : buffers) {
+		buffer->RenderOnDisplay(framebuffer.get());
+	}
+}
+
+int NullVideo::PollEvents()
+{
+	// there is no input, the game runs until the scripts quit it
+	return GEM_OK;
+}
+
+void NullVideo::Wait(uint32_t w)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(w));
+}
+
+Holder<Sprite2D> NullVideo::CreateSprite(const Region& rgn, void* pixels, const PixelFormat& fmt)
+{
+	// decode like the SDL2 driver does, so both pay the same for sprite creation
+	if (fmt.RLE) {
+		void* newpixels = DecodeRLEData(static_cast<uint8_t*>(pixels), rgn.size, fmt.ColorKey);
+		free(pixels);
+		PixelFormat newfmt = fmt;
+		newfmt.RLE = false;
+		return MakeHolder<Sprite2D>(rgn, newpixels, newfmt, rgn.w * newfmt.Bpp);
+	}
+	return MakeHolder<Sprite2D>(rgn, pixels, fmt, rgn.w * fmt.Bpp);
+}
+
+NullVideoBuffer* NullVideo::Target() const
+{
+	auto* target = static_cast<NullVideoBuffer*>(drawingBuffer);
+	if (!target || !target->HasPixels()) return nullptr;
+	return target;
+}
+
+void NullVideo::Plot(NullVideoBuffer* target, const Point& p, const Color& color, BlitFlags flags) const
+{
+	if (!screenClip.PointInside(p)) return;
+	Color* dst = target->PixelAt(p);
+	if (dst) {
+		BlendPixel(*dst, color, flags);
+	}
+}
+
+void NullVideo::BlitSprite(const Holder<Sprite2D>& spr, const Region& src, Region dst,
+						   BlitFlags flags, Color tint)
+{
+	NullVideoBuffer* target = Target();
+	if (!target) return;
+
+	dst.origin -= spr->Frame.origin;
+	int w = std::min(src.w, dst.w);
+	int h = std::min(src.h, dst.h);
+	for (int y = 0; y < h; ++y) {
+		int sy = (flags & BlitFlags::MIRRORY) ? src.y + src.h - 1 - y : src.y + y;
+		for (int x = 0; x < w; ++x) {
+			int sx = (flags & BlitFlags::MIRRORX) ? src.x + src.w - 1 - x : src.x + x;
+			Color c = spr->GetPixel(Point(sx, sy));
+			if (c.a == 0) continue;
+
+			ApplyTint(c, tint, flags);
+			if (flags & BlitFlags::HALFTRANS) {
+				c.a /= 2;
+			}
+			Plot(target, dst.origin + Point(x, y), c, flags);
+		}
+	}
+}
+
+void NullVideo::BlitGameSprite(const Holder<Sprite2D>& spr, const Point& p,
+							   BlitFlags flags, Color tint)
+{
+	Region src(Point(), spr->Frame.size);
+	BlitSprite(spr, src, Region(p, spr->Frame.size), flags, tint);
+}
+
+void NullVideo::BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p, BlitFlags flags, Color tint)
+{
+	NullVideoBuffer* target = Target();
+	if (!target) return;
+
+	const auto* source = static_cast<const NullVideoBuffer*>(buf.get());
+	const Size size = source->Size();
+	for (int y = 0; y < size.h; ++y) {
+		for (int x = 0; x < size.w; ++x) {
+			const Color* px = source->PixelAt(Point(x, y));
+			if (!px) continue;
+			Color c = *px;
+			ApplyTint(c, tint, flags);
+			Plot(target, p + Point(x, y), c, flags | BlitFlags::BLENDED);
+		}
+	}
+}
+
+Holder<Sprite2D> NullVideo::GetScreenshot(Region r, const VideoBufferPtr& buf)
+{
+	int width = r.w ? r.w : screenSize.w;
+	int height = r.h ? r.h : screenSize.h;
+	const NullVideoBuffer* source = buf ? static_cast<const NullVideoBuffer*>(buf.get()) : framebuffer.get();
+
+	// black if nothing was rendered
+	uint32_t* pixels = static_cast<uint32_t*>(calloc(width * height, 4));
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const Color* c = source ? source->PixelAt(r.origin + Point(x, y)) : nullptr;
+			if (!c) continue;
+			pixels[y * width + x] = c->r + (c->g << 8) + (c->b << 16) + (0xffu << 24);
+		}
+	}
+
+	static const PixelFormat fmt(4, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
+	return CreateSprite(Region(0, 0, width, height), pixels, fmt);
+}
+
+void NullVideo::DrawRectImp(const Region& rgn, const Color& color, bool fill, BlitFlags flags)
+{
+	NullVideoBuffer* target = Target();
+	if (!target) return;
+
+	if (fill) {
+		for (int y = rgn.y; y < rgn.y + rgn.h; ++y) {
+			for (int x = rgn.x; x < rgn.x + rgn.w; ++x) {
+				Plot(target, Point(x, y), color, flags);
+			}
+		}
+		return;
+	}
+
+	const Point br(rgn.x + rgn.w - 1, rgn.y + rgn.h - 1);
+	DrawLinesImp({ rgn.origin, Point(br.x, rgn.y), br, Point(rgn.x, br.y), rgn.origin }, color, flags);
+}
+
+void NullVideo::DrawPointImp(const Point& p, const Color& color, BlitFlags flags)
+{
+	NullVideoBuffer* target = Target();
+	if (!target) return;
+	Plot(target, p, color, flags);
+}
+
+void NullVideo::DrawPointsImp(const std::vector<Point>& points, const Color& color, BlitFlags flags)
+{
+	NullVideoBuffer* target = Target();
+	if (!target) return;
+	for (const Point& p : points) {
+		Plot(target, p, color, flags);
+	}
+}
+
+void NullVideo::DrawCircleImp(const Point& origin, uint16_t r, const Color& color, BlitFlags flags)
+{
+	if (!Target()) return;
+	DrawPointsImp(PlotCircle(origin, r, 0xff), color, flags);
+}
+
+void NullVideo::DrawEllipseImp(const Region& rect, const Color& color, BlitFlags flags)
+{
+	if (!Target()) return;
+	DrawPointsImp(PlotEllipse(rect), color, flags);
+}
+
+void NullVideo::DrawPolygonImp(const Gem_Polygon* poly, const Point& origin, const Color& color, bool fill, BlitFlags flags)
+{
+	if (!Target()) return;
+
+	if (fill) {
+		for (const auto& lineSegments : poly->rasterData) {
+			for (const auto& segment : lineSegments) {
+				DrawLineImp(segment.first + origin, segment.second + origin, color, flags);
+			}
+		}
+		return;
+	}
+
+	std::vector<Point> points;
+	points.reserve(poly->Count() + 1);
+	for (const Point& vertex : poly->vertices) {
+		points.push_back(vertex - poly->BBox.origin + origin);
+	}
+	// close the polygon with first point
+	points.push_back(points.front());
+	DrawLinesImp(points, color, flags);
+}
+
+void NullVideo::DrawLineImp(const Point& p1, const Point& p2, const Color& color, BlitFlags flags)
+{
+	NullVideoBuffer* target = Target();
+	if (!target) return;
+
+	// Bresenham
+	int dx = std::abs(p2.x - p1.x);
+	int dy = -std::abs(p2.y - p1.y);
+	int sx = p1.x < p2.x ? 1 : -1;
+	int sy = p1.y < p2.y ? 1 : -1;
+	int err = dx + dy;
+	Point p = p1;
+	while (true) {
+		Plot(target, p, color, flags);
+		if (p == p2) break;
+		int e2 = 2 * err;
+		if (e2 >= dy) {
+			err += dy;
+			p.x += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			p.y += sy;
+		}
+	}
+}
+
+void NullVideo::DrawLinesImp(const std::vector<Point>& points, const Color& color, BlitFlags flags)
+{
+	if (!Target()) return;
+	for (size_t i = 1; i < points.size(); ++i) {
+		DrawLineImp(points[i - 1], points[i], color, flags);
+	}
+}
+
+#include "plugindef.h"
+
+GEMRB_PLUGIN(0x6C2A81E, "Null Video Driver")
+PLUGIN_DRIVER(NullVideo, "none")
+END_PLUGIN()
@@ -0,0 +1,107 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef NULLVIDEO_H
+#define NULLVIDEO_H
+
+#include "Video/Video.h"
+
+#include <memory>
+#include <vector>
+
+namespace GemRB {
+
+// pixels are only kept when software rendering, otherwise the buffer is just its region
+class NullVideoBuffer : public VideoBuffer {
+	std::vector<Color> pixels;
+
+public:
+	NullVideoBuffer(const Region& r, bool software);
+
+	using VideoBuffer::Clear;
+	void Clear(const Region& rgn) override;
+	void CopyPixels(const Region& bufDest, const void* pixelBuf, const int* pitch = nullptr, ...) override;
+	// display is the NullVideoBuffer used as framebuffer
+	bool RenderOnDisplay(void* display) const override;
+
+	bool HasPixels() const { return !pixels.empty(); }
+	// nullptr outside of the buffer
+	Color* PixelAt(const Point& p);
+	const Color* PixelAt(const Point& p) const;
+};
+
+/**
+ * Headless video driver: no window, no input and no frame pacing by the display.
+ * Everything is accepted and dropped, unless HeadlessFramebuffer is set, in which
+ * case drawing is done in software, so screenshots show what would be on screen.
+ */
+class NullVideo : public Video {
+public:
+	int Init() override;
+
+	void SetWindowTitle(const char*) override {}
+	bool SetFullscreenMode(bool set) override;
+	bool ToggleGrabInput() override { return false; }
+	void CaptureMouse(bool) override {}
+	int GetDisplayRefreshRate() const override { return 0; }
+	int GetVirtualRefreshCap() const override { return 0; }
+
+	void StartTextInput() override {}
+	void StopTextInput() override {}
+	bool InTextInput() override { return false; }
+	bool TouchInputEnabled() override { return false; }
+
+	Holder<Sprite2D> CreateSprite(const Region&, void* pixels, const PixelFormat&) override;
+	void BlitSprite(const Holder<Sprite2D>& spr, const Region& src, Region dst,
+					BlitFlags flags, Color tint = Color()) override;
+	void BlitGameSprite(const Holder<Sprite2D>& spr, const Point& p,
+						BlitFlags flags, Color tint = Color()) override;
+	void BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p, BlitFlags flags,
+						 Color tint = Color()) override;
+
+	Holder<Sprite2D> GetScreenshot(Region r, const VideoBufferPtr& buf = nullptr) override;
+	void SetGamma(int, int) override {}
+
+private:
+	bool software = false;
+	std::unique_ptr<NullVideoBuffer> framebuffer;
+
+	VideoBuffer* NewVideoBuffer(const Region&, BufferFormat) override;
+	void SwapBuffers(VideoBuffers&) override;
+	int PollEvents() override;
+	int CreateDriverDisplay(const char* title, bool vsync) override;
+	void Wait(uint32_t w) override;
+
+	void DrawRectImp(const Region& rgn, const Color& color, bool fill, BlitFlags flags) override;
+	void DrawPointImp(const Point&, const Color& color, BlitFlags flags) override;
+	void DrawPointsImp(const std::vector<Point>& points, const Color& color, BlitFlags flags) override;
+	void DrawCircleImp(const Point& origin, uint16_t r, const Color& color, BlitFlags flags) override;
+	void DrawEllipseImp(const Region& rect, const Color& color, BlitFlags flags) override;
+	void DrawPolygonImp(const Gem_Polygon* poly, const Point& origin, const Color& color, bool fill, BlitFlags flags) override;
+	void DrawLineImp(const Point& p1, const Point& p2, const Color& color, BlitFlags flags) override;
+	void DrawLinesImp(const std::vector<Point>& points, const Color& color, BlitFlags flags) override;
+
+	// the drawing buffer, if there is anything to draw into
+	NullVideoBuffer* Target() const;
+	void Plot(NullVideoBuffer* target, const Point& p, const Color& color, BlitFlags flags) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,324 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "PackImporter.h"
+
+#include "Interface.h"
+#include "Logging/Logging.h"
+#include "PluginMgr.h"
+#include "ResourceDesc.h"
+#include "Streams/MappedFileMemoryStream.h"
+#include "System/swab.h"
+#include "System/VFS.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
+
+using namespace GemRB;
+
+static const char PackSignature[] = "GPAKV1  ";
+static const strpos_t HeaderSize = 32;
+static const strpos_t EntrySize = 32;
+static const size_t KeySize = 12; // resref and extension
+static const uint32_t DirectSlot = 0x80000000;
+static const uint32_t FlagDeflated = 1;
+
+template <typename T>
+static T ReadLE(const char* ptr)
+{
+	T value;
+	memcpy(&value, ptr, sizeof(T));
+	if (IsBigEndian()) {
+		swabs(&value, sizeof(T));
+	}
+	return value;
+}
+
+// the builder hashes the same way, any change here needs a new pack version
+static uint32_t PackHash(const char* key, uint32_t seed)
+{
+	uint32_t hash = 0x811C9DC5 ^ seed;
+	for (size_t i = 0; i < KeySize; ++i) {
+		hash ^= static_cast<uint8_t>(key[i]);
+		hash *= 0x01000193;
+	}
+	// FNV alone clusters on these short keys, so finish like murmur
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6B;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+static char AsciiLower(char c)
+{
+	return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+static const uint32_t FingerprintBasis = 0x811C9DC5;
+
+static uint32_t Fingerprint(uint32_t hash, const void* data, size_t length)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= bytes[i];
+		hash *= 0x01000193;
+	}
+	return hash;
+}
+
+// size and modification time, which change whenever a file is replaced
+static bool FingerprintFile(uint32_t& hash, const path_t& path)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) {
+		return false;
+	}
+
+	uint8_t buffer[16];
+	uint64_t values[2] = { uint64_t(info.st_size), uint64_t(info.st_mtime) };
+	for (size_t i = 0; i < sizeof(buffer); ++i) {
+		buffer[i] = uint8_t(values[i / 8] >> (8 * (i % 8)));
+	}
+	hash = Fingerprint(hash, buffer, sizeof(buffer));
+	return true;
+}
+
+// the builder computes both the same way and stores them in the header, 0 means unknown
+static uint32_t KeyFingerprint(const path_t& keyFile)
+{
+	uint32_t hash = FingerprintBasis;
+	if (!FingerprintFile(hash, keyFile)) {
+		return 0;
+	}
+	return hash ? hash : 1;
+}
+
+static uint32_t OverrideFingerprint(const path_t& overrideDir)
+{
+	std::vector<std::pair<path_t, path_t>> files;
+	DirectoryIterator it(overrideDir);
+	it.SetFlags(DirectoryIterator::Files, true);
+	for (; it; ++it) {
+		path_t name = it.GetName();
+		path_t lower = name;
+		std::transform(lower.begin(), lower.end(), lower.begin(), AsciiLower);
+		files.emplace_back(std::move(lower), std::move(name));
+	}
+	std::sort(files.begin(), files.end());
+
+	uint32_t hash = FingerprintBasis;
+	for (const auto& file : files) {
+		// including the NUL
+		hash = Fingerprint(hash, file.first.c_str(), file.first.length() + 1);
+		if (!FingerprintFile(hash, PathJoin<false>(overrideDir, file.second))) {
+			return 0;
+		}
+	}
+	return hash ? hash : 1;
+}
+
+namespace GemRB {
+
+// a window into the mapped pack, which it keeps alive
+class PackStream : public MemoryStream {
+	std::shared_ptr<MappedFileMemoryStream> pack;
+
+public:
+	PackStream(std::shared_ptr<MappedFileMemoryStream> pack, const path_t& name, const char* start, strpos_t size)
+	: MemoryStream(name, const_cast<char*>(start), size), pack(std::move(pack)) {}
+	PackStream(const PackStream&) = delete;
+	~PackStream() override
+	{
+		data = nullptr; // the mapping isn't ours to free
+	}
+	PackStream& operator=(const PackStream&) = delete;
+
+	DataStream* Clone() const noexcept override
+	{
+		return new PackStream(pack, originalfile, data, size);
+	}
+
+	strret_t Write(const void*, strpos_t) override
+	{
+		return Error;
+	}
+};
+
+}
+
+bool PackImporter::Open(const path_t& filename, std::string desc)
+{
+#if defined(SUPPORTS_MEMSTREAM)
+	description = std::move(desc);
+	auto file = std::make_shared<MappedFileMemoryStream>(filename);
+	if (!file->isOk()) {
+		return false;
+	}
+
+	const char* data = file->RawData();
+	strpos_t size = file->Size();
+	if (size < HeaderSize || strncmp(data, PackSignature, 8) != 0) {
+		Log(ERROR, "PackImporter", "'{}' is not a content pack.", filename);
+		return false;
+	}
+
+	entryCount = ReadLE<uint32_t>(data + 8);
+	bucketCount = ReadLE<uint32_t>(data + 12);
+	uint64_t bucketOffset = ReadLE<uint32_t>(data + 16);
+	uint64_t entryOffset = ReadLE<uint32_t>(data + 20);
+	keyFingerprint = ReadLE<uint32_t>(data + 24);
+	overrideFingerprint = ReadLE<uint32_t>(data + 28);
+	if ((entryCount && !bucketCount) || bucketOffset + bucketCount * 4ull > size || entryOffset + entryCount * uint64_t(EntrySize) > size) {
+		Log(ERROR, "PackImporter", "The index of '{}' is corrupt.", filename);
+		return false;
+	}
+
+	// a stale pack would hide whatever was installed after building it
+	if (core && !MatchesInstall(PathJoin(core->config.GamePath, "chitin.key"), PathJoin(core->config.GamePath, core->config.GameOverridePath))) {
+		Log(WARNING, "PackImporter", "Skipping {}, the game changed since it was built. Rebuild it with tools/make_content_pack.py.", filename);
+		return false;
+	}
+
+	buckets = data + bucketOffset;
+	entries = data + entryOffset;
+	pack = std::move(file);
+	// stays empty if the plugin is missing, only deflated entries need it
+	compressor = MakePluginHolder<Compressor>(PLUGIN_COMPRESSION_ZLIB);
+	Log(MESSAGE, "PackImporter", "Opened {} with {} resources.", filename, entryCount);
+	return true;
+#else
+	Log(ERROR, "PackImporter", "Content packs need memory mapped files, which this build lacks.");
+	return false;
+#endif
+}
+
+bool PackImporter::MatchesInstall(const path_t& keyFile, const path_t& overrideDir) const
+{
+	// packs without fingerprints and files we can't check get the benefit of the doubt
+	if (keyFingerprint) {
+		uint32_t current = KeyFingerprint(keyFile);
+		if (current && current != keyFingerprint) {
+			return false;
+		}
+	}
+	if (overrideFingerprint) {
+		uint32_t current = OverrideFingerprint(overrideDir);
+		if (current && current != overrideFingerprint) {
+			return false;
+		}
+	}
+	return true;
+}
+
+const char* PackImporter::FindEntry(StringView resname, const path_t& ext) const
+{
+	if (!entryCount || resname.length() > 8 || ext.length() > 4) {
+		return nullptr;
+	}
+
+	char key[KeySize] {};
+	for (size_t i = 0; i < resname.length(); ++i) {
+		key[i] = AsciiLower(resname[i]);
+	}
+	for (size_t i = 0; i < ext.length(); ++i) {
+		key[8 + i] = AsciiLower(ext[i]);
+	}
+
+	uint32_t displacement = ReadLE<uint32_t>(buckets + 4 * (PackHash(key, 0) % bucketCount));
+	uint32_t slot;
+	if (displacement & DirectSlot) {
+		slot = displacement & ~DirectSlot;
+	} else {
+		slot = PackHash(key, displacement) % entryCount;
+	}
+	if (slot >= entryCount) {
+		return nullptr;
+	}
+
+	// keys outside the pack land on some slot too
+	const char* entry = entries + slot * EntrySize;
+	return memcmp(entry, key, KeySize) == 0 ? entry : nullptr;
+}
+
+DataStream* PackImporter::GetStream(StringView resname, const path_t& ext) const
+{
+	const char* entry = FindEntry(resname, ext);
+	if (!entry) {
+		return nullptr;
+	}
+
+	uint32_t flags = ReadLE<uint32_t>(entry + 12);
+	uint64_t offset = ReadLE<uint64_t>(entry + 16);
+	uint32_t storedSize = ReadLE<uint32_t>(entry + 24);
+	uint32_t size = ReadLE<uint32_t>(entry + 28);
+	path_t name = fmt::format("{}.{}", resname, ext);
+	if (offset + storedSize > pack->Size()) {
+		Log(ERROR, "PackImporter", "{} points past the end of {}.", name, description);
+		return nullptr;
+	}
+
+	if (!(flags & FlagDeflated)) {
+		return new PackStream(pack, name, pack->RawData() + offset, storedSize);
+	}
+
+	if (!compressor) {
+		Log(ERROR, "PackImporter", "Cannot inflate {} from {} without a zlib compressor.", name, description);
+		return nullptr;
+	}
+	auto stored = new PackStream(pack, name, pack->RawData() + offset, storedSize);
+	auto inflated = new MemoryStream(name, malloc(size), size);
+	bool ok = compressor->Decompress(inflated, stored, storedSize) == GEM_OK && inflated->GetPos() == size;
+	delete stored;
+	if (!ok) {
+		Log(ERROR, "PackImporter", "Cannot inflate {} from {}.", name, description);
+		delete inflated;
+		return nullptr;
+	}
+	inflated->Rewind();
+	return inflated;
+}
+
+bool PackImporter::HasResource(StringView resname, SClass_ID type)
+{
+	return FindEntry(resname, TypeExt(type)) != nullptr;
+}
+
+bool PackImporter::HasResource(StringView resname, const ResourceDesc &type)
+{
+	return FindEntry(resname, type.GetExt()) != nullptr;
+}
+
+DataStream* PackImporter::GetResource(StringView resname, SClass_ID type)
+{
+	return GetStream(resname, TypeExt(type));
+}
+
+DataStream* PackImporter::GetResource(StringView resname, const ResourceDesc &type)
+{
+	return GetStream(resname, type.GetExt());
+}
+
+#include "plugindef.h"
+
+GEMRB_PLUGIN(0x5A3C71E2, "Content Pack Importer")
+PLUGIN_CLASS(PLUGIN_RESOURCE_PACK, PackImporter)
+END_PLUGIN()
@@ -0,0 +1,84 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef PACKIMPORTER_H
+#define PACKIMPORTER_H
+
+#include "Compressor.h"
+#include "ResourceSource.h"
+
+#include <memory>
+
+namespace GemRB {
+
+class MappedFileMemoryStream;
+
+/**
+ * @class PackImporter
+ * Serves a content pack, the resolved resources of a game install in a single
+ * memory mapped file, as built by tools/make_content_pack.py. All values are
+ * little endian:
+ *
+ * header (32 bytes): "GPAKV1  ", entry count, bucket count, bucket offset,
+ *   entry offset, chitin.key fingerprint and override fingerprint
+ * buckets: one dword displacement per bucket
+ * entries (32 bytes each): char resref[8], char ext[4] (both lowercase and
+ *   NUL padded), dword flags (1 = zlib), qword data offset, dword stored size,
+ *   dword size
+ *
+ * The entries form a minimal perfect hash table: a key hashes to a bucket,
+ * whose displacement either seeds a second hash picking the slot or, with the
+ * top bit set, is the slot itself. The slot is then compared to the key, so a
+ * lookup costs two hashes and no probing.
+ *
+ * The fingerprints hash the size and modification time of chitin.key and of
+ * every file in the override directory (0 if unknown), so packs built before
+ * the last mod install are skipped instead of shadowing the new files.
+ */
+class PackImporter : public ResourceSource {
+private:
+	std::shared_ptr<MappedFileMemoryStream> pack;
+	PluginHolder<Compressor> compressor;
+	const char* buckets = nullptr;
+	const char* entries = nullptr;
+	uint32_t bucketCount = 0;
+	uint32_t entryCount = 0;
+	uint32_t keyFingerprint = 0;
+	uint32_t overrideFingerprint = 0;
+
+	const char* FindEntry(StringView resname, const path_t& ext) const;
+	DataStream* GetStream(StringView resname, const path_t& ext) const;
+
+public:
+	bool Open(const path_t& filename, std::string description) override;
+	/** false if the pack was built from a different chitin.key or override directory */
+	bool MatchesInstall(const path_t& keyFile, const path_t& overrideDir) const;
+	/** inflates the deflated entries, Open picks the zlib plugin if there is one */
+	void SetCompressor(PluginHolder<Compressor> comp) { compressor = std::move(comp); }
+	bool HasResource(StringView resname, SClass_ID type) override;
+	bool HasResource(StringView resname, const ResourceDesc &type) override;
+	DataStream* GetResource(StringView resname, SClass_ID type) override;
+	DataStream* GetResource(StringView resname, const ResourceDesc &type) override;
+	/** packs are built offline and never change */
+	bool IsVolatile() const override { return false; }
+};
+
+}
+
+#endif
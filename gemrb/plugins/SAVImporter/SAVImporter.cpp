@@ -22,6 +22,12 @@
 #include "Interface.h"
 #include "Logging/Logging.h"
 #include "PluginMgr.h"
+#include "Streams/FileCache.h"
+#include "Streams/MemoryStream.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
 
 using namespace GemRB;
 
@@ -38,12 +44,16 @@ int SAVImporter::DecompressSaveGame(DataStream *compressed, SaveGameAREExtractor
 	size_t last_percent = 20;
 	if (!All) return GEM_ERROR;
 
+	std::vector<path_t> pending;
+	auto failed = std::make_shared<std::atomic_bool>(false);
+
 	do {
 		ieDword fnlen, complen, declen;
 		compressed->ReadDword(fnlen);
 		if (!fnlen) {
 			Log(ERROR, "SAVImporter", "Corrupt Save Detected");
-			return GEM_ERROR;
+			failed->store(true);
+			break;
 		}
 		std::string fname(fnlen, '\0');
 		compressed->Read(&fname[0], fnlen);
@@ -61,12 +71,26 @@ int SAVImporter::DecompressSaveGame(DataStream *compressed, SaveGameAREExtractor
 			areExtractor.registerLocation(fname.substr(0, pos), position);
 			compressed->Seek(complen, GEM_CURRENT_POS);
 		} else {
-			Log(MESSAGE, "SAVImporter", "Decompressing {}", fname);
-			DataStream* cached = CacheCompressedStream(compressed, fname, complen, true);
-
-			if (!cached)
-				return GEM_ERROR;
-			delete cached;
+			// only the reading is sequential, the entries are inflated on the workers
+			void* data = malloc(complen);
+			if (compressed->Read(data, complen) != complen) {
+				free(data);
+				Log(ERROR, "SAVImporter", "Corrupt Save Detected");
+				failed->store(true);
+				break;
+			}
+			auto entry = std::make_shared<MemoryStream>(fname, data, complen);
+			// a repeated entry still replaces the earlier one
+			WaitForCacheFile(fname);
+			CacheInBackground(fname, [entry, fname, complen, failed]() {
+				Log(MESSAGE, "SAVImporter", "Decompressing {}", fname);
+				DataStream* cached = CacheCompressedStream(entry.get(), fname, complen, true);
+				if (!cached) {
+					failed->store(true);
+				}
+				delete cached;
+			});
+			pending.push_back(fname);
 		}
 
 		Current = compressed->Remains();
@@ -79,7 +103,11 @@ int SAVImporter::DecompressSaveGame(DataStream *compressed, SaveGameAREExtractor
 	}
 	while(Current);
 
-	return GEM_OK;
+	// everything has to be in the cache before the game is loaded from it
+	for (const auto& fname : pending) {
+		WaitForCacheFile(fname);
+	}
+	return failed->load() ? GEM_ERROR : GEM_OK;
 }
 
 //this one can create .sav files only
@@ -95,6 +95,7 @@ SDL20VideoDriver::~SDL20VideoDriver() noexcept
 
 	// we must release all buffers before SDL_DestroyRenderer
 	// we cant rely on the base destructor here
+	atlas = nullptr;
 	scratchBuffer = nullptr;
 	DestroyBuffers();
 
@@ -207,6 +208,10 @@ int SDL20VideoDriver::CreateSDLDisplay(const char* title, bool vsync)
 		return GEM_ERROR;
 	}
 
+	if (core->config.SpriteAtlas) {
+		atlas = std::make_unique<SDLTextureAtlas>(renderer);
+	}
+
 #if USE_OPENGL_BACKEND
 	// glGetString can return null, fmt doesn't support const unsigned char* and std::string can handle neither
 	std::string tmp[4] = { "/" };
@@ -307,6 +312,9 @@ void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 {
 #if USE_OPENGL_BACKEND
 	// we have coopted SDLs shader, so we need to reset uniforms to values appropriate for the render targets
+	// once the queued copies have used the current ones
+	FlushRenderer();
+	shaderStateSet = false;
 	blitRGBAShader->SetUniformValue("u_greyMode", 1, 0);
 	blitRGBAShader->SetUniformValue("u_stencil", 1, 0);
 	blitRGBAShader->SetUniformValue("u_dither", 1, 0);
@@ -329,6 +337,11 @@ void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 		TRACY(ZoneScopedN("SDL_RenderPresent"));
 		SDL_RenderPresent( renderer );
 	}
+	lastFrameStats = frameStats;
+	frameStats = FrameStats();
+	lastTexture = nullptr;
+	batchTarget = nullptr;
+	BreakBatch();
 #if USE_OPENGL_BACKEND
 	TRACY(TracyGpuCollect);
 #endif
@@ -361,6 +374,13 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 	SDL_Texture* target = CurrentRenderBuffer();
 
 	assert(target);
+	// the renderer can't merge draws across target or clip changes, nor with primitives
+	// the target may also have been switched behind our back by a buffer clear
+	if (color || target != batchTarget || SDL_GetRenderTarget(renderer) != target || screenClip != batchClip) {
+		BreakBatch();
+		batchTarget = target;
+		batchClip = screenClip;
+	}
 	int ret = SDL_SetRenderTarget(renderer, target);
 	if (ret != 0) {
 		Log(ERROR, "SDLVideo", "{}", SDL_GetError());
@@ -394,8 +414,9 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 void SDL20VideoDriver::BlitSpriteNativeClipped(const SDLTextureSprite2D* spr, const Region& src, const Region& dst, BlitFlags flags, const SDL_Color* tint)
 {
 	flags &= ~spr->PrepareForRendering(flags, reinterpret_cast<const Color*>(tint));
-	SDL_Texture* tex = spr->GetTexture(renderer);
-	BlitSpriteNativeClipped(tex, src, dst, flags, tint);
+	SDL_Point offset;
+	SDL_Texture* tex = spr->GetTexture(renderer, atlas.get(), offset);
+	BlitSpriteNativeClipped(tex, Region(src.x + offset.x, src.y + offset.y, src.w, src.h), dst, flags, tint);
 }
 
 void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Region& srgn, const Region& drgn, BlitFlags flags, const SDL_Color* tint)
@@ -408,9 +429,6 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 #if USE_OPENGL_BACKEND
 	UpdateRenderTarget();
 	ret = RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
-#if SDL_VERSION_ATLEAST(2, 0, 10)
-	SDL_RenderFlush(renderer);
-#endif
 #else
 	if (flags & BlitFlags::STENCIL_MASK) {
 		// 1. clear scratchpad segment
@@ -419,6 +437,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		// 4. copy scratchpad segment to screen
 
 		std::static_pointer_cast<SDLTextureVideoBuffer>(scratchBuffer)->Clear(drect); // sets the render target to the scratch buffer
+		BreakBatch();
 
 		SDL_Texture* stencilTex = CurrentStencilBuffer();
 		SDL_SetTextureBlendMode(stencilTex, stencilAlphaBlender);
@@ -427,6 +446,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		SDL_Rect stencilRect = drect;
 		stencilRect.x -= stencilBuffer->Origin().x;
 		stencilRect.y -= stencilBuffer->Origin().y;
+		CountDraw(stencilTex);
 		SDL_RenderCopy(renderer, stencilTex, &stencilRect, &drect);
 
 		if (flags & (BlitFlags::ALPHA_MOD | BlitFlags::HALFTRANS)) {
@@ -441,7 +461,9 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 			SDL_SetTextureAlphaMod(ScratchBuffer(), alpha);
 		}
 		SDL_SetRenderTarget(renderer, CurrentRenderBuffer());
+		BreakBatch();
 		SetTextureBlendMode(ScratchBuffer(), flags);
+		CountDraw(ScratchBuffer());
 		ret = SDL_RenderCopy(renderer, ScratchBuffer(), &drect, &drect);
 	} else {
 		UpdateRenderTarget();
@@ -465,55 +487,64 @@ void SDL20VideoDriver::BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p
 	BlitSpriteNativeClipped(tex, srect, drect, flags, reinterpret_cast<const SDL_Color*>(&tint));
 }
 
-int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* srcrect,
-									   const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* tint)
+void SDL20VideoDriver::CountDraw(SDL_Texture* texture)
+{
+	frameStats.copies++;
+	if (texture != lastTexture) {
+		frameStats.textureBinds++;
+		lastTexture = texture;
+	}
+
+	// consecutive copies with the same texture and blending end up in one draw
+	SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+	SDL_GetTextureBlendMode(texture, &blendMode);
+	if (texture != batchTexture || blendMode != batchBlendMode) {
+		frameStats.drawCalls++;
+		batchTexture = texture;
+		batchBlendMode = blendMode;
+	}
+}
+
+void SDL20VideoDriver::FlushRenderer()
 {
-#if USE_OPENGL_BACKEND
 #if SDL_VERSION_ATLEAST(2, 0, 10)
 	SDL_RenderFlush(renderer);
 #endif
+	BreakBatch();
+}
 
+int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* srcrect,
+									   const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* tint)
+{
+#if USE_OPENGL_BACKEND
+	ShaderState state;
 	uint32_t format = 0;
 	SDL_QueryTexture(texture, &format, nullptr, nullptr, nullptr);
-	blitRGBAShader->Use();
-	
-	blitRGBAShader->SetUniformValue("s_sprite", 1, 0);
-	blitRGBAShader->SetUniformValue("s_stencil", 1, 1);
-	
-	bool isRGBA = SDL_ISPIXELFORMAT_ALPHA(format);
-	blitRGBAShader->SetUniformValue("u_rgba", 1, isRGBA ? 1 : 0);
+	state.rgba = SDL_ISPIXELFORMAT_ALPHA(format) ? 1 : 0;
 
-	GLint greyMode = 0;
 	if (flags & BlitFlags::GREY) {
-		greyMode = 1;
+		state.greyMode = 1;
 	} else if (flags & BlitFlags::SEPIA) {
-		greyMode = 2;
+		state.greyMode = 2;
 	}
 
-	blitRGBAShader->SetUniformValue("u_greyMode", 1, greyMode);
+	state.brightness = brightness;
+	state.contrast = contrast;
 
-	blitRGBAShader->SetUniformValue("u_brightness", 1, brightness);
-	blitRGBAShader->SetUniformValue("u_contrast", 1, contrast);
-
-	GLint channel = 3;
+	state.channel = 3;
 	if (flags & BlitFlags::STENCIL_RED) {
-		channel = 0;
+		state.channel = 0;
 	} else if (flags & BlitFlags::STENCIL_GREEN) {
-		channel = 1;
+		state.channel = 1;
 	} else if (flags & BlitFlags::STENCIL_BLUE) {
-		channel = 2;
+		state.channel = 2;
 	}
 
-	blitRGBAShader->SetUniformValue("u_channel", 1, channel);
-
-	bool doStencil = flags & BlitFlags::STENCIL_MASK;
-	blitRGBAShader->SetUniformValue("u_stencil", 1, doStencil ? 1 : 0);
-
-	if (doStencil) {
+	state.stencil = flags & BlitFlags::STENCIL_MASK;
+	if (state.stencil) {
 		assert(stencilBuffer && dstrect);
 
-		bool doDither = flags & BlitFlags::STENCIL_DITHER;
-		blitRGBAShader->SetUniformValue("u_dither", 1, doDither ? 1 : 0);
+		state.dither = flags & BlitFlags::STENCIL_DITHER;
 
 		int texW = 0;
 		int texH = 0;
@@ -550,23 +581,22 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 		stencilTexW = 1.0f / (static_cast<float>(texW) * scaleX);
 		stencilTexH = 1.0f / (static_cast<float>(texH) * scaleY);
 
-		GLfloat mat[3][3] = {
-			{ stencilTexW,        0.0f, 0.0f },
-			{        0.0f, stencilTexH, 0.0f },
-			{ stencilTexX * stencilTexW, stencilTexY * stencilTexH, 1.0f }
+		const GLfloat mat[9] = {
+			stencilTexW,        0.0f, 0.0f,
+			       0.0f, stencilTexH, 0.0f,
+			stencilTexX * stencilTexW, stencilTexY * stencilTexH, 1.0f
 		};
+		std::copy(std::begin(mat), std::end(mat), std::begin(state.stencilMat));
+		state.stencilTexture = std::static_pointer_cast<SDLTextureVideoBuffer>(stencilBuffer)->GetTexture();
+	}
 
-		blitRGBAShader->SetUniformMatrixValue("u_stencilMat", 3, 1, reinterpret_cast<GLfloat*>(&mat));
-		
-		// Ask OpenGL about the texture handle (that lies hidden in SDL_Texture otherwise)
-		auto curTexture = std::static_pointer_cast<SDLTextureVideoBuffer>(stencilBuffer)->GetTexture();
-		SDL_GL_BindTexture(curTexture, nullptr, nullptr);
-		GLuint stencilTextureID;
-		glGetIntegerv(GL_TEXTURE_BINDING_2D, reinterpret_cast<GLint*>(&stencilTextureID));
-		SDL_GL_UnbindTexture(curTexture);
-
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, stencilTextureID);
+	// changing the uniforms would also change the copies still queued, so only a change forces them out
+	if (!shaderStateSet || !(state == shaderState)) {
+		FlushRenderer();
+		ApplyShaderState(state);
+	} else if (state.stencil) {
+		// texture uploads may have used the unit since, while the queued copies only read it when flushed
+		BindStencilTexture(state.stencilTexture);
 	}
 #endif
 	
@@ -592,9 +622,47 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 	SDL_RendererFlip flipflags = (flags & BlitFlags::MIRRORY) ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
 	flipflags = static_cast<SDL_RendererFlip>(flipflags | ((flags & BlitFlags::MIRRORX) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE));
 
+	CountDraw(texture);
 	return SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, nullptr, flipflags);
 }
 
+#if USE_OPENGL_BACKEND
+void SDL20VideoDriver::ApplyShaderState(const ShaderState& state)
+{
+	blitRGBAShader->Use();
+	
+	blitRGBAShader->SetUniformValue("s_sprite", 1, 0);
+	blitRGBAShader->SetUniformValue("s_stencil", 1, 1);
+	blitRGBAShader->SetUniformValue("u_rgba", 1, state.rgba);
+	blitRGBAShader->SetUniformValue("u_greyMode", 1, state.greyMode);
+	blitRGBAShader->SetUniformValue("u_brightness", 1, state.brightness);
+	blitRGBAShader->SetUniformValue("u_contrast", 1, state.contrast);
+	blitRGBAShader->SetUniformValue("u_channel", 1, state.channel);
+	blitRGBAShader->SetUniformValue("u_stencil", 1, state.stencil ? 1 : 0);
+
+	if (state.stencil) {
+		blitRGBAShader->SetUniformValue("u_dither", 1, state.dither ? 1 : 0);
+		blitRGBAShader->SetUniformMatrixValue("u_stencilMat", 3, 1, state.stencilMat);
+		BindStencilTexture(state.stencilTexture);
+	}
+
+	shaderState = state;
+	shaderStateSet = true;
+}
+
+void SDL20VideoDriver::BindStencilTexture(SDL_Texture* stencilTexture) const
+{
+	// Ask OpenGL about the texture handle (that lies hidden in SDL_Texture otherwise)
+	SDL_GL_BindTexture(stencilTexture, nullptr, nullptr);
+	GLuint stencilTextureID;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, reinterpret_cast<GLint*>(&stencilTextureID));
+	SDL_GL_UnbindTexture(stencilTexture);
+
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, stencilTextureID);
+}
+#endif
+
 void SDL20VideoDriver::SetTextureBlendMode(SDL_Texture *texture, BlitFlags flags) const {
 	if (flags & BlitFlags::ADD) {
 		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_ADD);
@@ -23,6 +23,10 @@
 
 #include "SDLVideo.h"
 #include "SDLSurfaceSprite2D.h"
+#include "SDLTextureAtlas.h"
+
+#include <algorithm>
+#include <iterator>
 
 #if USE_OPENGL_BACKEND
 #include "GLSLProgram.h"
@@ -225,6 +229,40 @@ private:
 	float brightness = 1.0;
 	float contrast = 1.0;
 	Size customFullscreenSize;
+
+	// the uniforms of the coopted SDL shader, queued copies use whatever is set when they are flushed
+	struct ShaderState {
+		int rgba = 0;
+		int greyMode = 0;
+		int channel = 0;
+		bool stencil = false;
+		bool dither = false;
+		float brightness = 0.0;
+		float contrast = 0.0;
+		float stencilMat[9] {};
+		SDL_Texture* stencilTexture = nullptr;
+
+		bool operator==(const ShaderState& other) const
+		{
+			return rgba == other.rgba && greyMode == other.greyMode && channel == other.channel
+				&& stencil == other.stencil && dither == other.dither
+				&& brightness == other.brightness && contrast == other.contrast
+				&& std::equal(std::begin(stencilMat), std::end(stencilMat), std::begin(other.stencilMat))
+				&& stencilTexture == other.stencilTexture;
+		}
+	};
+	ShaderState shaderState;
+	bool shaderStateSet = false;
+
+	std::unique_ptr<SDLTextureAtlas> atlas;
+	FrameStats frameStats;
+	FrameStats lastFrameStats;
+	const SDL_Texture* lastTexture = nullptr;
+	// what the renderer can still merge the next copy into
+	const SDL_Texture* batchTexture = nullptr;
+	SDL_BlendMode batchBlendMode = SDL_BLENDMODE_NONE;
+	const SDL_Texture* batchTarget = nullptr;
+	Region batchClip;
 public:
 	SDL20VideoDriver() noexcept;
 	~SDL20VideoDriver() noexcept override;
@@ -250,6 +288,7 @@ public:
 						 Color tint = Color()) override;
 
 	void DrawRawGeometry(const std::vector<float>& vertices, const std::vector<Color>& colors, BlitFlags blitFlags) override;
+	FrameStats GetFrameStats() const override { return lastFrameStats; }
 private:
 	VideoBuffer* NewVideoBuffer(const Region&, BufferFormat) override;
 
@@ -284,6 +323,13 @@ private:
 								 BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL) override;
 	void BlitSpriteNativeClipped(SDL_Texture* spr, const Region& src, const Region& dst, BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL);
 
+	void CountDraw(SDL_Texture* texture);
+	void BreakBatch() { batchTexture = nullptr; }
+	void FlushRenderer();
+#if USE_OPENGL_BACKEND
+	void ApplyShaderState(const ShaderState& state);
+	void BindStencilTexture(SDL_Texture* stencilTexture) const;
+#endif
 	int RenderCopyShaded(SDL_Texture*, const SDL_Rect* srcrect, const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* = nullptr);
 	void SetTextureBlendMode(SDL_Texture *texture, BlitFlags flags) const;
 
@@ -328,6 +328,32 @@ SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer) const
 	return texture;
 }
 
+SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer, SDLTextureAtlas* atlas, SDL_Point& offset) const
+{
+	if (atlas && !texture && !atlasSlot) {
+		const SDL_Surface* surface = GetSurface();
+		atlasSlot = atlas->Allocate(surface->w, surface->h);
+		if (atlasSlot) staleTexture = true;
+	}
+
+	if (atlasSlot) {
+		if (staleTexture) {
+			if (!atlasSlot->Upload(GetSurface())) {
+				// fall back to a texture of our own
+				atlasSlot.reset();
+				offset = SDL_Point { 0, 0 };
+				return GetTexture(renderer);
+			}
+			staleTexture = false;
+		}
+		offset = SDL_Point { atlasSlot->Rect().x, atlasSlot->Rect().y };
+		return atlasSlot->Texture();
+	}
+
+	offset = SDL_Point { 0, 0 };
+	return GetTexture(renderer);
+}
+
 void SDLTextureSprite2D::OnSurfaceUpdate() const noexcept {
 	staleTexture = true;
 }
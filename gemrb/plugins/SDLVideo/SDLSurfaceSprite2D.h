@@ -26,6 +26,12 @@
 
 #include <SDL.h>
 
+#if SDL_VERSION_ATLEAST(1,3,0)
+#include "SDLTextureAtlas.h"
+
+#include <memory>
+#endif
+
 namespace GemRB {
 
 class SDLSurfaceSprite2D : public Sprite2D {
@@ -84,6 +90,7 @@ public:
 class SDLTextureSprite2D : public SDLSurfaceSprite2D {
 	mutable Uint32 texFormat = SDL_PIXELFORMAT_UNKNOWN;
 	mutable SDL_Texture* texture = nullptr;
+	mutable std::unique_ptr<SDLTextureAtlas::Slot> atlasSlot;
 	mutable bool staleTexture = false;
 
 	void OnSurfaceUpdate() const noexcept override;
@@ -96,6 +103,8 @@ public:
 	Holder<Sprite2D> copy() const override;
 	
 	SDL_Texture* GetTexture(SDL_Renderer* renderer) const;
+	// prefers a place in the atlas, offset is then where the sprite starts in the texture
+	SDL_Texture* GetTexture(SDL_Renderer* renderer, SDLTextureAtlas* atlas, SDL_Point& offset) const;
 };
 #endif
 
@@ -0,0 +1,163 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLTextureAtlas.h"
+
+#include "Logging/Logging.h"
+
+#include <cstring>
+
+namespace GemRB {
+
+static constexpr Uint32 ATLAS_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+// rows can be a bit taller than their sprites, but not so much that space is wasted
+static constexpr int SHELF_SLACK = 8;
+
+struct SDLTextureAtlas::Page {
+	struct Shelf {
+		int y;
+		int h;
+		int x; // first free column
+	};
+
+	SDL_Texture* texture = nullptr;
+	std::vector<Shelf> shelves;
+	int top = 0; // first row not used by a shelf
+	size_t live = 0;
+
+	explicit Page(SDL_Texture* texture) noexcept : texture(texture) {}
+	Page(const Page&) = delete;
+	~Page()
+	{
+		SDL_DestroyTexture(texture);
+	}
+	Page& operator=(const Page&) = delete;
+
+	bool Fit(int w, int h, SDL_Rect& rect)
+	{
+		Shelf* best = nullptr;
+		for (Shelf& shelf : shelves) {
+			if (shelf.h < h || shelf.h > h + SHELF_SLACK || shelf.x + w > PageSize) continue;
+			if (!best || shelf.h < best->h) best = &shelf;
+		}
+		if (!best) {
+			if (top + h > PageSize) return false;
+			shelves.push_back({ top, h, 0 });
+			top += h;
+			best = &shelves.back();
+		}
+
+		rect = { best->x, best->y, w, h };
+		best->x += w;
+		live++;
+		return true;
+	}
+
+	void Release()
+	{
+		if (--live == 0) {
+			// the borders are uploaded with every sprite, so stale pixels don't matter
+			shelves.clear();
+			top = 0;
+		}
+	}
+};
+
+SDLTextureAtlas::Slot::Slot(std::shared_ptr<Page> page, const SDL_Rect& rect) noexcept
+	: page(std::move(page)), rect(rect)
+{}
+
+SDLTextureAtlas::Slot::~Slot()
+{
+	page->Release();
+}
+
+SDL_Texture* SDLTextureAtlas::Slot::Texture() const
+{
+	return page->texture;
+}
+
+bool SDLTextureAtlas::Slot::Upload(SDL_Surface* surface) const
+{
+	SDL_Surface* converted = surface;
+	if (surface->format->format != ATLAS_FORMAT) {
+		// also turns a color key into transparency
+		converted = SDL_ConvertSurfaceFormat(surface, ATLAS_FORMAT, 0);
+		if (!converted) {
+			Log(ERROR, "SDLTextureAtlas", "{}", SDL_GetError());
+			return false;
+		}
+	}
+
+	// one transparent pixel around the sprite
+	int w = rect.w + 2;
+	int h = rect.h + 2;
+	std::vector<Uint32> pixels(w * h, 0);
+	SDL_LockSurface(converted);
+	const Uint8* src = static_cast<const Uint8*>(converted->pixels);
+	for (int y = 0; y < rect.h; ++y) {
+		std::memcpy(&pixels[(y + 1) * w + 1], src + y * converted->pitch, rect.w * sizeof(Uint32));
+	}
+	SDL_UnlockSurface(converted);
+	if (converted != surface) {
+		SDL_FreeSurface(converted);
+	}
+
+	SDL_Rect padded = { rect.x - 1, rect.y - 1, w, h };
+	if (SDL_UpdateTexture(page->texture, &padded, pixels.data(), w * sizeof(Uint32)) != 0) {
+		Log(ERROR, "SDLTextureAtlas", "{}", SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+SDLTextureAtlas::SDLTextureAtlas(SDL_Renderer* renderer) noexcept
+	: renderer(renderer)
+{}
+
+std::unique_ptr<SDLTextureAtlas::Slot> SDLTextureAtlas::Allocate(int w, int h)
+{
+	if (w <= 0 || h <= 0 || w > MaxSpriteSize || h > MaxSpriteSize) {
+		return nullptr;
+	}
+
+	SDL_Rect rect;
+	for (const auto& page : pages) {
+		if (page->Fit(w + 2, h + 2, rect)) {
+			return std::unique_ptr<Slot>(new Slot(page, { rect.x + 1, rect.y + 1, w, h }));
+		}
+	}
+
+	if (pages.size() >= MaxPages) {
+		return nullptr;
+	}
+	SDL_Texture* texture = SDL_CreateTexture(renderer, ATLAS_FORMAT, SDL_TEXTUREACCESS_STATIC, PageSize, PageSize);
+	if (!texture) {
+		Log(ERROR, "SDLTextureAtlas", "{}", SDL_GetError());
+		return nullptr;
+	}
+	pages.push_back(std::make_shared<Page>(texture));
+	if (!pages.back()->Fit(w + 2, h + 2, rect)) {
+		return nullptr;
+	}
+	return std::unique_ptr<Slot>(new Slot(pages.back(), { rect.x + 1, rect.y + 1, w, h }));
+}
+
+}
@@ -0,0 +1,78 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SDLTEXTUREATLAS_H
+#define SDLTEXTUREATLAS_H
+
+#include <SDL.h>
+
+#include <memory>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * Packs small and medium sprites (BAM frames, glyphs, tiles) into a few
+ * large textures, so consecutive blits mostly share a texture and the SDL
+ * render batching can merge them instead of switching textures every time.
+ * Sprites are placed on rows of similar height (shelf packing) with a
+ * transparent border against filtering bleed; a page is reused once all
+ * of its sprites are gone.
+ */
+class SDLTextureAtlas {
+public:
+	struct Page;
+
+	// a sprite's place in the atlas, given back when destroyed
+	class Slot {
+	public:
+		Slot(std::shared_ptr<Page> page, const SDL_Rect& rect) noexcept;
+		Slot(const Slot&) = delete;
+		~Slot();
+		Slot& operator=(const Slot&) = delete;
+
+		SDL_Texture* Texture() const;
+		const SDL_Rect& Rect() const { return rect; }
+		/** Copies the surface into the slot, converting it as needed */
+		bool Upload(SDL_Surface* surface) const;
+
+	private:
+		std::shared_ptr<Page> page;
+		SDL_Rect rect;
+	};
+
+	static constexpr int PageSize = 1024;
+	static constexpr int MaxSpriteSize = 256;
+	static constexpr size_t MaxPages = 8;
+
+	explicit SDLTextureAtlas(SDL_Renderer* renderer) noexcept;
+
+	/** Returns nullptr if the sprite is too big or all the pages are full */
+	std::unique_ptr<Slot> Allocate(int w, int h);
+	size_t PageCount() const { return pages.size(); }
+
+private:
+	SDL_Renderer* renderer;
+	std::vector<std::shared_ptr<Page>> pages;
+};
+
+}
+
+#endif
@@ -20,8 +20,11 @@
 #include <gtest/gtest.h>
 
 #include "../../core/Streams/FileStream.h"
+#include "../../core/Streams/MemoryStream.h"
 #include "../../plugins/2DAImporter/2DAImporter.h"
 
+#include <cstring>
+
 namespace GemRB {
 
 static const path_t SAMPLE_FILE = PathJoin("tests", "resources", "2DAImporter", "sample.2da");
@@ -79,6 +82,31 @@ TEST_P(p2DAImporter_Test, GetColumnIndex) {
 	EXPECT_EQ(unit.GetColumnIndex(std::string{"COOLNESS"}), p2DAImporter::npos);
 }
 
+TEST_P(p2DAImporter_Test, GetIndexCaseInsensitive) {
+	EXPECT_EQ(unit.GetRowIndex(std::string{"squeezeness"}), 6);
+	EXPECT_EQ(unit.GetColumnIndex(std::string{"Stat_Id"}), 3);
+}
+
+TEST_P(p2DAImporter_Test, QueryFieldSigned) {
+	EXPECT_EQ(unit.QueryFieldSigned<int>(0, 0), 11975);
+	EXPECT_EQ(unit.QueryFieldSigned<int>(std::string{"wisdom"}, std::string{"CAP_REF"}), 1180);
+	EXPECT_EQ(unit.QueryFieldSigned<int8_t>(0, 0), 127);
+	// missing fields give the default
+	EXPECT_EQ(unit.QueryFieldSigned<int>(6, 3), -1);
+	EXPECT_EQ(unit.QueryFieldSigned<int>(8, 0), -1);
+	EXPECT_EQ(unit.QueryFieldSigned<int>(0, 9), -1);
+	EXPECT_EQ(unit.QueryFieldSigned<int>(std::string{"FLUFFINESS"}, std::string{"NAME_REF"}), -1);
+	// non-numeric fields parse as zero
+	EXPECT_EQ(unit.QueryFieldSigned<int>(0, 3), 0);
+}
+
+TEST_P(p2DAImporter_Test, QueryFieldUnsigned) {
+	EXPECT_EQ(unit.QueryFieldUnsigned<ieDword>(7, 1), 34u);
+	EXPECT_EQ(unit.QueryFieldUnsigned<ieWord>(3, 0), 11979u);
+	EXPECT_EQ(unit.QueryFieldUnsigned<ieByte>(3, 0), 255u);
+	EXPECT_EQ(unit.QueryFieldUnsigned<ieByte>(7, 3), 255u);
+}
+
 TEST_P(p2DAImporter_Test, GetColumnName) {
 	EXPECT_EQ(unit.GetColumnName(0), std::string{"NAME_REF"});
 	EXPECT_EQ(unit.GetColumnName(3), std::string{"STAT_ID"});
@@ -127,4 +155,42 @@ TEST(p2DAImporter_Test, GetColumnCount2)
 	EXPECT_EQ(unit.GetColumnCount(0), 1);
 }
 
+// name lookups on a table far larger than the shipped ones
+TEST(p2DAImporter_Test, LargeTableLookups)
+{
+	const int rows = 5000;
+	const int cols = 40;
+	const int lookups = 20000;
+
+	std::string text = "2DA V1.0\n-1\n";
+	for (int col = 0; col < cols; ++col) {
+		text += fmt::format(" COLUMN{:02}", col);
+	}
+	text += "\n";
+	for (int row = 0; row < rows; ++row) {
+		text += fmt::format("ROW{:05}", row);
+		for (int col = 0; col < cols; ++col) {
+			text += fmt::format(" {}", row * cols + col);
+		}
+		text += "\n";
+	}
+
+	void* data = malloc(text.size());
+	memcpy(data, text.data(), text.size());
+	p2DAImporter unit;
+	ASSERT_TRUE(unit.Open(std::make_unique<MemoryStream>("large.2da", data, strpos_t(text.size()))));
+	ASSERT_EQ(unit.GetRowCount(), TableMgr::index_t(rows));
+
+	int mismatches = 0;
+	for (int i = 0; i < lookups; ++i) {
+		// spread over the whole table, lowercase half of them to hit the case folding
+		int row = (i * 7919) % rows;
+		int col = (i * 31) % cols;
+		std::string rowName = fmt::format(i % 2 ? "ROW{:05}" : "row{:05}", row);
+		std::string colName = fmt::format("COLUMN{:02}", col);
+		mismatches += unit.QueryFieldSigned<int>(rowName, colName) != row * cols + col;
+	}
+	EXPECT_EQ(mismatches, 0);
+}
+
 }
@@ -0,0 +1,143 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../core/Streams/MemoryStream.h"
+#include "../../plugins/BIFImporter/BIFImporter.h"
+
+#include "SClassID.h"
+
+#include <cstring>
+
+namespace GemRB {
+
+static const ieDword FILE_COUNT = 10000;
+static const ieDword TILE_COUNT = 20;
+static const ieDword FILE_SIZE = 4;
+static const ieDword TILE_SIZE = 16;
+
+// builds an uncompressed BIFF archive where file i holds the dword i
+// and tileset i holds 16 bytes of i
+static DataStream* MakeSyntheticBIF()
+{
+	const ieDword headerSize = 20;
+	const ieDword tableSize = FILE_COUNT * 16 + TILE_COUNT * 20;
+	const ieDword dataOffset = headerSize + tableSize;
+	const ieDword totalSize = dataOffset + FILE_COUNT * FILE_SIZE + TILE_COUNT * TILE_SIZE;
+
+	auto data = static_cast<char*>(malloc(totalSize));
+	char* pos = data;
+	auto putDword = [&pos](ieDword value) {
+		memcpy(pos, &value, 4);
+		pos += 4;
+	};
+	auto putWord = [&pos](ieWord value) {
+		memcpy(pos, &value, 2);
+		pos += 2;
+	};
+
+	memcpy(pos, "BIFFV1  ", 8);
+	pos += 8;
+	putDword(FILE_COUNT);
+	putDword(TILE_COUNT);
+	putDword(headerSize);
+
+	// store the entries in reverse, so a linear scan would be at its worst for low locators
+	for (ieDword i = FILE_COUNT; i > 0; i--) {
+		ieDword idx = i - 1;
+		putDword(idx);
+		putDword(dataOffset + idx * FILE_SIZE);
+		putDword(FILE_SIZE);
+		putWord(IE_CRE_CLASS_ID);
+		putWord(0);
+	}
+	for (ieDword i = 0; i < TILE_COUNT; i++) {
+		putDword((i + 1) << 14);
+		putDword(dataOffset + FILE_COUNT * FILE_SIZE + i * TILE_SIZE);
+		putDword(1);
+		putDword(TILE_SIZE);
+		putWord(IE_TIS_CLASS_ID);
+		putWord(0);
+	}
+	for (ieDword i = 0; i < FILE_COUNT; i++) {
+		putDword(i);
+	}
+	for (ieDword i = 0; i < TILE_COUNT; i++) {
+		memset(pos, int(i), TILE_SIZE);
+		pos += TILE_SIZE;
+	}
+
+	return new MemoryStream("synthetic.bif", data, totalSize);
+}
+
+class BIFImporter_Test : public testing::Test {
+protected:
+	BIFImporter unit;
+public:
+	void SetUp() override {
+		ASSERT_EQ(unit.OpenArchive(MakeSyntheticBIF()), GEM_OK);
+	}
+};
+
+TEST_F(BIFImporter_Test, GetFileStream) {
+	for (ieDword idx : { 0u, 1u, 4242u, FILE_COUNT - 1 }) {
+		// the upper bits of the locator belong to the KEY and must be ignored
+		DataStream* str = unit.GetStream((7 << 20) | idx, IE_CRE_CLASS_ID);
+		ASSERT_NE(str, nullptr);
+		EXPECT_EQ(str->Size(), FILE_SIZE);
+		ieDword value = 0;
+		str->ReadDword(value);
+		EXPECT_EQ(value, idx);
+		delete str;
+	}
+}
+
+TEST_F(BIFImporter_Test, GetTileStream) {
+	DataStream* str = unit.GetStream(3 << 14, IE_TIS_CLASS_ID);
+	ASSERT_NE(str, nullptr);
+	EXPECT_EQ(str->Size(), TILE_SIZE);
+	ieByte value = 0;
+	str->Read(&value, 1);
+	EXPECT_EQ(value, 2);
+	delete str;
+}
+
+TEST_F(BIFImporter_Test, MissingEntries) {
+	EXPECT_EQ(unit.GetStream(FILE_COUNT, IE_CRE_CLASS_ID), nullptr);
+	EXPECT_EQ(unit.GetStream(0x3FFF, IE_CRE_CLASS_ID), nullptr);
+	EXPECT_EQ(unit.GetStream(0, IE_TIS_CLASS_ID), nullptr);
+	EXPECT_EQ(unit.GetStream((TILE_COUNT + 1) << 14, IE_TIS_CLASS_ID), nullptr);
+}
+
+TEST_F(BIFImporter_Test, FindsEveryEntry) {
+	int mismatches = 0;
+	for (ieDword idx = 0; idx < FILE_COUNT; idx++) {
+		DataStream* str = unit.GetStream(idx, IE_CRE_CLASS_ID);
+		ieDword value = FILE_COUNT;
+		if (str) {
+			str->ReadDword(value);
+		}
+		mismatches += value != idx;
+		delete str;
+	}
+	EXPECT_EQ(mismatches, 0);
+}
+
+}
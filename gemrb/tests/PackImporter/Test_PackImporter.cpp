@@ -0,0 +1,173 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../core/Compressor.h"
+#include "../../core/ResourceDesc.h"
+#include "../../core/Streams/DataStream.h"
+#include "../../plugins/PackImporter/PackImporter.h"
+
+#include "globals.h"
+#include "System/VFS.h"
+
+#include <memory>
+#include <vector>
+#include <zlib.h>
+
+namespace GemRB {
+
+// packed from an override holding over.itm and beta.2da, and a BIF holding
+// alpha.itm, script.bcs and tiles.tis, with another over.itm shadowed by the override
+static const path_t SAMPLE_PACK = PathJoin("tests", "resources", "PackImporter", "sample.gpk");
+// packed with --compress from an override holding a deflated table.2da and
+// small.itm, which is too small to bother; it also records the fingerprints
+// of that install, which was nothing like the test resources
+static const path_t COMPRESSED_PACK = PathJoin("tests", "resources", "PackImporter", "compressed.gpk");
+static const path_t NOT_A_PACK = PathJoin("tests", "resources", "2DAImporter", "sample.2da");
+
+static std::string ReadAll(DataStream* stream)
+{
+	std::unique_ptr<DataStream> owned(stream);
+	if (!owned) return "<missing>";
+
+	std::string contents(owned->Size(), '\0');
+	if (owned->Read(&contents[0], contents.size()) != strret_t(contents.size())) {
+		return "<short read>";
+	}
+	return contents;
+}
+
+// the real one lives in the ZLibManager plugin, which tests don't load
+class TestCompressor : public Compressor {
+public:
+	int Decompress(DataStream* dest, DataStream* source, unsigned int size_guess) const override
+	{
+		std::vector<Bytef> in(size_guess ? size_guess : source->Remains());
+		std::vector<Bytef> out(dest->Size());
+		uLongf outSize = out.size();
+		if (source->Read(in.data(), in.size()) != strret_t(in.size()) ||
+		    uncompress(out.data(), &outSize, in.data(), in.size()) != Z_OK) {
+			return GEM_ERROR;
+		}
+		return dest->Write(out.data(), outSize) == strret_t(outSize) ? GEM_OK : GEM_ERROR;
+	}
+	int Compress(DataStream*, DataStream*) const override
+	{
+		return GEM_ERROR;
+	}
+};
+
+class PackImporter_Test : public testing::Test {
+protected:
+	PackImporter unit;
+	ResourceDesc itm {nullptr, nullptr, "itm"};
+	ResourceDesc bs {nullptr, nullptr, "bs"};
+	ResourceDesc tis {nullptr, nullptr, "tis"};
+	ResourceDesc tda {nullptr, nullptr, "2da"};
+	ResourceDesc wav {nullptr, nullptr, "wav"};
+public:
+	void SetUp() override {
+		ASSERT_TRUE(unit.Open(SAMPLE_PACK, "sample"));
+	}
+};
+
+TEST_F(PackImporter_Test, HasResource) {
+	EXPECT_TRUE(unit.HasResource("alpha", itm));
+	EXPECT_TRUE(unit.HasResource("ALPHA", itm));
+	EXPECT_TRUE(unit.HasResource("beta", tda));
+	EXPECT_TRUE(unit.HasResource("tiles", tis));
+	EXPECT_FALSE(unit.HasResource("alpha", wav));
+	EXPECT_FALSE(unit.HasResource("gamma", itm));
+	EXPECT_FALSE(unit.HasResource("", itm));
+	EXPECT_FALSE(unit.HasResource("longerthan8", itm));
+}
+
+TEST_F(PackImporter_Test, GetResource) {
+	EXPECT_EQ(ReadAll(unit.GetResource("Alpha", itm)), "alpha item");
+	EXPECT_EQ(ReadAll(unit.GetResource("beta", tda)), "2DA V1.0\n");
+	EXPECT_EQ(ReadAll(unit.GetResource("tiles", tis)), std::string(16, '\x07'));
+	EXPECT_EQ(unit.GetResource("gamma", itm), nullptr);
+}
+
+TEST_F(PackImporter_Test, OverridePrecedence) {
+	EXPECT_EQ(ReadAll(unit.GetResource("over", itm)), "override wins");
+}
+
+TEST_F(PackImporter_Test, ScriptSynonym) {
+	// BIF scripts are also found as bs, like through chitin.key
+	EXPECT_EQ(ReadAll(unit.GetResource("script", bs)), "SC\nCR\nSC\n");
+}
+
+TEST_F(PackImporter_Test, Clone) {
+	std::unique_ptr<DataStream> stream(unit.GetResource("alpha", itm));
+	ASSERT_NE(stream, nullptr);
+	EXPECT_EQ(stream->filename, "alpha.itm");
+	EXPECT_EQ(ReadAll(stream->Clone()), "alpha item");
+}
+
+TEST_F(PackImporter_Test, MatchesAnyInstallWithoutFingerprints) {
+	EXPECT_TRUE(unit.MatchesInstall(PathJoin("tests", "resources", "chitin.key"), PathJoin("tests", "resources", "override")));
+	EXPECT_TRUE(unit.MatchesInstall(NOT_A_PACK, PathJoin("tests", "resources", "PackImporter")));
+}
+
+class PackImporter_Compressed : public testing::Test {
+protected:
+	PackImporter unit;
+	ResourceDesc itm {nullptr, nullptr, "itm"};
+	ResourceDesc tda {nullptr, nullptr, "2da"};
+public:
+	void SetUp() override {
+		ASSERT_TRUE(unit.Open(COMPRESSED_PACK, "compressed"));
+	}
+};
+
+TEST_F(PackImporter_Compressed, NeedsACompressor) {
+	unit.SetCompressor(nullptr);
+	EXPECT_TRUE(unit.HasResource("table", tda));
+	EXPECT_EQ(unit.GetResource("table", tda), nullptr);
+	// stored entries don't need it
+	EXPECT_EQ(ReadAll(unit.GetResource("small", itm)), "too small to deflate");
+}
+
+TEST_F(PackImporter_Compressed, InflatesDeflatedEntries) {
+	unit.SetCompressor(std::make_shared<TestCompressor>());
+
+	std::unique_ptr<DataStream> stream(unit.GetResource("table", tda));
+	ASSERT_NE(stream, nullptr);
+	EXPECT_EQ(stream->filename, "table.2da");
+	std::string table = ReadAll(stream->Clone());
+	ASSERT_EQ(table.size(), size_t(1213));
+	EXPECT_EQ(table.substr(0, 11), "2DA V1.0\n0\n");
+	EXPECT_EQ(table.substr(table.size() - 19), "ROW063    189    0\n");
+	EXPECT_EQ(ReadAll(unit.GetResource("small", itm)), "too small to deflate");
+}
+
+TEST_F(PackImporter_Compressed, DetectsAChangedInstall) {
+	EXPECT_FALSE(unit.MatchesInstall(PathJoin("tests", "resources", "chitin.key"), PathJoin("tests", "resources", "PackImporter")));
+	EXPECT_FALSE(unit.MatchesInstall(NOT_A_PACK, PathJoin("tests", "resources", "missing")));
+}
+
+TEST(PackImporter_Open, RejectsOtherFiles) {
+	PackImporter unit;
+	EXPECT_FALSE(unit.Open(NOT_A_PACK, "sample"));
+	EXPECT_FALSE(unit.Open(PathJoin("tests", "resources", "PackImporter", "missing.gpk"), "sample"));
+}
+
+}
@@ -0,0 +1,87 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../../core/GameScript/ScriptProfiler.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+class ScriptProfiler_Test : public testing::Test {
+protected:
+	void SetUp() override
+	{
+		ScriptProfiler::Reset();
+	}
+
+	void TearDown() override
+	{
+		SetDebugMode(DebugMode::PROFILER, BitOp::NAND);
+		ScriptProfiler::Reset();
+	}
+};
+
+TEST_F(ScriptProfiler_Test, NothingIsRecordedWhenDisabled)
+{
+	SetDebugMode(DebugMode::PROFILER, BitOp::NAND);
+	{
+		ScriptProfiler::ScriptScope scope(ResRef("wtasight"));
+		ScriptProfiler::Sample block(ScriptProfiler::Kind::Block, 0);
+	}
+	EXPECT_EQ(ScriptProfiler::Report().find("wtasight"), std::string::npos);
+}
+
+TEST_F(ScriptProfiler_Test, SamplesAreAggregatedPerScriptAndBlock)
+{
+	SetDebugMode(DebugMode::PROFILER, BitOp::OR);
+	for (int i = 0; i < 3; ++i) {
+		ScriptProfiler::ScriptScope scope(ResRef("wtasight"));
+		ScriptProfiler::Sample block(ScriptProfiler::Kind::Block, 2);
+	}
+	{
+		ScriptProfiler::ScriptScope scope(ResRef("shout"));
+	}
+
+	std::string report = ScriptProfiler::Report();
+	auto line = report.find("script wtasight block 2");
+	ASSERT_NE(line, std::string::npos);
+	auto start = report.rfind('\n', line);
+	std::string row = report.substr(start + 1, line - start - 1);
+	EXPECT_NE(row.find(" 3 "), std::string::npos);
+	EXPECT_NE(report.find("script shout\n"), std::string::npos);
+}
+
+TEST_F(ScriptProfiler_Test, NestedScriptsRestoreTheOwner)
+{
+	SetDebugMode(DebugMode::PROFILER, BitOp::OR);
+	{
+		ScriptProfiler::ScriptScope outer(ResRef("outer"));
+		{
+			ScriptProfiler::ScriptScope inner(ResRef("inner"));
+		}
+		ScriptProfiler::Sample block(ScriptProfiler::Kind::Block, 1);
+	}
+	EXPECT_NE(ScriptProfiler::Report().find("script outer block 1"), std::string::npos);
+	// header and the single most expensive entry
+	std::string top = ScriptProfiler::Report(1);
+	EXPECT_EQ(std::count(top.begin(), top.end(), '\n'), 2);
+}
+
+}
@@ -0,0 +1,173 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../../core/GameScript/Targets.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace GemRB {
+
+// just enough of a scriptable for the target lists, which only look at the type and position
+class TargetDummy : public Scriptable {
+public:
+	explicit TargetDummy(ScriptableType type, const Point& pos = Point()) : Scriptable(type)
+	{
+		Pos = pos;
+	}
+	std::string dump() const override { return {}; }
+};
+
+class Targets_Test : public testing::Test {
+protected:
+	TargetDummy near { ST_ACTOR };
+	TargetDummy door { ST_DOOR };
+	TargetDummy middle { ST_ACTOR };
+	TargetDummy far { ST_ACTOR };
+	TargetDummy tie { ST_ACTOR };
+};
+
+TEST_F(Targets_Test, KeepsTargetsSortedByDistance)
+{
+	Targets targets;
+	targets.AddTarget(&far, 30, 0);
+	targets.AddTarget(&near, 10, 0);
+	targets.AddTarget(&middle, 20, 0);
+	// equal distances keep their insertion order
+	targets.AddTarget(&tie, 20, 0);
+	targets.AddTarget(&door, 15, 0);
+	ASSERT_EQ(targets.Count(), size_t(5));
+
+	EXPECT_EQ(targets.GetTarget(0, ST_ANY), &near);
+	EXPECT_EQ(targets.GetTarget(1, ST_ANY), &door);
+	EXPECT_EQ(targets.GetTarget(2, ST_ANY), &middle);
+	EXPECT_EQ(targets.GetTarget(3, ST_ANY), &tie);
+	EXPECT_EQ(targets.GetTarget(4, ST_ANY), &far);
+	EXPECT_EQ(targets.GetTarget(5, ST_ANY), nullptr);
+
+	EXPECT_EQ(targets.GetTarget(1, ST_ACTOR), &middle);
+	EXPECT_EQ(targets.GetTarget(0, ST_DOOR), &door);
+	EXPECT_EQ(targets.GetLastTarget(ST_ACTOR)->actor, &far);
+
+	targetlist::iterator m;
+	const targettype* t = targets.GetFirstTarget(m, ST_ACTOR);
+	std::vector<const Scriptable*> actors;
+	while (t) {
+		actors.push_back(t->actor);
+		t = targets.GetNextTarget(m, ST_ACTOR);
+	}
+	EXPECT_EQ(actors, std::vector<const Scriptable*>({ &near, &middle, &tie, &far }));
+}
+
+TEST_F(Targets_Test, PopDropsTheNearest)
+{
+	Targets targets;
+	targets.AddTarget(&middle, 20, 0);
+	targets.AddTarget(&near, 10, 0);
+	targets.Pop();
+	ASSERT_EQ(targets.Count(), size_t(1));
+	EXPECT_EQ(targets.GetTarget(0, ST_ANY), &middle);
+	EXPECT_EQ(targets.GetLastTarget(ST_ANY)->actor, &middle);
+
+	// the popped one stays out of later inserts too
+	targets.AddTarget(&far, 5, 0);
+	EXPECT_EQ(targets.Count(), size_t(2));
+	EXPECT_EQ(targets.GetTarget(0, ST_ANY), &far);
+	EXPECT_EQ(targets.GetTarget(1, ST_ANY), &middle);
+
+	targets.Pop();
+	targets.Pop();
+	targets.Pop();
+	EXPECT_EQ(targets.Count(), size_t(0));
+	EXPECT_EQ(targets.GetLastTarget(ST_ANY), nullptr);
+}
+
+TEST_F(Targets_Test, RemoveIfKeepsTheOrder)
+{
+	Targets targets;
+	targets.AddTarget(&far, 30, 0);
+	targets.AddTarget(&near, 10, 0);
+	targets.AddTarget(&door, 15, 0);
+	targets.AddTarget(&middle, 20, 0);
+	targets.Pop();
+
+	targets.RemoveIf([this](const targettype& t) {
+		return t.actor == &middle;
+	});
+	ASSERT_EQ(targets.Count(), size_t(2));
+	EXPECT_EQ(targets.GetTarget(0, ST_ANY), &door);
+	EXPECT_EQ(targets.GetTarget(1, ST_ANY), &far);
+
+	targets.RemoveIf([](const targettype&) { return true; });
+	EXPECT_EQ(targets.Count(), size_t(0));
+}
+
+TEST_F(Targets_Test, ObjectsAndBuffersAreRecycled)
+{
+	auto* first = new Targets();
+	for (unsigned int i = 0; i < 64; ++i) {
+		first->AddTarget(&near, i, 0);
+	}
+	void* block = first;
+	delete first;
+
+	// the next one reuses the block and starts out empty, but with the capacity
+	auto* second = new Targets();
+	EXPECT_EQ(static_cast<void*>(second), block);
+	EXPECT_EQ(second->Count(), size_t(0));
+	EXPECT_EQ(second->GetTarget(0, ST_ANY), nullptr);
+	second->AddTarget(&middle, 1, 0);
+	EXPECT_EQ(second->GetTarget(0, ST_ANY), &middle);
+	delete second;
+}
+
+// what object matching does for a trigger like See(NearestEnemyOf(Myself)) on a
+// crowded area: every creature collects the others by distance, filters them
+// and picks the nearest match, with the target lists recycled in between
+TEST_F(Targets_Test, CrowdedArea)
+{
+	const int creatures = 200;
+	const int rounds = 3;
+	std::vector<std::unique_ptr<TargetDummy>> area;
+	for (int i = 0; i < creatures; ++i) {
+		// some doors and containers mixed in, as GetAllObjects would see them
+		ScriptableType type = i % 10 == 0 ? ST_DOOR : (i % 10 == 1 ? ST_CONTAINER : ST_ACTOR);
+		area.push_back(std::make_unique<TargetDummy>(type, Point((i * 7919) % 3000, (i * 104729) % 2000)));
+	}
+
+	size_t found = 0;
+	for (int round = 0; round < rounds; ++round) {
+		for (const auto& sender : area) {
+			auto* targets = new Targets();
+			for (const auto& other : area) {
+				targets->AddTarget(other.get(), SquaredDistance(sender->Pos, other->Pos), 0);
+			}
+			targets->Pop(); // self
+			// stands in for the allegiance check, every other creature is an enemy
+			targets->RemoveIf([](const targettype& t) {
+				return t.actor->Type == ST_ACTOR && t.actor->GetGlobalID() % 2;
+			});
+			found += targets->GetTarget(0, ST_ACTOR) != nullptr;
+			delete targets;
+		}
+	}
+	EXPECT_EQ(found, size_t(rounds) * creatures);
+}
+
+}
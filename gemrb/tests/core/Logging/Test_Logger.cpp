@@ -0,0 +1,104 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../../core/Logging/Logger.h"
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace GemRB {
+
+// keeps what it gets and holds up the logging thread on the first message until released
+class BlockingWriter : public Logger::LogWriter {
+	std::mutex lock;
+	std::condition_variable cv;
+	bool blocked = false;
+	bool released = false;
+
+public:
+	std::vector<std::string> messages;
+
+	BlockingWriter() : LogWriter(DEBUG) {}
+
+	void WriteLogMessage(const Logger::LogMessage& msg) override
+	{
+		std::unique_lock<std::mutex> l(lock);
+		messages.push_back(msg.message);
+		if (!released) {
+			blocked = true;
+			cv.notify_all();
+			cv.wait(l, [this]() { return released; });
+		}
+	}
+
+	void WaitUntilBlocked()
+	{
+		std::unique_lock<std::mutex> l(lock);
+		cv.wait(l, [this]() { return blocked; });
+	}
+
+	void Release()
+	{
+		std::lock_guard<std::mutex> l(lock);
+		released = true;
+		cv.notify_all();
+	}
+};
+
+TEST(Logger_Test, PassesMessagesOn)
+{
+	auto writer = std::make_shared<BlockingWriter>();
+	writer->Release();
+	{
+		Logger logger({});
+		logger.AddLogWriter(writer);
+		logger.LogMsg(MESSAGE, "Test", "one", Logger::MSG_STYLE);
+		logger.LogMsg(DEBUG, "Test", "two", Logger::MSG_STYLE);
+	} // the logging thread empties the queue before it ends
+
+	EXPECT_EQ(writer->messages, std::vector<std::string>({ "one", "two" }));
+}
+
+TEST(Logger_Test, ReportsDroppedMessages)
+{
+	auto writer = std::make_shared<BlockingWriter>();
+	{
+		Logger logger({});
+		logger.AddLogWriter(writer);
+		logger.LogMsg(MESSAGE, "Test", "first", Logger::MSG_STYLE);
+		writer->WaitUntilBlocked();
+
+		// the logging thread already took the first one, so the queue holds 4096 of these
+		for (int i = 0; i < 5000; ++i) {
+			logger.LogMsg(MESSAGE, "Test", std::to_string(i).c_str(), Logger::MSG_STYLE);
+		}
+		writer->Release();
+	}
+
+	ASSERT_EQ(writer->messages.size(), size_t(4098));
+	EXPECT_EQ(writer->messages[0], "first");
+	EXPECT_EQ(writer->messages[1], "0");
+	EXPECT_EQ(writer->messages[4096], "4095");
+	EXPECT_EQ(writer->messages[4097], "The log queue was full, dropped 904 messages.");
+}
+
+}
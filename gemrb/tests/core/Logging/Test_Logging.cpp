@@ -0,0 +1,125 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../../core/Logging/Logging.h"
+
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+// the levels are global and overrides can't be taken back, so every test uses
+// its own owners and restores the global level
+class Logging_Test : public testing::Test {
+protected:
+	void SetUp() override
+	{
+		// nothing is enabled without a logger to pass messages on to
+		ToggleLogging(true);
+	}
+
+	void TearDown() override
+	{
+		SetLogLevel(DEBUG);
+		ToggleLogging(false);
+	}
+};
+
+TEST_F(Logging_Test, GlobalThreshold)
+{
+	SetLogLevel(WARNING);
+	EXPECT_TRUE(LogLevelEnabled(ERROR, "Threshold"));
+	EXPECT_TRUE(LogLevelEnabled(WARNING, "Threshold"));
+	EXPECT_FALSE(LogLevelEnabled(MESSAGE, "Threshold"));
+	EXPECT_FALSE(LogLevelEnabled(DEBUG, "Threshold"));
+	// these always get through
+	EXPECT_TRUE(LogLevelEnabled(FATAL, "Threshold"));
+	EXPECT_TRUE(LogLevelEnabled(INTERNAL, "Threshold"));
+
+	SetLogLevel(DEBUG);
+	EXPECT_TRUE(LogLevelEnabled(DEBUG, "Threshold"));
+}
+
+TEST_F(Logging_Test, NothingWithoutALogger)
+{
+	ToggleLogging(false);
+	EXPECT_FALSE(LogLevelEnabled(ERROR, "Silent"));
+	EXPECT_TRUE(LogLevelEnabled(FATAL, "Silent"));
+}
+
+TEST_F(Logging_Test, ChannelMoreVerboseThanGlobal)
+{
+	SetLogLevel(WARNING);
+	SetChannelLogLevel("Chatty", COMBAT);
+	EXPECT_TRUE(LogLevelEnabled(COMBAT, "Chatty"));
+	EXPECT_FALSE(LogLevelEnabled(DEBUG, "Chatty"));
+	// everyone else keeps the global level
+	EXPECT_FALSE(LogLevelEnabled(MESSAGE, "Other"));
+	EXPECT_TRUE(LogLevelEnabled(WARNING, "Other"));
+}
+
+TEST_F(Logging_Test, ChannelQuieterThanGlobal)
+{
+	SetLogLevel(DEBUG);
+	SetChannelLogLevel("Quiet", ERROR);
+	EXPECT_TRUE(LogLevelEnabled(ERROR, "Quiet"));
+	EXPECT_FALSE(LogLevelEnabled(WARNING, "Quiet"));
+	EXPECT_FALSE(LogLevelEnabled(DEBUG, "Quiet"));
+	EXPECT_TRUE(LogLevelEnabled(DEBUG, "Other"));
+
+	// a later change of the global level doesn't touch the override
+	SetLogLevel(ERROR);
+	EXPECT_FALSE(LogLevelEnabled(WARNING, "Quiet"));
+	EXPECT_FALSE(LogLevelEnabled(WARNING, "Other"));
+}
+
+TEST_F(Logging_Test, ChannelOverridesCanChange)
+{
+	SetLogLevel(WARNING);
+	SetChannelLogLevel("Fickle", DEBUG);
+	EXPECT_TRUE(LogLevelEnabled(DEBUG, "Fickle"));
+	SetChannelLogLevel("Fickle", ERROR);
+	EXPECT_FALSE(LogLevelEnabled(DEBUG, "Fickle"));
+	EXPECT_FALSE(LogLevelEnabled(WARNING, "Fickle"));
+}
+
+TEST_F(Logging_Test, ParsesChannelList)
+{
+	SetLogLevel(WARNING);
+	SetChannelLogLevels(" ParsedCore=3,  ParsedAudio = 1 ,ParsedHigh=9");
+	EXPECT_TRUE(LogLevelEnabled(MESSAGE, "ParsedCore"));
+	EXPECT_FALSE(LogLevelEnabled(COMBAT, "ParsedCore"));
+	EXPECT_TRUE(LogLevelEnabled(ERROR, "ParsedAudio"));
+	EXPECT_FALSE(LogLevelEnabled(WARNING, "ParsedAudio"));
+	// clamped to the most verbose level
+	EXPECT_TRUE(LogLevelEnabled(DEBUG, "ParsedHigh"));
+}
+
+TEST_F(Logging_Test, SkipsMalformedChannels)
+{
+	SetLogLevel(WARNING);
+	SetChannelLogLevels("BadNoLevel,BadWord=loud,=5,BadTrailing=4x,,GoodAfterBad=5");
+	for (const char* owner : { "BadNoLevel", "BadWord", "BadTrailing", "" }) {
+		// still on the global level, neither silenced nor more verbose
+		EXPECT_TRUE(LogLevelEnabled(WARNING, owner)) << owner;
+		EXPECT_FALSE(LogLevelEnabled(MESSAGE, owner)) << owner;
+	}
+	EXPECT_TRUE(LogLevelEnabled(DEBUG, "GoodAfterBad"));
+}
+
+}
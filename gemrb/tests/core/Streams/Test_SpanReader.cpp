@@ -0,0 +1,144 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "Streams/FileStream.h"
+#include "Streams/MappedFileMemoryStream.h"
+#include "Streams/SpanReader.h"
+
+#include "System/VFS.h"
+
+namespace GemRB {
+
+using SpanStreamFactory = std::function<DataStream*(const path_t&)>;
+
+static const path_t SPAN_TEST_FILE = PathJoin("tests", "resources", "streams", "file_le.bin");
+
+class SpanReader_Test : public testing::TestWithParam<SpanStreamFactory> {
+protected:
+	DataStream* stream = nullptr;
+public:
+	void SetUp() override {
+		stream = GetParam()(SPAN_TEST_FILE);
+	}
+
+	void TearDown() override {
+		delete stream;
+		stream = nullptr;
+	}
+};
+
+TEST_P(SpanReader_Test, AdvancesStream) {
+	stream->Seek(1, GEM_STREAM_START);
+	SpanReader reader(stream, 6);
+	EXPECT_EQ(reader.Size(), 6);
+	EXPECT_EQ(reader.GetPos(), 0);
+	EXPECT_EQ(stream->GetPos(), 7);
+
+	// never more than what the stream has left
+	SpanReader rest(stream, 1000);
+	EXPECT_EQ(rest.Size(), stream->Size() - 7);
+	EXPECT_EQ(stream->Remains(), 0);
+}
+
+TEST_P(SpanReader_Test, ReadScalar) {
+	SpanReader reader(stream, 7);
+
+	uint8_t one;
+	EXPECT_EQ(reader.ReadScalar(one), 1);
+	EXPECT_EQ(one, 0x01);
+
+	uint16_t two;
+	EXPECT_EQ(reader.ReadScalar(two), 2);
+	EXPECT_EQ(two, 0x0201);
+
+	uint32_t four;
+	EXPECT_EQ((reader.ReadScalar<uint32_t, uint16_t>(four)), 2);
+	EXPECT_EQ(four, 0x0201);
+
+	uint16_t value;
+	EXPECT_EQ(reader.ReadWord(value), 2);
+	EXPECT_EQ(value, 11);
+	EXPECT_EQ(reader.Remains(), 0);
+}
+
+TEST_P(SpanReader_Test, ReadPastEnd) {
+	SpanReader reader(stream, 3);
+
+	uint32_t four = 42;
+	EXPECT_EQ(reader.ReadScalar(four), strret_t(DataStream::Error));
+	EXPECT_EQ(four, 42);
+	EXPECT_EQ(reader.GetPos(), 0);
+
+	EXPECT_EQ(reader.Seek(4, GEM_STREAM_START), strret_t(DataStream::Error));
+	EXPECT_EQ(reader.Seek(2, GEM_CURRENT_POS), 0);
+	EXPECT_EQ(reader.GetPos(), 2);
+}
+
+TEST_P(SpanReader_Test, ReadRTrimString) {
+	stream->Seek(7, GEM_STREAM_START);
+	SpanReader reader(stream, 10);
+
+	FixedSizeString<10> buffer;
+	EXPECT_EQ(reader.ReadRTrimString(buffer, 10), 10);
+	EXPECT_EQ(buffer, "Text text");
+}
+
+TEST_P(SpanReader_Test, ReadArray) {
+	stream->Seek(18, GEM_STREAM_START);
+	SpanReader reader(stream, 8);
+
+	ieWord values[4];
+	EXPECT_EQ(reader.ReadArray(values, 4), 8);
+	EXPECT_EQ(values[0], 0x8);
+	EXPECT_EQ(values[3], 0xB);
+}
+
+TEST_P(SpanReader_Test, ReadRegion) {
+	stream->Seek(18, GEM_STREAM_START);
+	SpanReader reader(stream, 8);
+
+	Region r;
+	EXPECT_EQ(reader.ReadRegion(r, true), 8);
+	Region expected{0x8, 0x9, 0x2, 0x2};
+	EXPECT_EQ(r, expected);
+}
+
+static DataStream* createSpanFileStream(const path_t& path) {
+	auto fstream = new FileStream();
+	fstream->Open(path);
+
+	return fstream;
+}
+
+static DataStream* createSpanMMapStream(const path_t& path) {
+	return new MappedFileMemoryStream(path);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+	SpanReaderInstances,
+	SpanReader_Test,
+	testing::Values(
+		SpanStreamFactory{createSpanFileStream},
+		SpanStreamFactory{createSpanMMapStream}
+	)
+);
+
+}
@@ -0,0 +1,160 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../core/EffectQueue.h"
+
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+static const ieDword OPCODES = 5;
+
+// the parameter tells otherwise equal effects apart, RemoveEffect compares them all
+static void Add(EffectQueue& queue, ieDword opcode, ieDword param1, bool insert = false)
+{
+	Effect* fx = new Effect();
+	fx->Opcode = opcode;
+	fx->Parameter1 = param1;
+	queue.AddEffect(fx, insert);
+}
+
+static std::vector<const Effect*> Lookup(const EffectQueue& queue, ieDword opcode)
+{
+	std::vector<const Effect*> found;
+	for (const auto& fx : queue.WithOpcode(opcode)) {
+		found.push_back(&fx);
+	}
+	return found;
+}
+
+static std::vector<const Effect*> Scan(const EffectQueue& queue, ieDword opcode)
+{
+	std::vector<const Effect*> found;
+	auto it = queue.GetFirstEffect();
+	while (const Effect* fx = queue.GetNextEffect(it)) {
+		if (fx->Opcode == opcode) found.push_back(fx);
+	}
+	return found;
+}
+
+static void ExpectIndexMatchesScan(const EffectQueue& queue)
+{
+	for (ieDword opcode = 0; opcode < OPCODES; ++opcode) {
+		EXPECT_EQ(Lookup(queue, opcode), Scan(queue, opcode)) << "opcode " << opcode;
+	}
+}
+
+class EffectQueue_Test : public testing::Test {
+protected:
+	EffectQueue queue;
+
+	void SetUp() override
+	{
+		ieDword param = 0;
+		for (ieDword opcode : { 1, 2, 1, 3, 2, 1 }) {
+			Add(queue, opcode, param++);
+		}
+		// at the front of both the queue and the bucket
+		Add(queue, 2, param++, true);
+	}
+};
+
+TEST_F(EffectQueue_Test, AddKeepsQueueOrder)
+{
+	ExpectIndexMatchesScan(queue);
+	EXPECT_EQ(Lookup(queue, 1).size(), size_t(3));
+	ASSERT_EQ(Lookup(queue, 2).size(), size_t(3));
+	EXPECT_EQ(Lookup(queue, 2).front()->Parameter1, ieDword(6));
+	EXPECT_TRUE(Lookup(queue, 4).empty());
+}
+
+TEST_F(EffectQueue_Test, RemoveUnindexes)
+{
+	Effect middle;
+	middle.Opcode = 1;
+	middle.Parameter1 = 2;
+	EXPECT_TRUE(queue.RemoveEffect(&middle));
+	EXPECT_FALSE(queue.RemoveEffect(&middle));
+	ExpectIndexMatchesScan(queue);
+	EXPECT_EQ(Lookup(queue, 1).size(), size_t(2));
+
+	Add(queue, 1, 10);
+	Add(queue, 4, 11, true);
+	ExpectIndexMatchesScan(queue);
+
+	// marks them expired, the lookups have to find every one
+	queue.RemoveAllEffects(2);
+	for (const Effect* fx : Scan(queue, 2)) {
+		EXPECT_EQ(fx->TimingMode, FX_DURATION_JUST_EXPIRED);
+	}
+	for (const Effect* fx : Scan(queue, 1)) {
+		EXPECT_NE(fx->TimingMode, FX_DURATION_JUST_EXPIRED);
+	}
+}
+
+TEST_F(EffectQueue_Test, CopiesGetTheirOwnIndex)
+{
+	EffectQueue copy(queue);
+	ExpectIndexMatchesScan(copy);
+	// the index must point into the copy, not the original
+	EXPECT_NE(Lookup(copy, 1), Lookup(queue, 1));
+
+	Add(queue, 3, 20);
+	ExpectIndexMatchesScan(queue);
+	ExpectIndexMatchesScan(copy);
+	EXPECT_EQ(Lookup(copy, 3).size(), size_t(1));
+
+	EffectQueue assigned;
+	Add(assigned, 4, 30);
+	assigned = queue;
+	ExpectIndexMatchesScan(assigned);
+	EXPECT_TRUE(Lookup(assigned, 4).empty());
+	Add(assigned, 1, 31);
+	ExpectIndexMatchesScan(assigned);
+	ExpectIndexMatchesScan(queue);
+}
+
+TEST_F(EffectQueue_Test, MovesKeepTheIndex)
+{
+	std::vector<const Effect*> before = Lookup(queue, 1);
+	EffectQueue moved(std::move(queue));
+	ExpectIndexMatchesScan(moved);
+	// the list nodes move along
+	EXPECT_EQ(Lookup(moved, 1), before);
+	EXPECT_TRUE(Lookup(queue, 1).empty());
+
+	EffectQueue assigned;
+	Add(assigned, 4, 40);
+	assigned = std::move(moved);
+	ExpectIndexMatchesScan(assigned);
+	EXPECT_EQ(Lookup(assigned, 1), before);
+	EXPECT_TRUE(Lookup(assigned, 4).empty());
+	EXPECT_TRUE(Lookup(moved, 1).empty());
+
+	// both stay usable
+	Add(assigned, 2, 41);
+	Add(moved, 2, 42);
+	ExpectIndexMatchesScan(assigned);
+	ExpectIndexMatchesScan(moved);
+	EXPECT_EQ(Lookup(moved, 2).size(), size_t(1));
+}
+
+}
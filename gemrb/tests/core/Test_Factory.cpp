@@ -0,0 +1,91 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../core/Factory.h"
+
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+static Factory::object_t MakeObject(const ResRef& resRef, SClass_ID type = IE_BAM_CLASS_ID)
+{
+	return std::make_shared<FactoryObject>(resRef, type);
+}
+
+TEST(Factory_Test, LookupByResRefAndType)
+{
+	Factory factory;
+	factory.AddFactoryObject(MakeObject("cursors"));
+	factory.AddFactoryObject(MakeObject("cursors", IE_BMP_CLASS_ID));
+
+	int bam = factory.IsLoaded("CURSORS", IE_BAM_CLASS_ID);
+	int bmp = factory.IsLoaded("cursors", IE_BMP_CLASS_ID);
+	ASSERT_NE(bam, -1);
+	ASSERT_NE(bmp, -1);
+	EXPECT_NE(bam, bmp);
+	EXPECT_EQ(factory.GetFactoryObject(bmp)->SuperClassID, IE_BMP_CLASS_ID);
+	EXPECT_EQ(factory.IsLoaded("fogowar", IE_BAM_CLASS_ID), -1);
+	EXPECT_EQ(factory.IsLoaded(ResRef(), IE_BAM_CLASS_ID), -1);
+}
+
+TEST(Factory_Test, EvictsOnlyUnreferencedLeastRecentlyUsed)
+{
+	Factory factory(100);
+	auto held = MakeObject("held");
+	factory.AddFactoryObject(held);
+	factory.AddFactoryObject(MakeObject("old"));
+	factory.AddFactoryObject(MakeObject("recent"));
+	factory.IsLoaded("recent", IE_BAM_CLASS_ID);
+
+	EXPECT_EQ(factory.Evict(2), 1u);
+	EXPECT_EQ(factory.IsLoaded("old", IE_BAM_CLASS_ID), -1);
+	EXPECT_NE(factory.IsLoaded("recent", IE_BAM_CLASS_ID), -1);
+
+	// nothing left that only the factory references
+	EXPECT_EQ(factory.Evict(0), 1u);
+	EXPECT_EQ(factory.Size(), 1u);
+	int pos = factory.IsLoaded("held", IE_BAM_CLASS_ID);
+	ASSERT_NE(pos, -1);
+	EXPECT_EQ(factory.GetFactoryObject(pos), held);
+}
+
+TEST(Factory_Test, KeepsPinnedObjects)
+{
+	Factory factory(100);
+	// like the map note flags, which only exist in memory
+	factory.AddFactoryObject(MakeObject("flag1"), true);
+	factory.AddFactoryObject(MakeObject("loaded"));
+
+	EXPECT_EQ(factory.Evict(0), 1u);
+	EXPECT_EQ(factory.Size(), 1u);
+	EXPECT_NE(factory.IsLoaded("flag1", IE_BAM_CLASS_ID), -1);
+	EXPECT_EQ(factory.IsLoaded("loaded", IE_BAM_CLASS_ID), -1);
+}
+
+TEST(Factory_Test, StaysBoundedOverLongSessions)
+{
+	Factory factory(64);
+	for (int i = 0; i < 1000; ++i) {
+		factory.AddFactoryObject(MakeObject(ResRef(fmt::format("anim{}", i))));
+	}
+	EXPECT_LE(factory.Size(), 64u);
+	EXPECT_NE(factory.IsLoaded("anim999", IE_BAM_CLASS_ID), -1);
+}
+
+}
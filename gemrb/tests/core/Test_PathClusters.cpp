@@ -0,0 +1,101 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../core/PathClusters.h"
+
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+// 64x48 open searchmap with a wall at x == 40, open only where gapY says
+class PathClusters_Test : public testing::Test {
+protected:
+	Size mapSize { 64, 48 };
+	int gapY = 30;
+
+	PathClusters::Passable Passable()
+	{
+		return [this](const SearchmapPoint& p) {
+			return p.x != 40 || p.y == gapY;
+		};
+	}
+};
+
+TEST_F(PathClusters_Test, NearbyQueriesAreLeftToDirectSearch)
+{
+	PathClusters clusters(mapSize, Passable());
+	std::vector<SearchmapPoint> waypoints;
+	EXPECT_FALSE(clusters.FindWaypoints(Point(1, 1), Point(20, 20), waypoints));
+	EXPECT_TRUE(waypoints.empty());
+}
+
+TEST_F(PathClusters_Test, RoutesThroughTheGap)
+{
+	PathClusters clusters(mapSize, Passable());
+	EXPECT_GT(clusters.NodeCount(), size_t(0));
+
+	std::vector<SearchmapPoint> waypoints;
+	ASSERT_TRUE(clusters.FindWaypoints(Point(2, 2), Point(60, 2), waypoints));
+	ASSERT_FALSE(waypoints.empty());
+	EXPECT_EQ(waypoints.back(), Point(60, 2));
+
+	// the legs stay between neighbouring clusters and one of them crosses the gap
+	SearchmapPoint legStart(2, 2);
+	bool crossed = false;
+	for (const auto& waypoint : waypoints) {
+		EXPECT_LE(clusters.ClusterDistance(legStart, waypoint), 1);
+		crossed |= (legStart.x < 40) != (waypoint.x < 40) && waypoint.y >= 16;
+		legStart = waypoint;
+	}
+	EXPECT_TRUE(crossed);
+}
+
+TEST_F(PathClusters_Test, UpdatesAfterTheGapMoves)
+{
+	PathClusters clusters(mapSize, Passable());
+	std::vector<SearchmapPoint> waypoints;
+
+	// close the gap, like a door would
+	gapY = -1;
+	clusters.Update({ Point(40, 30) });
+	EXPECT_FALSE(clusters.FindWaypoints(Point(2, 2), Point(60, 2), waypoints));
+
+	gapY = 5;
+	clusters.Update({ Point(40, 5) });
+	ASSERT_TRUE(clusters.FindWaypoints(Point(2, 2), Point(60, 2), waypoints));
+	for (const auto& waypoint : waypoints) {
+		EXPECT_LT(waypoint.y, 16);
+	}
+}
+
+TEST_F(PathClusters_Test, QueriesCanUseAnotherSearchmap)
+{
+	PathClusters clusters(mapSize, Passable());
+	std::vector<SearchmapPoint> waypoints;
+
+	// a snapshot where the start got walled in
+	auto snapshot = [this](const SearchmapPoint& p) {
+		return p.x > 3 && (p.x != 40 || p.y == gapY);
+	};
+	EXPECT_FALSE(clusters.FindWaypoints(Point(2, 2), Point(60, 2), waypoints, snapshot));
+	EXPECT_TRUE(clusters.FindWaypoints(Point(5, 2), Point(60, 2), waypoints, snapshot));
+	EXPECT_TRUE(clusters.FindWaypoints(Point(2, 2), Point(60, 2), waypoints));
+}
+
+}
@@ -0,0 +1,116 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../core/SpatialGrid.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+namespace GemRB {
+
+struct GridDummy {
+	Point Pos;
+};
+
+static bool InRange(const GridDummy& d, const Point& p, int radius)
+{
+	return d.Pos.IsWithinRadius(radius, p);
+}
+
+TEST(SpatialGrid_Test, QueryFindsNearbyInInsertionOrder)
+{
+	SpatialGrid<GridDummy> grid(100);
+	GridDummy a { Point(950, 950) };
+	GridDummy b { Point(20, 20) };
+	GridDummy c { Point(1050, 1050) };
+	grid.Insert(&a, a.Pos);
+	grid.Insert(&b, b.Pos);
+	grid.Insert(&c, c.Pos);
+	EXPECT_EQ(grid.Size(), size_t(3));
+
+	auto found = grid.Query(Point(1000, 1000), 100);
+	ASSERT_EQ(found.size(), size_t(2));
+	EXPECT_EQ(found[0], &a);
+	EXPECT_EQ(found[1], &c);
+
+	// moving across cells must not reorder
+	a.Pos = Point(1010, 990);
+	grid.Move(&a, a.Pos);
+	found = grid.Query(Point(1000, 1000), 100);
+	ASSERT_EQ(found.size(), size_t(2));
+	EXPECT_EQ(found[0], &a);
+
+	grid.Remove(&a);
+	found = grid.Query(Point(1000, 1000), 100);
+	ASSERT_EQ(found.size(), size_t(1));
+	EXPECT_EQ(found[0], &c);
+}
+
+TEST(SpatialGrid_Test, HandlesNegativeAndHugeRegions)
+{
+	SpatialGrid<GridDummy> grid(64);
+	GridDummy a { Point(-10, -10) };
+	GridDummy b { Point(5, 5) };
+	grid.Insert(&a, a.Pos);
+	grid.Insert(&b, b.Pos);
+
+	auto found = grid.Query(Point(-20, -20), 15);
+	ASSERT_EQ(found.size(), size_t(1));
+	EXPECT_EQ(found[0], &a);
+
+	found = grid.Query(Point(0, 0), 0xffffffff);
+	EXPECT_EQ(found.size(), size_t(2));
+}
+
+// the grid has to find the same objects as the plain scan it replaces in Map
+TEST(SpatialGrid_Test, MatchesLinearScan)
+{
+	const Size mapSize(8000, 6000);
+	const int radius = 30 * 16; // 30 feet
+	const int queries = 200;
+	std::mt19937 rng(42);
+
+	for (size_t count : { 100, 1000, 5000 }) {
+		std::vector<GridDummy> objects(count);
+		SpatialGrid<GridDummy> grid;
+		for (auto& obj : objects) {
+			obj.Pos = Point(rng() % mapSize.w, rng() % mapSize.h);
+			grid.Insert(&obj, obj.Pos);
+		}
+		std::vector<Point> centers;
+		for (int i = 0; i < queries; ++i) {
+			centers.emplace_back(rng() % mapSize.w, rng() % mapSize.h);
+		}
+
+		for (const Point& p : centers) {
+			std::vector<const GridDummy*> linearHits;
+			for (const auto& obj : objects) {
+				if (InRange(obj, p, radius)) linearHits.push_back(&obj);
+			}
+			std::vector<const GridDummy*> gridHits;
+			for (const auto* obj : grid.Query(p, radius)) {
+				if (InRange(*obj, p, radius)) gridHits.push_back(obj);
+			}
+			// both in insertion order
+			ASSERT_EQ(linearHits, gridHits) << count << " objects around " << p.x << "," << p.y;
+		}
+	}
+}
+
+}
@@ -0,0 +1,84 @@
+/* GemRB - Infinity Engine Emulator
+* Copyright (C) 2024 The GemRB Project
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "../../core/ThreadPool.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+TEST(ThreadPool_Test, RunsAllTasks)
+{
+	ThreadPool pool(3);
+	EXPECT_EQ(pool.ThreadCount(), size_t(3));
+	EXPECT_FALSE(pool.IsWorkerThread());
+
+	std::atomic<int> sum {0};
+	std::atomic<int> onWorker {0};
+	std::vector<std::future<void>> results;
+	for (int i = 1; i <= 100; ++i) {
+		results.push_back(pool.Submit([&, i]() {
+			sum += i;
+			onWorker += pool.IsWorkerThread();
+		}));
+	}
+	for (auto& result : results) {
+		result.get();
+	}
+
+	EXPECT_EQ(sum, 5050);
+	EXPECT_EQ(onWorker, 100);
+}
+
+TEST(ThreadPool_Test, StopDropsQueuedTasks)
+{
+	ThreadPool pool(1);
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future();
+
+	std::atomic<int> ran {0};
+	std::atomic_bool started {false};
+	auto blocker = pool.Submit([&]() {
+		started = true;
+		released.wait();
+		++ran;
+	});
+	auto queued = pool.Submit([&]() { ++ran; });
+	while (!started) {
+		std::this_thread::yield();
+	}
+
+	std::thread stopper([&pool]() { pool.Stop(); });
+	while (!pool.Stopping()) {
+		std::this_thread::yield();
+	}
+	release.set_value();
+	stopper.join();
+
+	blocker.get();
+	EXPECT_THROW(queued.get(), std::future_error);
+	EXPECT_EQ(ran, 1);
+
+	// nothing runs after stopping
+	EXPECT_THROW(pool.Submit([&]() { ++ran; }).get(), std::future_error);
+	EXPECT_EQ(ran, 1);
+}
+
+}
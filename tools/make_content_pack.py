@@ -0,0 +1,426 @@
+#!/usr/bin/env python3
+
+# Packs the resources of a game install into a single content pack,
+# which GemRB memory maps and serves through its PackImporter plugin.
+# The game sources are searched in the same order as the engine does
+# (override, sounds, movies, scripts, portraits, data, CD data and
+# finally chitin.key), so the pack holds exactly the files GemRB would
+# have picked. Rebuild it after installing mods; GemRB ignores packs whose
+# chitin.key or override directory changed since they were built.
+#
+# Use it like this and point ContentPack in GemRB.cfg to the result:
+#
+# $ python tools/make_content_pack.py /path/to/game game.gpk
+#
+# See gemrb/plugins/PackImporter/PackImporter.h for the format.
+
+import argparse
+import os
+import sys
+import zlib
+from struct import pack, unpack_from
+
+SIGNATURE = b'GPAKV1  '
+HEADER_SIZE = 32
+ENTRY_SIZE = 32
+DIRECT_SLOT = 0x80000000
+FLAG_DEFLATED = 1
+
+# the engine's default game subpaths, in search order
+GAME_DIRECTORIES = ['override', 'sounds', 'movies', 'scripts', 'portraits', 'data', 'data/data']
+
+# key file types, see includes/SClassID.h
+KEY_TYPES = {
+	0x001: ['bmp'],
+	0x002: ['mve'],
+	0x003: ['png'],
+	0x004: ['wav'],
+	0x005: ['wfx'],
+	0x006: ['plt'],
+	0x007: ['ogg'],
+	0x3E8: ['bam'],
+	0x3E9: ['wed'],
+	0x3EA: ['chu'],
+	0x3EB: ['tis'],
+	0x3EC: ['mos'],
+	0x3ED: ['itm'],
+	0x3EE: ['spl'],
+	# the engine also looks up BS scripts with this type
+	0x3EF: ['bcs', 'bs'],
+	0x3F0: ['ids'],
+	0x3F1: ['cre'],
+	0x3F2: ['are'],
+	0x3F3: ['dlg'],
+	0x3F4: ['2da'],
+	0x3F5: ['gam'],
+	0x3F6: ['sto'],
+	0x3F7: ['wmp'],
+	0x3F8: ['eff'],
+	0x3FA: ['chr'],
+	0x3FB: ['vvc'],
+	0x3FC: ['vef'],
+	0x3FD: ['pro'],
+	# which one is used depends on the game
+	0x3FE: ['bio', 'res'],
+	0x3FF: ['wbm'],
+	0x400: ['fnt'],
+	0x402: ['gui'],
+	0x403: ['sql'],
+	0x404: ['pvrz'],
+	0x405: ['glsl'],
+	0x408: ['menu'],
+	0x409: ['lua'],
+	0x40A: ['ttf'],
+	0x802: ['ini'],
+	0x803: ['src'],
+}
+
+TIS_TYPE = 0x3EB
+
+# archives are resolved through chitin.key instead
+ARCHIVES = {'bif', 'cbf'}
+
+# already compressed, deflating them again is a waste of time
+INCOMPRESSIBLE = {'bik', 'mve', 'ogg', 'png', 'pvrz', 'wbm'}
+
+def pack_hash(key, seed):
+	"""Must match PackHash in PackImporter.cpp."""
+	h = 0x811C9DC5 ^ seed
+	for b in key:
+		h ^= b
+		h = (h * 0x01000193) & 0xFFFFFFFF
+	h ^= h >> 16
+	h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+	h ^= h >> 13
+	h = (h * 0xC2B2AE35) & 0xFFFFFFFF
+	h ^= h >> 16
+	return h
+
+FNV_BASIS = 0x811C9DC5
+
+def fingerprint_bytes(h, data):
+	for b in data:
+		h ^= b
+		h = (h * 0x01000193) & 0xFFFFFFFF
+	return h
+
+def fingerprint_file(h, path):
+	"""Size and modification time, which change whenever a file is replaced."""
+	info = os.stat(path)
+	return fingerprint_bytes(h, pack('<QQ', info.st_size, int(info.st_mtime)))
+
+def install_fingerprints(key_path, override_path):
+	"""Must match KeyFingerprint and OverrideFingerprint in PackImporter.cpp, 0 means unknown."""
+	key = fingerprint_file(FNV_BASIS, key_path) or 1
+
+	override = FNV_BASIS
+	if override_path and os.path.isdir(override_path):
+		names = []
+		for file_name in os.listdir(override_path):
+			if file_name.startswith('.') or os.path.isdir(os.path.join(override_path, file_name)):
+				continue
+			names.append((os.fsencode(file_name).lower(), file_name))
+		for lower, file_name in sorted(names):
+			override = fingerprint_bytes(override, lower + b'\0')
+			override = fingerprint_file(override, os.path.join(override_path, file_name))
+	return key, override or 1
+
+def make_key(name, ext):
+	"""The resref and extension bytes, lowercase and NUL padded."""
+	return name.lower().ljust(8, b'\0') + ext.encode('ascii').lower().ljust(4, b'\0')
+
+def resolve_case(root, relative):
+	"""Finds a path below root, ignoring the case of each component."""
+	path = root
+	for part in relative.replace('\\', '/').replace(':', '/').split('/'):
+		if not part:
+			continue
+		candidate = os.path.join(path, part)
+		if not os.path.exists(candidate):
+			try:
+				matches = [entry for entry in os.listdir(path) if entry.lower() == part.lower()]
+			except OSError:
+				return None
+			if not matches:
+				return None
+			candidate = os.path.join(path, matches[0])
+		path = candidate
+	return path
+
+class LooseFile:
+	def __init__(self, path):
+		self.path = path
+
+	def order(self):
+		return (self.path, 0)
+
+	def read(self):
+		with open(self.path, 'rb') as f:
+			return f.read()
+
+class BIFFile:
+	def __init__(self, archive, offset, size):
+		self.archive = archive
+		self.offset = offset
+		self.size = size
+
+	def order(self):
+		return (self.archive.path, self.offset)
+
+	def read(self):
+		data = self.archive.data()
+		return data[self.offset:self.offset + self.size]
+
+class BIFArchive:
+	"""A BIF, decompressed on first use."""
+	def __init__(self, path):
+		self.path = path
+		self.contents = None
+		self.indexed = False
+		self.files = {}
+		self.tiles = {}
+
+	def data(self):
+		if self.contents is None:
+			with open(self.path, 'rb') as f:
+				raw = f.read()
+			self.contents = self.decompress(raw)
+		return self.contents
+
+	def release(self):
+		self.contents = None
+
+	def decompress(self, raw):
+		signature = raw[:8]
+		if signature == b'BIFFV1  ':
+			return raw
+		if signature == b'BIF V1.0':
+			name_length = unpack_from('<I', raw, 8)[0]
+			start = 12 + name_length + 8
+			return zlib.decompress(raw[start:])
+		if signature == b'BIFCV1.0':
+			size = unpack_from('<I', raw, 8)[0]
+			blocks = []
+			pos = 12
+			total = 0
+			while total < size:
+				declen, complen = unpack_from('<II', raw, pos)
+				pos += 8
+				blocks.append(zlib.decompress(raw[pos:pos + complen]))
+				pos += complen
+				total += declen
+			return b''.join(blocks)
+		raise ValueError(f"{self.path} is not a BIF archive")
+
+	def read_index(self):
+		self.indexed = True
+		data = self.data()
+		file_count, tile_count, offset = unpack_from('<III', data, 8)
+		for i in range(file_count):
+			locator, data_offset, size = unpack_from('<III', data, offset + 16 * i)
+			self.files.setdefault(locator & 0x3FFF, (data_offset, size))
+		offset += 16 * file_count
+		for i in range(tile_count):
+			locator, data_offset, count, tile_size = unpack_from('<IIII', data, offset + 20 * i)
+			self.tiles.setdefault((locator & 0xFC000) >> 14, (data_offset, count * tile_size))
+
+def find_bif(name, search_paths):
+	for root in search_paths:
+		for candidate in (name, os.path.splitext(name)[0] + '.cbf'):
+			path = resolve_case(root, candidate)
+			if path and os.path.isfile(path):
+				return path
+	return None
+
+def scan_directory(path, index):
+	"""Plain files only, like the engine's directory sources."""
+	for file_name in sorted(os.listdir(path)):
+		file_path = os.path.join(path, file_name)
+		if not os.path.isfile(file_path):
+			continue
+
+		name, ext = os.path.splitext(file_name)
+		ext = ext[1:]
+		try:
+			name = name.encode('ascii')
+			ext.encode('ascii')
+		except UnicodeEncodeError:
+			print(f"Ignoring {file_path} for its non-ASCII name")
+			continue
+		if not ext or len(name) > 8 or len(ext) > 4 or ext.lower() in ARCHIVES:
+			continue
+		index.setdefault(make_key(name, ext), LooseFile(file_path))
+
+def scan_key(key_path, bif_paths, index):
+	with open(key_path, 'rb') as f:
+		data = f.read()
+	if data[:8] != b'KEY V1  ':
+		raise ValueError(f"{key_path} is not a KEY file")
+
+	bif_count, res_count, bif_offset, res_offset = unpack_from('<IIII', data, 8)
+	archives = []
+	for i in range(bif_count):
+		_, name_offset, name_length, _ = unpack_from('<IIHH', data, bif_offset + 12 * i)
+		name = data[name_offset:name_offset + name_length].split(b'\0')[0].decode('ascii').lstrip('\\')
+		path = find_bif(name, bif_paths)
+		if not path:
+			print(f"Cannot find {name}, skipping its resources", file=sys.stderr)
+		archives.append(BIFArchive(path) if path else None)
+
+	seen = set()
+	unknown = 0
+	for i in range(res_count):
+		raw_name, res_type, locator = unpack_from('<8sHI', data, res_offset + 14 * i)
+		name = raw_name.split(b'\0')[0]
+		if not name:
+			continue
+		# the first entry wins, like in KEYImporter
+		if (name.lower(), res_type) in seen:
+			continue
+		seen.add((name.lower(), res_type))
+
+		if res_type not in KEY_TYPES:
+			unknown += 1
+			continue
+		bif = locator >> 20
+		archive = archives[bif] if bif < len(archives) else None
+		if not archive:
+			continue
+		if not archive.indexed:
+			archive.read_index()
+			archive.release()
+
+		if res_type == TIS_TYPE:
+			entry = archive.tiles.get((locator & 0xFC000) >> 14)
+		else:
+			entry = archive.files.get(locator & 0x3FFF)
+		if not entry:
+			continue
+
+		source = BIFFile(archive, entry[0], entry[1])
+		for ext in KEY_TYPES[res_type]:
+			index.setdefault(make_key(name, ext), source)
+
+	if unknown:
+		print(f"Ignored {unknown} resources of unknown types in {key_path}")
+
+def build_hash(keys):
+	"""Minimal perfect hash, returns the bucket displacements and the slot of each key."""
+	count = len(keys)
+	bucket_count = max(2, (count + 2) // 3)
+	bucket_count += bucket_count % 2 # keeps the entries 8 byte aligned
+	buckets = [[] for _ in range(bucket_count)]
+	for i, key in enumerate(keys):
+		buckets[pack_hash(key, 0) % bucket_count].append(i)
+
+	displacements = [0] * bucket_count
+	slots = [None] * count
+	taken = [False] * count
+	singles = []
+	for b in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+		items = buckets[b]
+		if len(items) < 2:
+			if items:
+				singles.append(b)
+			continue
+
+		seed = 1
+		while True:
+			positions = [pack_hash(keys[i], seed) % count for i in items]
+			if len(set(positions)) == len(positions) and not any(taken[p] for p in positions):
+				break
+			seed += 1
+			if seed >= DIRECT_SLOT:
+				raise RuntimeError("Cannot build the hash table")
+		displacements[b] = seed
+		for i, p in zip(items, positions):
+			slots[i] = p
+			taken[p] = True
+
+	# lone keys go straight to the remaining slots
+	free = (p for p in range(count) if not taken[p])
+	for b in singles:
+		p = next(free)
+		displacements[b] = DIRECT_SLOT | p
+		slots[buckets[b][0]] = p
+
+	return displacements, slots
+
+def write_pack(output, index, compress, fingerprints):
+	keys = list(index.keys())
+	displacements, slots = build_hash(keys) if keys else ([0, 0], [])
+
+	bucket_offset = HEADER_SIZE
+	entry_offset = bucket_offset + 4 * len(displacements)
+	data_offset = entry_offset + ENTRY_SIZE * len(keys)
+	entries = [None] * len(keys)
+
+	with open(output, 'wb') as f:
+		f.seek(data_offset)
+
+		# in source order, so reading a BIF's worth of resources stays sequential
+		written = {}
+		archive = None
+		order = sorted(range(len(keys)), key=lambda i: index[keys[i]].order())
+		for i in order:
+			source = index[keys[i]]
+			# only keep one decompressed archive around
+			if isinstance(source, BIFFile) and source.archive is not archive:
+				if archive:
+					archive.release()
+				archive = source.archive
+			if id(source) not in written:
+				data = source.read()
+				flags = 0
+				stored = data
+				ext = keys[i][8:].rstrip(b'\0').decode('ascii')
+				if compress and len(data) > 256 and ext not in INCOMPRESSIBLE:
+					deflated = zlib.compress(data, 9)
+					if len(deflated) < len(data) * 7 // 8:
+						flags = FLAG_DEFLATED
+						stored = deflated
+				written[id(source)] = (flags, f.tell(), len(stored), len(data))
+				f.write(stored)
+			entries[slots[i]] = keys[i] + pack('<IQII', *written[id(source)])
+
+		f.seek(0)
+		f.write(SIGNATURE)
+		f.write(pack('<IIIIII', len(keys), len(displacements), bucket_offset, entry_offset, *fingerprints))
+		f.write(pack(f'<{len(displacements)}I', *displacements))
+		for entry in entries:
+			f.write(entry)
+
+def main():
+	parser = argparse.ArgumentParser(description="Packs a game install into a GemRB content pack.")
+	parser.add_argument('game', help="the game directory, holding chitin.key")
+	parser.add_argument('output', help="the pack to write")
+	parser.add_argument('--cd', action='append', default=[], help="a CD directory, can be given several times")
+	parser.add_argument('--compress', action='store_true', help="deflate resources that shrink enough")
+	args = parser.parse_args()
+
+	key_path = resolve_case(args.game, 'chitin.key')
+	if not key_path:
+		print("The given path does not hold a chitin.key.", file=sys.stderr)
+		return 1
+
+	fingerprints = install_fingerprints(key_path, resolve_case(args.game, 'override'))
+
+	index = {}
+	for directory in GAME_DIRECTORIES:
+		path = resolve_case(args.game, directory)
+		if path and os.path.isdir(path):
+			scan_directory(path, index)
+	for cd in args.cd:
+		path = resolve_case(cd, 'data')
+		if path and os.path.isdir(path):
+			scan_directory(path, index)
+
+	bif_paths = [args.game, resolve_case(args.game, 'data') or args.game] + args.cd
+	scan_key(key_path, bif_paths, index)
+
+	write_pack(args.output, index, args.compress, fingerprints)
+	print(f"Packed {len(index)} resources into {args.output}")
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())